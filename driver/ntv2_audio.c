@@ -32,6 +32,7 @@ static void ntv2_audio_capture_task(unsigned long data);
 static void ntv2_audio_playback_task(unsigned long data);
 static void ntv2_audio_dma_callback(unsigned long data, int result);
 static void ntv2_audio_channel_callback(unsigned long data);
+static enum hrtimer_restart ntv2_audio_period_timer(struct hrtimer *timer);
 
 
 struct ntv2_audio *ntv2_audio_open(struct ntv2_object *ntv2_obj,
@@ -42,7 +43,8 @@ struct ntv2_audio *ntv2_audio_open(struct ntv2_object *ntv2_obj,
 	if (ntv2_obj == NULL)
 		return NULL;
 
-	ntv2_aud = kzalloc(sizeof(struct ntv2_audio), GFP_KERNEL);
+	ntv2_aud = kzalloc_node(sizeof(struct ntv2_audio), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_aud == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_audio instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
@@ -70,6 +72,7 @@ void ntv2_audio_close(struct ntv2_audio *ntv2_aud)
 	/* stop the queues */
 	if (ntv2_aud->capture != NULL) {
 		ntv2_audio_disable(ntv2_aud->capture);
+		hrtimer_cancel(&ntv2_aud->capture->period_timer);
 		tasklet_kill(&ntv2_aud->capture->transfer_task);
 		memset(ntv2_aud->capture, 0, sizeof(struct ntv2_pcm_stream));
 		kfree(ntv2_aud->capture);
@@ -77,6 +80,7 @@ void ntv2_audio_close(struct ntv2_audio *ntv2_aud)
 	}
 	if (ntv2_aud->playback != NULL) {
 		ntv2_audio_disable(ntv2_aud->playback);
+		hrtimer_cancel(&ntv2_aud->playback->period_timer);
 		tasklet_kill(&ntv2_aud->playback->transfer_task);
 		memset(ntv2_aud->playback, 0, sizeof(struct ntv2_pcm_stream));
 		kfree(ntv2_aud->playback);
@@ -142,7 +146,8 @@ int ntv2_audio_configure(struct ntv2_audio *ntv2_aud,
 			ntv2_features_get_default_source_config(features, ntv2_chn->index, true),
 			&ntv2_aud->source_format);
 
-		stream = kzalloc(sizeof(struct ntv2_pcm_stream), GFP_KERNEL);
+		stream = kzalloc_node(sizeof(struct ntv2_pcm_stream), GFP_KERNEL,
+							  ntv2_aud->ntv2_dev->numa_node);
 		if (stream == NULL)
 			return -ENOMEM;
 
@@ -153,6 +158,17 @@ int ntv2_audio_configure(struct ntv2_audio *ntv2_aud,
 		tasklet_init(&stream->transfer_task,
 					 ntv2_audio_capture_task,
 					 (unsigned long)stream);
+#ifdef NTV2_USE_HRTIMER_SETUP
+		hrtimer_setup(&stream->period_timer,
+					  ntv2_audio_period_timer,
+					  CLOCK_MONOTONIC,
+					  HRTIMER_MODE_REL);
+#else
+		hrtimer_init(&stream->period_timer,
+					 CLOCK_MONOTONIC,
+					 HRTIMER_MODE_REL);
+		stream->period_timer.function = ntv2_audio_period_timer;
+#endif
 
 		result = ntv2_pcmops_configure(stream);
 		if (result < 0)
@@ -164,7 +180,8 @@ int ntv2_audio_configure(struct ntv2_audio *ntv2_aud,
 		ntv2_mixops_capture_configure(ntv2_aud);
 	}
 	if (playback) {
-		stream = kzalloc(sizeof(struct ntv2_pcm_stream), GFP_KERNEL);
+		stream = kzalloc_node(sizeof(struct ntv2_pcm_stream), GFP_KERNEL,
+							  ntv2_aud->ntv2_dev->numa_node);
 		if (stream == NULL)
 			return -ENOMEM;
 
@@ -175,6 +192,17 @@ int ntv2_audio_configure(struct ntv2_audio *ntv2_aud,
 		tasklet_init(&stream->transfer_task,
 					 ntv2_audio_playback_task,
 					 (unsigned long)stream);
+#ifdef NTV2_USE_HRTIMER_SETUP
+		hrtimer_setup(&stream->period_timer,
+					  ntv2_audio_period_timer,
+					  CLOCK_MONOTONIC,
+					  HRTIMER_MODE_REL);
+#else
+		hrtimer_init(&stream->period_timer,
+					 CLOCK_MONOTONIC,
+					 HRTIMER_MODE_REL);
+		stream->period_timer.function = ntv2_audio_period_timer;
+#endif
 
 		result = ntv2_pcmops_configure(stream);
 		if (result < 0)
@@ -199,14 +227,14 @@ void ntv2_audio_disable_all(struct ntv2_audio *ntv2_aud)
 }
 
 int ntv2_audio_set_source(struct ntv2_audio *ntv2_aud,
-						  struct ntv2_source_config *config)
+						  const struct ntv2_source_config *config)
 {
 	struct ntv2_source_format org_format;
 	struct ntv2_source_format source_format;
 	struct ntv2_channel_stream* video_stream = NULL;
 	struct ntv2_input_format input_format;
-	struct ntv2_source_config *video_config = NULL;
-	struct ntv2_source_config *aes_config = NULL;
+	const struct ntv2_source_config *video_config = NULL;
+	const struct ntv2_source_config *aes_config = NULL;
 	bool good_source = false;
 	int ret;
 
@@ -284,14 +312,14 @@ int ntv2_audio_set_source(struct ntv2_audio *ntv2_aud,
 	if (!good_source)
 		return -EINVAL;
 
-	NTV2_MSG_AUDIO_STATE("%s: set audio source: %s\n",
-						 ntv2_aud->name, config->name);
-
 	/* ignore if nothing changes */
 	if ((org_format.type == source_format.type) &&
 		(org_format.input_index == source_format.input_index))
 		return 0;
 
+	NTV2_MSG_AUDIO_STATE("%s: set audio source: %s\n",
+						 ntv2_aud->name, config->name);
+
 	/* set the audio source */
 	ntv2_channel_set_source_format(ntv2_aud->capture->chn_str, &source_format);
 
@@ -381,6 +409,9 @@ int ntv2_audio_disable(struct ntv2_pcm_stream *stream)
 	/* disable channel */
 	ntv2_channel_set_frame_callback(stream->chn_str, NULL, 0);
 
+	stream->period_run = false;
+	hrtimer_cancel(&stream->period_timer);
+
 	spin_lock_irqsave(&stream->state_lock, flags);
 	stream->transfer_state = ntv2_task_state_disable;
 	spin_unlock_irqrestore(&stream->state_lock, flags);
@@ -418,6 +449,14 @@ int ntv2_audio_start(struct ntv2_pcm_stream *stream)
 		return result;
 	}
 
+	/* transfer captured audio at period boundaries */
+	if (stream->type == ntv2_stream_type_audin) {
+		stream->period_run = true;
+		hrtimer_start(&stream->period_timer,
+					  ns_to_ktime(ntv2_pcmops_period_wait(stream)),
+					  HRTIMER_MODE_REL);
+	}
+
 	return 0;
 }
 
@@ -428,6 +467,9 @@ int ntv2_audio_stop(struct ntv2_pcm_stream *stream)
 	if (stream == NULL)
 		return -EINVAL;
 
+	stream->period_run = false;
+	hrtimer_try_to_cancel(&stream->period_timer);
+
 	result = ntv2_channel_stop(stream->chn_str);
 	if (result != 0) {
 		return result;
@@ -470,10 +512,12 @@ static void ntv2_audio_capture_task(unsigned long data)
 	
 	if (stream->dma_done) {
 		ntv2_pcmops_copy_audio(stream, 
-							   ((stream->dma_result == 0)? stream->dma_buffer : NULL),
+							   (((stream->dma_result == 0) && !stream->dma_audbuf->audio.silence)?
+								stream->dma_buffer : NULL),
 							   stream->dma_size,
 							   stream->dma_audbuf->audio.num_channels,
-							   stream->dma_audbuf->audio.sample_size);
+							   stream->dma_audbuf->audio.sample_size,
+							   stream->dma_audbuf->timestamp);
 		ntv2_channel_data_done(stream->dma_audbuf);
 		stream->dma_audbuf = NULL;
 		stream->dma_start = false;
@@ -496,7 +540,10 @@ static void ntv2_audio_capture_task(unsigned long data)
 		stream->dma_size =
 			stream->dma_audbuf->audio.data_size[0] +
 			stream->dma_audbuf->audio.data_size[1];
-		if (stream->dma_size <= NTV2_PCM_DMA_BUFFER_SIZE) {
+		if (stream->dma_audbuf->audio.silence) {
+			/* nothing to transfer */
+			ntv2_audio_dma_callback((unsigned long)stream, 0);
+		} else if (stream->dma_size <= NTV2_PCM_DMA_BUFFER_SIZE) {
 			trn.mode = ntv2_transfer_mode_c2s;
 			trn.sg_list = stream->dma_sgtable.sgl;
 			trn.sg_pages = stream->dma_buffer_pages;
@@ -505,8 +552,12 @@ static void ntv2_audio_capture_task(unsigned long data)
 			trn.card_address[1] = stream->dma_audbuf->audio.address[1];
 			trn.card_size[0] = stream->dma_audbuf->audio.data_size[0];
 			trn.card_size[1] = stream->dma_audbuf->audio.data_size[1];
+			trn.card_pitch = 0;
+			trn.card_segment = 0;
+			trn.system_pitch = 0;
 			trn.callback_func = ntv2_audio_dma_callback;
 			trn.callback_data = (unsigned long)stream;
+			trn.priority = true;
 			result = ntv2_pci_transfer(ntv2_aud->ntv2_pci, &trn);
 			if (result != 0) {
 				stream->dma_done = true;
@@ -547,10 +598,21 @@ static void ntv2_audio_dma_callback(unsigned long data, int result)
 static void ntv2_audio_channel_callback(unsigned long data)
 {
 	struct ntv2_pcm_stream *stream = (struct ntv2_pcm_stream *)data;
+	struct ntv2_audio *ntv2_aud;
 
 	if (stream == NULL)
 		return;
 
+	/* follow audio availability when the source is auto */
+	ntv2_aud = stream->ntv2_aud;
+	if ((stream->type == ntv2_stream_type_audin) &&
+		(ntv2_aud->source_format.type == ntv2_input_type_auto)) {
+		ntv2_audio_set_source(ntv2_aud,
+							  ntv2_features_get_source_config(ntv2_aud->features,
+															  ntv2_aud->ntv2_chn->index,
+															  ntv2_aud->snd_input));
+	}
+
 	/* timestamp the audio capture start */
 	if (stream->trigger) {
 		ntv2_pcmops_tstamp(stream);
@@ -560,3 +622,21 @@ static void ntv2_audio_channel_callback(unsigned long data)
 	/* schedule the dma task */
 	tasklet_schedule(&stream->transfer_task);
 }
+
+static enum hrtimer_restart ntv2_audio_period_timer(struct hrtimer *timer)
+{
+	struct ntv2_pcm_stream *stream = container_of(timer, struct ntv2_pcm_stream, period_timer);
+
+	if (!stream->period_run)
+		return HRTIMER_NORESTART;
+
+	/* queue the audio captured since the last transfer */
+	ntv2_channel_update_position(stream->chn_str);
+
+	/* schedule the dma task */
+	tasklet_schedule(&stream->transfer_task);
+
+	hrtimer_forward_now(timer, ns_to_ktime(ntv2_pcmops_period_wait(stream)));
+
+	return HRTIMER_RESTART;
+}
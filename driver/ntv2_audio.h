@@ -23,6 +23,8 @@
 #include "ntv2_common.h"
 
 #define NTV2_PCM_DMA_BUFFER_SIZE		4800*16*4
+#define NTV2_PCM_PERIOD_WAIT_MIN		1000000
+#define NTV2_PCM_PERIOD_WAIT_LATENCY	1500000
 
 struct ntv2_audio;
 struct ntv2_features;
@@ -43,6 +45,11 @@ struct ntv2_pcm_stream {
 	u32							period_ptr;
 	u32							sample_cycle;
 	bool						trigger;
+	u64							tstamp_frames;
+	v4l2_time_t					tstamp_time;
+
+	struct hrtimer				period_timer;
+	bool						period_run;
 
 	struct ntv2_stream_data		*dma_audbuf;
 	bool						dma_start;
@@ -92,7 +99,7 @@ int ntv2_audio_configure(struct ntv2_audio *ntv2_aud,
 						 struct ntv2_pci *ntv2_pci);
 
 int ntv2_audio_set_source(struct ntv2_audio *ntv2_aud,
-						  struct ntv2_source_config *config);
+						  const struct ntv2_source_config *config);
 
 struct ntv2_pcm_stream *ntv2_audio_capture_stream(struct ntv2_audio *ntv2_aud);
 struct ntv2_pcm_stream *ntv2_audio_playback_stream(struct ntv2_audio *ntv2_aud);
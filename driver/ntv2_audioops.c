@@ -25,11 +25,153 @@
 
 #include "ntv2_features.h"
 
+/* audio rate tracking (ratio of measured to nominal rate in 8.24 fixed point) */
+#define NTV2_AUDIO_SYNC_SHIFT			24
+#define NTV2_AUDIO_SYNC_UNITY			(1 << NTV2_AUDIO_SYNC_SHIFT)
+#define NTV2_AUDIO_SYNC_RANGE			(NTV2_AUDIO_SYNC_UNITY / 200)
+#define NTV2_AUDIO_SYNC_PHASE_GAIN		8
+#define NTV2_AUDIO_SYNC_RATE_GAIN		64
+
+static void ntv2_audioops_sync_reset(struct ntv2_channel_stream *stream)
+{
+	stream->audio.sync_ratio = NTV2_AUDIO_SYNC_UNITY;
+	stream->audio.sync_fraction = 0;
+	stream->audio.sync_rate = stream->audio.sample_rate * 1000;
+}
+
+static u32 ntv2_audioops_capture_offset(struct ntv2_channel_stream *stream, u32 hw_offset)
+{
+	u32 audio_stride = stream->audio.num_channels * stream->audio.sample_size;
+	u32 ring_size = stream->audio.ring_size;
+	u32 audio_offset;
+
+	/* align the hardware audio offset */
+	audio_offset = hw_offset / audio_stride * audio_stride;
+
+	/* offset the hardware audio offset for frame buffer latency */
+	return (audio_offset + ring_size - stream->audio.ring_init)%ring_size;
+}
+
+static void ntv2_audioops_offset_time(struct ntv2_channel_stream *stream,
+									  u32 offset,
+									  v4l2_time_t *time)
+{
+#ifdef NTV2_USE_VB2_BUFFER_TIMESTAMP
+	u32 audio_stride = stream->audio.num_channels * stream->audio.sample_size;
+	u32 ring_size = stream->audio.ring_size;
+	s64 samples;
+
+	/* time of the sample at offset relative to the last interrupt sample */
+	samples = (s64)((offset + ring_size - stream->audio.sync_time_offset)%ring_size / audio_stride);
+	if (samples > (s64)(ring_size / audio_stride / 2))
+		samples -= (s64)(ring_size / audio_stride);
+
+	*time = stream->audio.sync_time +
+		div_s64(samples * NSEC_PER_SEC * 1000, max_t(u32, stream->audio.sync_rate, 1));
+#else
+	*time = stream->audio.sync_time;
+#endif
+}
+
+static void ntv2_audioops_queue_capture(struct ntv2_channel_stream *stream,
+										u32 start_offset,
+										u32 end_offset)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	struct ntv2_stream_data *data_ready;
+	u32 audio_stride = stream->audio.num_channels * stream->audio.sample_size;
+	u32 ring_size = stream->audio.ring_size;
+	u32 audio_size;
+	u32 audio_samples;
+
+	audio_size = (end_offset + ring_size - start_offset)%ring_size;
+	audio_samples = audio_size / audio_stride;
+	if (audio_samples == 0)
+		return;
+
+	if (list_empty(&stream->data_done_list)) {
+		stream->audio.total_drop_count += audio_samples;
+		stream->audio.stat_drop_count += audio_samples;
+		return;
+	}
+
+	/* get next data object */
+	data_ready = list_first_entry(&stream->data_done_list,
+								  struct ntv2_stream_data, list);
+	list_del_init(&data_ready->list);
+
+	/* add audio data to queue */
+	data_ready->audio.offset = start_offset;
+	data_ready->audio.address[0] = stream->audio.ring_address + start_offset;
+	data_ready->audio.address[1] = stream->audio.ring_address;
+	if ((start_offset + audio_size) > ring_size) {
+		data_ready->audio.data_size[0] = ring_size - start_offset;
+		data_ready->audio.data_size[1] = audio_size - data_ready->audio.data_size[0];
+	} else {
+		data_ready->audio.data_size[0] = audio_size;
+		data_ready->audio.data_size[1] = 0;
+	}
+	data_ready->audio.num_channels = stream->audio.num_channels;
+	data_ready->audio.sample_size = stream->audio.sample_size;
+	data_ready->audio.silence = false;
+	ntv2_audioops_offset_time(stream, end_offset, &data_ready->timestamp);
+
+	list_add_tail(&data_ready->list, &stream->data_ready_list);
+	NTV2_MSG_CHANNEL_STREAM("%s: audio capture data queue %d  size %d\n",
+							ntv2_chn->name,
+							data_ready->index,
+							audio_size);
+
+	stream->audio.total_transfer_count += audio_samples;
+}
+
+static void ntv2_audioops_queue_silence(struct ntv2_channel_stream *stream,
+										u32 audio_samples,
+										u32 end_offset)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	struct ntv2_stream_data *data_ready;
+	u32 audio_stride = stream->audio.num_channels * stream->audio.sample_size;
+
+	if (audio_samples == 0)
+		return;
+
+	if (list_empty(&stream->data_done_list)) {
+		stream->audio.total_drop_count += audio_samples;
+		stream->audio.stat_drop_count += audio_samples;
+		return;
+	}
+
+	/* get next data object */
+	data_ready = list_first_entry(&stream->data_done_list,
+								  struct ntv2_stream_data, list);
+	list_del_init(&data_ready->list);
+
+	/* add silence to queue (no dma) */
+	data_ready->audio.offset = end_offset;
+	data_ready->audio.address[0] = 0;
+	data_ready->audio.address[1] = 0;
+	data_ready->audio.data_size[0] = audio_samples * audio_stride;
+	data_ready->audio.data_size[1] = 0;
+	data_ready->audio.num_channels = stream->audio.num_channels;
+	data_ready->audio.sample_size = stream->audio.sample_size;
+	data_ready->audio.silence = true;
+	ntv2_audioops_offset_time(stream, end_offset, &data_ready->timestamp);
+
+	list_add_tail(&data_ready->list, &stream->data_ready_list);
+	NTV2_MSG_CHANNEL_STREAM("%s: audio capture silence queue %d  samples %d\n",
+							ntv2_chn->name,
+							data_ready->index,
+							audio_samples);
+
+	stream->audio.total_transfer_count += audio_samples;
+}
+
 int ntv2_audioops_setup_capture(struct ntv2_channel_stream *stream)
 {
 	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
 	struct ntv2_features *features = ntv2_chn->features;
-	struct ntv2_audio_config *audio_config;
+	const struct ntv2_audio_config *audio_config;
 	int index = ntv2_chn->index;
 	u32 val;
 	u32 mask;
@@ -46,6 +188,7 @@ int ntv2_audioops_setup_capture(struct ntv2_channel_stream *stream)
 	stream->audio.num_channels = audio_config->num_channels;
 	stream->audio.sample_size = audio_config->sample_size;
 	stream->audio.audio_offset = 0;
+	stream->audio.transfer_offset = 0;
 	stream->audio.ring_address = ntv2_features_get_audio_capture_address(features, ntv2_chn->index);
 	stream->audio.ring_offset = audio_config->ring_size;
 	stream->audio.ring_size = audio_config->ring_size;
@@ -55,11 +198,13 @@ int ntv2_audioops_setup_capture(struct ntv2_channel_stream *stream)
 		audio_config->sample_size;
 	stream->audio.sync_cadence = 0;
 	stream->audio.sync_tolerance = audio_config->sync_tolerance;
+	ntv2_audioops_sync_reset(stream);
 	stream->audio.total_sample_count = 0;
 	stream->audio.total_drop_count = 0;
 	stream->audio.stat_sample_count = 0;
 	stream->audio.stat_drop_count = 0;
 	stream->audio.hardware_enable = false;
+	stream->audio.source_update = false;
 
 	/* initialize audio data buffers */
 	for (i = 0; i < NTV2_MAX_CHANNEL_BUFFERS; i++) {
@@ -124,7 +269,7 @@ int ntv2_audioops_update_route(struct ntv2_channel_stream *stream)
 {
 	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
 	struct ntv2_channel_stream *video_stream = NULL;
-	struct ntv2_source_config *source_config = NULL;
+	const struct ntv2_source_config *source_config = NULL;
 	struct ntv2_source_format source_format;
 	struct ntv2_features *features = ntv2_chn->features;
 	int index = ntv2_chn->index;
@@ -210,7 +355,6 @@ int ntv2_audioops_interrupt_capture(struct ntv2_channel_stream *stream)
 {
 	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
 	struct ntv2_channel_stream *video_stream = ntv2_chn->streams[ntv2_stream_type_vidin];
-	struct ntv2_stream_data *data_ready;
 	int index = ntv2_chn->index;
 	s64 stat_time = ntv2_chn->dpc_status.stat_time;
 	s64 time_us;
@@ -218,11 +362,13 @@ int ntv2_audioops_interrupt_capture(struct ntv2_channel_stream *stream)
 	u32 audio_stride;
 	u32 audio_offset;
 	u32 ring_offset;
-	u32 audio_delta_ring;
-	u32 audio_delta_offset;
-	u32 audio_delta = 0;
 	u32 audio_samples;
 	u32 audio_size;
+	u32 captured_samples;
+	u64 sync_size;
+	s32 sync_error = 0;
+	s32 sync_error_us;
+	s32 sync_ratio;
 	u32 ring_size = stream->audio.ring_size;
 	u32 val;
 	u32 mask;
@@ -273,60 +419,102 @@ int ntv2_audioops_interrupt_capture(struct ntv2_channel_stream *stream)
 		}
 	}
 
+	/* switch audio source on the frame boundary */
+	if (stream->audio.source_update) {
+		stream->audio.source_update = false;
+		ntv2_audioops_update_route(stream);
+	}
+
 	/* get dynamic stream time and audio position */
 	stream->timestamp = ntv2_chn->dpc_status.interrupt_time;
-	audio_offset = ntv2_chn->dpc_status.audio_input_offset;
-
-	/* align the current hardware audio offset */
 	audio_stride = stream->audio.num_channels * stream->audio.sample_size;
-	audio_offset = audio_offset / audio_stride * audio_stride;
+	audio_offset = ntv2_audioops_capture_offset(stream, ntv2_chn->dpc_status.audio_input_offset);
 
-	/* offset the current hardware audio offset for frame buffer latency */
-	audio_offset = (audio_offset + ring_size - stream->audio.ring_init)%ring_size;
+	/* the sample at the interrupt offset aligns with the interrupt time */
+	stream->audio.sync_time = stream->timestamp;
+	stream->audio.sync_time_offset = audio_offset;
 
-	/* compute expected sample bytes from last interrupt */
+	/* compute nominal samples from last interrupt */
 	audio_samples = ntv2_audio_frame_samples(ntv2_chn->dpc_status.interrupt_rate, stream->audio.sync_cadence++);
-	audio_size = audio_samples * audio_stride;
 
-	if (stream->queue_last) {
-		prev_audio_offset = stream->audio.audio_offset;
-		/* update computed ring offset */
+	if (stream->queue_last && (stream->audio.ring_offset < ring_size)) {
+		prev_audio_offset = stream->audio.transfer_offset;
+		/* advance the tracked ring offset by the measured rate */
+		sync_size = (u64)audio_samples * stream->audio.sync_ratio + stream->audio.sync_fraction;
+		stream->audio.sync_fraction = (u32)(sync_size & (NTV2_AUDIO_SYNC_UNITY - 1));
+		audio_samples = (u32)(sync_size >> NTV2_AUDIO_SYNC_SHIFT);
+		audio_size = audio_samples * audio_stride;
 		ring_offset = (stream->audio.ring_offset + audio_size)%ring_size;
-		/* check audio sync with hardware */
-		audio_delta_ring = (ring_offset + ring_size - audio_offset)%ring_size;
-		audio_delta_offset = (audio_offset + ring_size - ring_offset)%ring_size;
-		audio_delta = min(audio_delta_ring, audio_delta_offset);
-		audio_delta = (audio_delta / audio_stride) * 10000 / stream->audio.sample_rate;
-		if (audio_delta > (stream->audio.sync_tolerance/100)) {
-			NTV2_MSG_CHANNEL_STATE("%s: %s correcting audio sync  exp %08x  act %08x  error %d us\n",
+		/* signed error between hardware and tracked offset */
+		sync_error = (s32)((audio_offset + ring_size - ring_offset)%ring_size / audio_stride);
+		if (sync_error > (s32)(ring_size / audio_stride / 2))
+			sync_error -= (s32)(ring_size / audio_stride);
+		sync_error_us = (s32)div_s64((s64)sync_error * 1000000, stream->audio.sample_rate);
+		if (abs(sync_error_us) > stream->audio.sync_tolerance) {
+			/* discontinuity, resync to the hardware offset */
+			NTV2_MSG_CHANNEL_STATE("%s: %s audio sync discontinuity  exp %08x  act %08x  error %d us\n",
 								   ntv2_chn->name,
 								   ntv2_stream_name(ntv2_stream_type_audin),
 								   ring_offset,
 								   audio_offset,
-								   audio_delta * 100);
-			/* correct number of samples transfered */
-			audio_size += (s32)(stream->audio.total_sample_count - stream->audio.total_transfer_count) * (s32)audio_stride;
+								   sync_error_us);
 			/* limit in case of unexpected results */
-			if (audio_size > ring_size/4)
-				audio_size = audio_samples * audio_stride;
-			/* move the ring position to the hardware audio offset */
-			prev_audio_offset = (audio_offset + ring_size - audio_size)%ring_size;
+			if (((audio_offset + ring_size - prev_audio_offset)%ring_size) > ring_size/4)
+				prev_audio_offset = (audio_offset + ring_size - audio_size)%ring_size;
 			ring_offset = audio_offset;
+			stream->audio.sync_fraction = 0;
+		} else if (audio_samples != 0) {
+			/* pull the tracked offset toward the hardware */
+			ring_offset = (ring_offset + ring_size +
+						   sync_error / NTV2_AUDIO_SYNC_PHASE_GAIN * (s32)audio_stride)%ring_size;
+			/* and trim the rate estimate */
+			sync_ratio = (s32)stream->audio.sync_ratio +
+				(s32)div_s64((s64)sync_error * NTV2_AUDIO_SYNC_UNITY,
+							 (s64)audio_samples * NTV2_AUDIO_SYNC_RATE_GAIN);
+			sync_ratio = clamp(sync_ratio,
+							   NTV2_AUDIO_SYNC_UNITY - NTV2_AUDIO_SYNC_RANGE,
+							   NTV2_AUDIO_SYNC_UNITY + NTV2_AUDIO_SYNC_RANGE);
+			stream->audio.sync_ratio = (u32)sync_ratio;
+			stream->audio.sync_rate =
+				(u32)(((u64)stream->audio.sample_rate * 1000 * stream->audio.sync_ratio) >> NTV2_AUDIO_SYNC_SHIFT);
 		}
 		/* save for stats */
 		stream->audio.total_sample_count += audio_samples;
 		stream->audio.stat_sample_count += audio_samples;
 	} else {
-		/* set offset on start */
+		/* set offset on start or forced resync */
 		prev_audio_offset = audio_offset;
 		ring_offset = audio_offset;
-		/* initialize stats */
-		stream->audio.total_sample_count = 0;
-		stream->audio.total_transfer_count = 0;
-		stream->audio.total_drop_count = 0;
-		stream->audio.stat_sample_count = 0;
-		stream->audio.stat_drop_count = 0;
-		stream->audio.last_display_time = stat_time;
+		stream->audio.sync_fraction = 0;
+		if (stream->queue_last) {
+			/* source switch, keep the samples captured up to the switch */
+			prev_audio_offset = stream->audio.transfer_offset;
+			audio_size = (audio_offset + ring_size - prev_audio_offset)%ring_size;
+			/* limit in case of unexpected results */
+			if (audio_size > ring_size/4) {
+				audio_size = audio_samples * audio_stride;
+				prev_audio_offset = (audio_offset + ring_size - audio_size)%ring_size;
+			}
+			captured_samples = audio_size / audio_stride;
+			/* only the part of the frame the ring did not capture is silent */
+			if (captured_samples < audio_samples) {
+				if (stream->queue_run && (stream->audio.total_sample_count != 0))
+					ntv2_audioops_queue_silence(stream, audio_samples - captured_samples,
+												prev_audio_offset);
+				captured_samples = audio_samples;
+			}
+			stream->audio.total_sample_count += captured_samples;
+			stream->audio.stat_sample_count += captured_samples;
+		} else {
+			/* initialize stats */
+			ntv2_audioops_sync_reset(stream);
+			stream->audio.total_sample_count = 0;
+			stream->audio.total_transfer_count = 0;
+			stream->audio.total_drop_count = 0;
+			stream->audio.stat_sample_count = 0;
+			stream->audio.stat_drop_count = 0;
+			stream->audio.last_display_time = stat_time;
+		}
 	}
 
 	/* save current audio offset */
@@ -340,45 +528,13 @@ int ntv2_audioops_interrupt_capture(struct ntv2_channel_stream *stream)
 						   audio_offset,
 						   ring_offset,
 						   audio_samples,
-						   audio_delta);
+						   sync_error);
 #endif								   
 								   
-	/* add frame to queue */
-	if (stream->queue_run && (stream->audio.total_sample_count != 0)) {
-		audio_size = (audio_offset + ring_size - prev_audio_offset)%ring_size;
-		audio_samples = audio_size / audio_stride;
-
-		if (!list_empty(&stream->data_done_list)) {
-			/* get next data object */
-			data_ready = list_first_entry(&stream->data_done_list,
-										  struct ntv2_stream_data, list);
-			list_del_init(&data_ready->list);
-			/* add audio data to queue */
-			data_ready->audio.offset = prev_audio_offset;
-			data_ready->audio.address[0] = stream->audio.ring_address + prev_audio_offset;
-			data_ready->audio.address[1] = stream->audio.ring_address;
-			if ((prev_audio_offset + audio_size) > ring_size) {
-				data_ready->audio.data_size[0] = ring_size - prev_audio_offset;
-				data_ready->audio.data_size[1] = audio_size - data_ready->audio.data_size[0];
-			} else {
-				data_ready->audio.data_size[0] = audio_size;
-				data_ready->audio.data_size[1] = 0;
-			}
-			data_ready->audio.num_channels = stream->audio.num_channels;
-			data_ready->audio.sample_size = stream->audio.sample_size;
-
-			list_add_tail(&data_ready->list, &stream->data_ready_list);
-			NTV2_MSG_CHANNEL_STREAM("%s: audio capture data queue %d  size %d\n",
-									ntv2_chn->name,
-									data_ready->index,
-									audio_size);
-
-			stream->audio.total_transfer_count += audio_samples;
-		} else {
-			stream->video.total_drop_count += audio_samples;
-			stream->video.stat_drop_count += audio_samples;
-		}
-	}
+	/* add remainder of frame to queue */
+	if (stream->queue_run && (stream->audio.total_sample_count != 0))
+		ntv2_audioops_queue_capture(stream, prev_audio_offset, audio_offset);
+	stream->audio.transfer_offset = audio_offset;
 
 	/* cache last enable state */
 	stream->queue_last = stream->queue_run;
@@ -388,11 +544,13 @@ int ntv2_audioops_interrupt_capture(struct ntv2_channel_stream *stream)
 		time_us = stat_time - stream->audio.last_display_time;
 		if (time_us > NTV2_CHANNEL_STATISTIC_INTERVAL)
 		{
-			NTV2_MSG_CHANNEL_STATISTICS("%s: audio samples %4d  drops %4d  time %6d (us)   total samples %lld  transfers %lld  drops %lld\n",
+			NTV2_MSG_CHANNEL_STATISTICS("%s: audio samples %4d  drops %4d  time %6d (us)  rate %d.%03d   total samples %lld  transfers %lld  drops %lld\n",
 										ntv2_chn->name,
 										(u32)(stream->audio.stat_sample_count),
 										(u32)(stream->audio.stat_drop_count),
 										(u32)(time_us / stream->audio.stat_sample_count),
+										stream->audio.sync_rate / 1000,
+										stream->audio.sync_rate % 1000,
 										stream->audio.total_sample_count,
 										stream->audio.total_transfer_count,
 										stream->audio.total_drop_count);
@@ -405,3 +563,32 @@ int ntv2_audioops_interrupt_capture(struct ntv2_channel_stream *stream)
 
 	return 0;
 }
+
+int ntv2_audioops_update_capture_position(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	u32 ring_size = stream->audio.ring_size;
+	u32 audio_offset;
+	u32 audio_size;
+
+	/* only queue between interrupts of a synchronized running stream */
+	if (!stream->queue_enable ||
+		!stream->queue_run ||
+		!stream->queue_last ||
+		(stream->audio.ring_offset >= ring_size) ||
+		(stream->audio.total_sample_count == 0))
+		return 0;
+
+	audio_offset = ntv2_reg_read(ntv2_chn->vid_reg, ntv2_kona_reg_audio_input_address, ntv2_chn->index);
+	audio_offset = ntv2_audioops_capture_offset(stream, audio_offset);
+
+	/* leave unexpected positions for the interrupt to resolve */
+	audio_size = (audio_offset + ring_size - stream->audio.transfer_offset)%ring_size;
+	if ((audio_size == 0) || (audio_size > ring_size/4))
+		return 0;
+
+	ntv2_audioops_queue_capture(stream, stream->audio.transfer_offset, audio_offset);
+	stream->audio.transfer_offset = audio_offset;
+
+	return 0;
+}
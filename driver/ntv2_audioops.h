@@ -28,5 +28,6 @@ int ntv2_audioops_setup_capture(struct ntv2_channel_stream *stream);
 int ntv2_audioops_update_mode(struct ntv2_channel_stream *stream);
 int ntv2_audioops_update_route(struct ntv2_channel_stream *stream);
 int ntv2_audioops_interrupt_capture(struct ntv2_channel_stream *stream);
+int ntv2_audioops_update_capture_position(struct ntv2_channel_stream *stream);
 
 #endif
@@ -26,15 +26,26 @@
 
 
 static int ntv2_streamops_nop(struct ntv2_channel_stream *stream);
+static int ntv2_streamops_busy(struct ntv2_channel_stream *stream);
 static void ntv2_streamops_initialize(struct ntv2_stream_ops *ops);
 static void ntv2_channel_dpc(unsigned long data);
+#ifdef NTV2_USE_VB2_BUFFER_TIMESTAMP
+static void ntv2_channel_frame_clock(struct ntv2_channel *ntv2_chn);
+#endif
+static void ntv2_channel_reader_interval(struct ntv2_channel_stream *stream);
+static void ntv2_channel_reader_release(struct ntv2_channel_stream *stream,
+										int reader, bool taken);
+static void ntv2_channel_reader_complete(struct ntv2_channel_stream *stream,
+										 struct ntv2_stream_data *data,
+										 int reader);
 
 struct ntv2_channel *ntv2_channel_open(struct ntv2_object *ntv2_obj,
 									   const char *name, int index)
 {
 	struct ntv2_channel *ntv2_chn = NULL;
 
-	ntv2_chn = kzalloc(sizeof(struct ntv2_channel), GFP_KERNEL);
+	ntv2_chn = kzalloc_node(sizeof(struct ntv2_channel), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_chn == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_channel instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
@@ -84,6 +95,8 @@ int ntv2_channel_configure(struct ntv2_channel *ntv2_chn,
 						   struct ntv2_register *vid_reg)
 {
 	struct ntv2_channel_stream *stream;
+	int i;
+
 	if ((ntv2_chn == NULL) ||
 		(features == NULL) ||
 		(vid_reg == NULL))
@@ -94,7 +107,8 @@ int ntv2_channel_configure(struct ntv2_channel *ntv2_chn,
 	ntv2_chn->features = features;
 	ntv2_chn->vid_reg = vid_reg;
 
-	stream = kzalloc(sizeof(struct ntv2_channel_stream), GFP_KERNEL);
+	stream = kzalloc_node(sizeof(struct ntv2_channel_stream), GFP_KERNEL,
+						  ntv2_chn->ntv2_dev->numa_node);
 	if (stream == NULL)
 		return -ENOMEM;
 
@@ -102,6 +116,11 @@ int ntv2_channel_configure(struct ntv2_channel *ntv2_chn,
 	stream->type = ntv2_stream_type_vidin;
 	stream->ntv2_chn = ntv2_chn;
 	stream->capture = true;
+	mutex_init(&stream->reader_mutex);
+	for (i = 0; i < NTV2_MAX_STREAM_READERS; i++)
+		stream->readers[i].interval = 1;
+	stream->video.frame_interval = 1;
+	stream->video.anc_index = -1;
 	ntv2_streamops_initialize(&stream->ops);
 	stream->ops.setup = ntv2_videoops_setup_capture;
 	stream->ops.release = ntv2_videoops_release_capture;
@@ -110,6 +129,7 @@ int ntv2_channel_configure(struct ntv2_channel *ntv2_chn,
 	stream->ops.update_format = ntv2_videoops_update_format;
 	stream->ops.update_route = ntv2_videoops_update_route;
 	stream->ops.interrupt = ntv2_videoops_interrupt_capture;
+	stream->ops.reconfigure = ntv2_videoops_reconfigure_capture;
 	stream->video.video_format = *ntv2_features_get_default_video_format(features, ntv2_chn->index);
 	stream->video.pixel_format = *ntv2_features_get_default_pixel_format(features, ntv2_chn->index);
 	ntv2_features_gen_input_format(ntv2_features_get_default_input_config(features, ntv2_chn->index),
@@ -126,7 +146,39 @@ int ntv2_channel_configure(struct ntv2_channel *ntv2_chn,
 	stream->ops.update_route(stream);
 	stream->ops.release(stream);
 
-	stream = kzalloc(sizeof(struct ntv2_channel_stream), GFP_KERNEL);
+	stream = kzalloc_node(sizeof(struct ntv2_channel_stream), GFP_KERNEL,
+						  ntv2_chn->ntv2_dev->numa_node);
+	if (stream == NULL)
+		return -ENOMEM;
+
+	/* configure the video output stream */
+	stream->type = ntv2_stream_type_vidout;
+	stream->ntv2_chn = ntv2_chn;
+	stream->capture = false;
+	mutex_init(&stream->reader_mutex);
+	for (i = 0; i < NTV2_MAX_STREAM_READERS; i++)
+		stream->readers[i].interval = 1;
+	stream->video.frame_interval = 1;
+	ntv2_streamops_initialize(&stream->ops);
+	stream->ops.setup = ntv2_videoops_setup_playback;
+	stream->ops.release = ntv2_videoops_release_playback;
+	stream->ops.update_mode = ntv2_videoops_update_mode_playback;
+	stream->ops.update_timing = ntv2_videoops_update_timing;
+	stream->ops.update_format = ntv2_videoops_update_format;
+	stream->ops.update_route = ntv2_videoops_update_route_playback;
+	stream->ops.interrupt = ntv2_videoops_interrupt_playback;
+	stream->video.video_format = *ntv2_features_get_default_video_format(features, ntv2_chn->index);
+	stream->video.pixel_format = *ntv2_features_get_default_pixel_format(features, ntv2_chn->index);
+	ntv2_features_gen_input_format(ntv2_features_get_default_input_config(features, ntv2_chn->index),
+								   &stream->video.video_format,
+								   &stream->video.pixel_format,
+								   &stream->video.input_format);
+	ntv2_chn->streams[ntv2_stream_type_vidout] = stream;
+
+	/* the frame store stays in capture idle until playback is enabled */
+
+	stream = kzalloc_node(sizeof(struct ntv2_channel_stream), GFP_KERNEL,
+						  ntv2_chn->ntv2_dev->numa_node);
 	if (stream == NULL)
 		return -ENOMEM;
 
@@ -134,11 +186,13 @@ int ntv2_channel_configure(struct ntv2_channel *ntv2_chn,
 	stream->type = ntv2_stream_type_audin;
 	stream->ntv2_chn = ntv2_chn;
 	stream->capture = true;
+	mutex_init(&stream->reader_mutex);
 	ntv2_streamops_initialize(&stream->ops);
 	stream->ops.setup = ntv2_audioops_setup_capture;
 	stream->ops.update_mode = ntv2_audioops_update_mode;
 	stream->ops.update_route = ntv2_audioops_update_route;
 	stream->ops.interrupt = ntv2_audioops_interrupt_capture;
+	stream->ops.update_position = ntv2_audioops_update_capture_position;
 	ntv2_features_gen_source_format(
 		ntv2_features_get_default_source_config(features, ntv2_chn->index, true),
 		&stream->audio.source_format);
@@ -182,7 +236,7 @@ struct ntv2_channel_stream *ntv2_channel_stream(struct ntv2_channel *ntv2_chn,
 }
 
 int ntv2_channel_set_video_format(struct ntv2_channel_stream *stream,
-								  struct ntv2_video_format *vidf)
+								  const struct ntv2_video_format *vidf)
 {
 	unsigned long flags;
 
@@ -212,7 +266,7 @@ int ntv2_channel_get_video_format(struct ntv2_channel_stream *stream,
 }
 
 int ntv2_channel_set_pixel_format(struct ntv2_channel_stream *stream,
-								  struct ntv2_pixel_format *pixf)
+								  const struct ntv2_pixel_format *pixf)
 {
 	unsigned long flags;
 
@@ -280,6 +334,12 @@ int ntv2_channel_set_source_format(struct ntv2_channel_stream *stream,
 		return -EPERM;
 
 	spin_lock_irqsave(&stream->ntv2_chn->state_lock, flags);
+	/* reroute a running stream on the next frame when the source changes */
+	if (stream->queue_enable &&
+		((stream->audio.source_format.type != souf->type) ||
+		 (stream->audio.source_format.audio_source != souf->audio_source) ||
+		 (stream->audio.source_format.input_index != souf->input_index)))
+		stream->audio.source_update = true;
 	stream->audio.source_format = *souf;
 	spin_unlock_irqrestore(&stream->ntv2_chn->state_lock, flags);
 
@@ -301,6 +361,21 @@ int ntv2_channel_get_source_format(struct ntv2_channel_stream *stream,
 	return 0;
 }
 
+int ntv2_channel_get_audio_rate(struct ntv2_channel_stream *stream,
+								u32 *rate)
+{
+	unsigned long flags;
+
+	if ((stream == NULL) || (rate == NULL))
+		return -EPERM;
+
+	spin_lock_irqsave(&stream->ntv2_chn->state_lock, flags);
+	*rate = stream->audio.sync_rate;
+	spin_unlock_irqrestore(&stream->ntv2_chn->state_lock, flags);
+
+	return 0;
+}
+
 int ntv2_channel_set_frame_callback(struct ntv2_channel_stream *stream,
 									ntv2_channel_callback func,
 									unsigned long data)
@@ -507,6 +582,114 @@ int ntv2_channel_flush(struct ntv2_channel_stream *stream)
 	return 0;
 }
 
+int ntv2_channel_update_position(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn;
+	unsigned long flags;
+	int result = 0;
+
+	if (stream == NULL)
+		return -EPERM;
+
+	ntv2_chn = stream->ntv2_chn;
+
+	/* queue data captured since the last interrupt */
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+	if ((ntv2_chn->state == ntv2_channel_state_run) && stream->queue_enable)
+		result = stream->ops.update_position(stream);
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+
+	return result;
+}
+
+int ntv2_channel_reconfigure(struct ntv2_channel_stream *stream,
+							 struct ntv2_input_format *inpf,
+							 const struct ntv2_video_format *vidf,
+							 const struct ntv2_pixel_format *pixf)
+{
+	struct ntv2_channel *ntv2_chn;
+	struct ntv2_input_format old_inpf;
+	struct ntv2_video_format old_vidf;
+	struct ntv2_pixel_format old_pixf;
+	struct ntv2_stream_data *data;
+	struct ntv2_stream_data *next;
+	unsigned long flags;
+	int result;
+
+	if ((stream == NULL) ||
+		(inpf == NULL) ||
+		(vidf == NULL) ||
+		(pixf == NULL))
+		return -EPERM;
+
+	ntv2_chn = stream->ntv2_chn;
+
+	/* swap the stream state under the lock, reprogram the hardware outside it */
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+
+	if (!stream->queue_enable) {
+		stream->video.input_format = *inpf;
+		stream->video.video_format = *vidf;
+		stream->video.pixel_format = *pixf;
+		spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+		return 0;
+	}
+
+	NTV2_MSG_CHANNEL_STATE("%s: %s reconfigure\n",
+						   ntv2_chn->name, ntv2_stream_name(stream->type));
+
+	old_inpf = stream->video.input_format;
+	old_vidf = stream->video.video_format;
+	old_pixf = stream->video.pixel_format;
+	stream->video.input_format = *inpf;
+	stream->video.video_format = *vidf;
+	stream->video.pixel_format = *pixf;
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+
+	result = stream->ops.reconfigure(stream);
+	if (result != 0) {
+		/* restore the old configuration */
+		spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+		stream->video.input_format = old_inpf;
+		stream->video.video_format = old_vidf;
+		stream->video.pixel_format = old_pixf;
+		spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+
+		/* reacquire the components for the old format before reprogramming */
+		if (stream->ops.reconfigure(stream) != 0) {
+			NTV2_MSG_CHANNEL_ERROR("%s: *error* %s can not restore hardware\n",
+								   ntv2_chn->name, ntv2_stream_name(stream->type));
+			return result;
+		}
+	}
+
+	stream->ops.update_format(stream);
+	stream->ops.update_timing(stream);
+	stream->ops.update_route(stream);
+	stream->ops.update_mode(stream);
+
+	if (result != 0)
+		return result;
+
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+
+	/* drop frames captured with the old format */
+	list_for_each_entry_safe(data, next, &stream->data_ready_list, list) {
+		if (data->reader_taken == 0) {
+			data->reader_pending = 0;
+			list_del_init(&data->list);
+			list_add_tail(&data->list, &stream->data_done_list);
+		}
+	}
+
+	/* skip the frame being captured during the change */
+	stream->queue_last = false;
+
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+
+	return 0;
+}
+
 struct ntv2_stream_data *ntv2_channel_data_ready(struct ntv2_channel_stream *stream)
 {
 	struct ntv2_channel *ntv2_chn;
@@ -566,6 +749,481 @@ void ntv2_channel_data_done(struct ntv2_stream_data *ntv2_data)
 	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
 }
 
+struct ntv2_stream_data *ntv2_channel_data_free(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn;
+	struct ntv2_stream_data *data = NULL;
+	unsigned long flags;
+
+	if (stream == NULL)
+		return NULL;
+
+	ntv2_chn = stream->ntv2_chn;
+
+	/* get the next buffer to fill for playback */
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+	if (stream->queue_enable && !list_empty(&stream->data_done_list)) {
+		data = list_first_entry(&stream->data_done_list, struct ntv2_stream_data, list);
+		list_del_init(&data->list);
+	}
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+
+	if (data != NULL) {
+		NTV2_MSG_CHANNEL_STREAM("%s: %s data free %d\n",
+								ntv2_chn->name,
+								ntv2_stream_name(stream->type),
+								data->index);
+	}
+
+	return data;
+}
+
+void ntv2_channel_data_queue(struct ntv2_stream_data *ntv2_data)
+{
+	struct ntv2_channel_stream *stream;
+	struct ntv2_channel *ntv2_chn;
+	unsigned long flags;
+
+	if (ntv2_data == NULL)
+		return;
+
+	stream = ntv2_data->ntv2_str;
+	if (stream == NULL)
+		return;
+
+	ntv2_chn = stream->ntv2_chn;
+	if (ntv2_chn == NULL)
+		return;
+
+	NTV2_MSG_CHANNEL_STREAM("%s: %s data queue %d\n",
+							ntv2_chn->name,
+							ntv2_stream_name(stream->type),
+							ntv2_data->index);
+
+	/* buffer filled and ready to play, a stopped stream takes it back */
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+	if (stream->queue_enable) {
+		list_add_tail(&ntv2_data->list, &stream->data_ready_list);
+	} else {
+		list_add_tail(&ntv2_data->list, &stream->data_done_list);
+	}
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+}
+
+static bool ntv2_channel_reader_format(struct ntv2_channel_stream *stream,
+									   const struct ntv2_video_format *vidf,
+									   const struct ntv2_pixel_format *pixf)
+{
+	unsigned long flags;
+	bool match;
+
+	spin_lock_irqsave(&stream->ntv2_chn->state_lock, flags);
+	match =
+		((stream->video.video_format.video_standard == vidf->video_standard) &&
+		 (stream->video.video_format.frame_geometry == vidf->frame_geometry) &&
+		 (stream->video.video_format.frame_rate == vidf->frame_rate) &&
+		 (stream->video.pixel_format.v4l2_pixel_format == pixf->v4l2_pixel_format));
+	spin_unlock_irqrestore(&stream->ntv2_chn->state_lock, flags);
+
+	return match;
+}
+
+int ntv2_channel_enable_reader(struct ntv2_channel_stream *stream, int reader,
+							   struct ntv2_input_format *inpf,
+							   const struct ntv2_video_format *vidf,
+							   const struct ntv2_pixel_format *pixf)
+{
+	struct ntv2_channel *ntv2_chn;
+	unsigned long flags;
+	bool follow;
+	bool active;
+	int result;
+
+	if ((stream == NULL) ||
+		(reader < 0) ||
+		(reader >= NTV2_MAX_STREAM_READERS))
+		return -EPERM;
+
+	ntv2_chn = stream->ntv2_chn;
+
+	/* readers without a format follow the channel format */
+	follow = (inpf == NULL) || (vidf == NULL) || (pixf == NULL);
+
+	mutex_lock(&stream->reader_mutex);
+
+	if (stream->readers[reader].enable) {
+		mutex_unlock(&stream->reader_mutex);
+		return 0;
+	}
+
+	active = ntv2_channel_reader_active(stream, reader);
+	if (!follow) {
+		if (ntv2_channel_format_owner(stream, reader)) {
+			/* readers share the channel format */
+			if (!ntv2_channel_reader_format(stream, vidf, pixf)) {
+				mutex_unlock(&stream->reader_mutex);
+				NTV2_MSG_CHANNEL_ERROR("%s: *error* %s reader %d format does not match the active readers\n",
+									   ntv2_chn->name, ntv2_stream_name(stream->type), reader);
+				return -EBUSY;
+			}
+		} else if (active) {
+			/* only followers are running, move the stream to this format */
+			result = ntv2_channel_reconfigure(stream, inpf, vidf, pixf);
+			if (result != 0) {
+				mutex_unlock(&stream->reader_mutex);
+				return result;
+			}
+		} else {
+			/* the first reader sets the format */
+			spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+			stream->video.input_format = *inpf;
+			stream->video.video_format = *vidf;
+			stream->video.pixel_format = *pixf;
+			spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+		}
+	}
+
+	/* the first reader enables the stream */
+	if (!active) {
+		result = ntv2_channel_enable(stream);
+		if (result != 0) {
+			mutex_unlock(&stream->reader_mutex);
+			return result;
+		}
+	}
+
+	NTV2_MSG_CHANNEL_STATE("%s: %s reader %d enable\n",
+						   ntv2_chn->name, ntv2_stream_name(stream->type), reader);
+
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+	stream->readers[reader].enable = true;
+	stream->readers[reader].follow = follow;
+	stream->readers[reader].run = false;
+	stream->readers[reader].skip = 0;
+	ntv2_channel_reader_interval(stream);
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+
+	mutex_unlock(&stream->reader_mutex);
+
+	return 0;
+}
+
+int ntv2_channel_disable_reader(struct ntv2_channel_stream *stream, int reader)
+{
+	struct ntv2_channel *ntv2_chn;
+	unsigned long flags;
+
+	if ((stream == NULL) ||
+		(reader < 0) ||
+		(reader >= NTV2_MAX_STREAM_READERS))
+		return -EPERM;
+
+	ntv2_chn = stream->ntv2_chn;
+
+	mutex_lock(&stream->reader_mutex);
+
+	if (!stream->readers[reader].enable) {
+		mutex_unlock(&stream->reader_mutex);
+		return 0;
+	}
+
+	NTV2_MSG_CHANNEL_STATE("%s: %s reader %d disable\n",
+						   ntv2_chn->name, ntv2_stream_name(stream->type), reader);
+
+	/* give back all frames held for this reader */
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+	stream->readers[reader].enable = false;
+	stream->readers[reader].follow = false;
+	stream->readers[reader].run = false;
+	stream->readers[reader].callback_func = NULL;
+	stream->readers[reader].callback_data = 0;
+	if (stream->queue_enable)
+		ntv2_channel_reader_release(stream, reader, true);
+	ntv2_channel_reader_interval(stream);
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+
+	/* the last reader disables the stream */
+	if (!ntv2_channel_reader_active(stream, reader)) {
+		ntv2_channel_stop(stream);
+		ntv2_channel_flush(stream);
+		ntv2_channel_disable(stream);
+	}
+
+	mutex_unlock(&stream->reader_mutex);
+
+	return 0;
+}
+
+int ntv2_channel_start_reader(struct ntv2_channel_stream *stream, int reader)
+{
+	struct ntv2_channel *ntv2_chn;
+	unsigned long flags;
+	int result = 0;
+
+	if ((stream == NULL) ||
+		(reader < 0) ||
+		(reader >= NTV2_MAX_STREAM_READERS))
+		return -EPERM;
+
+	ntv2_chn = stream->ntv2_chn;
+
+	mutex_lock(&stream->reader_mutex);
+
+	if (!stream->readers[reader].enable) {
+		mutex_unlock(&stream->reader_mutex);
+		return -EINVAL;
+	}
+
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+	stream->readers[reader].run = true;
+	stream->readers[reader].skip = 0;
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+
+	/* start the stream for the first running reader */
+	result = ntv2_channel_start(stream);
+	if (result != 0) {
+		spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+		stream->readers[reader].run = false;
+		spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+	}
+
+	mutex_unlock(&stream->reader_mutex);
+
+	return result;
+}
+
+int ntv2_channel_stop_reader(struct ntv2_channel_stream *stream, int reader)
+{
+	struct ntv2_channel *ntv2_chn;
+	unsigned long flags;
+	bool run = false;
+	int i;
+
+	if ((stream == NULL) ||
+		(reader < 0) ||
+		(reader >= NTV2_MAX_STREAM_READERS))
+		return -EPERM;
+
+	ntv2_chn = stream->ntv2_chn;
+
+	mutex_lock(&stream->reader_mutex);
+
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+	stream->readers[reader].run = false;
+	for (i = 0; i < NTV2_MAX_STREAM_READERS; i++)
+		run = run || stream->readers[i].run;
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+
+	/* stop the stream when no reader is running */
+	if (!run)
+		ntv2_channel_stop(stream);
+
+	mutex_unlock(&stream->reader_mutex);
+
+	return 0;
+}
+
+int ntv2_channel_flush_reader(struct ntv2_channel_stream *stream, int reader)
+{
+	struct ntv2_channel *ntv2_chn;
+	unsigned long flags;
+
+	if ((stream == NULL) ||
+		(reader < 0) ||
+		(reader >= NTV2_MAX_STREAM_READERS))
+		return -EPERM;
+
+	ntv2_chn = stream->ntv2_chn;
+
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+
+	if (!stream->queue_enable || !stream->readers[reader].enable) {
+		spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+		return -EINVAL;
+	}
+
+	NTV2_MSG_CHANNEL_STATE("%s: %s reader %d flush\n",
+						   ntv2_chn->name, ntv2_stream_name(stream->type), reader);
+
+	/* frames in transfer are returned by data done */
+	ntv2_channel_reader_release(stream, reader, false);
+
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+
+	return 0;
+}
+
+int ntv2_channel_set_reader_interval(struct ntv2_channel_stream *stream,
+									 int reader, u32 interval)
+{
+	unsigned long flags;
+
+	if ((stream == NULL) ||
+		(reader < 0) ||
+		(reader >= NTV2_MAX_STREAM_READERS))
+		return -EPERM;
+
+	if ((interval == 0) || (interval > NTV2_MAX_FRAME_INTERVAL))
+		return -EINVAL;
+
+	spin_lock_irqsave(&stream->ntv2_chn->state_lock, flags);
+	if (stream->readers[reader].interval != interval) {
+		stream->readers[reader].interval = interval;
+		stream->readers[reader].skip = 0;
+		ntv2_channel_reader_interval(stream);
+	}
+	spin_unlock_irqrestore(&stream->ntv2_chn->state_lock, flags);
+
+	return 0;
+}
+
+int ntv2_channel_set_reader_callback(struct ntv2_channel_stream *stream,
+									 int reader,
+									 ntv2_channel_callback func,
+									 unsigned long data)
+{
+	unsigned long flags;
+
+	if ((stream == NULL) ||
+		(reader < 0) ||
+		(reader >= NTV2_MAX_STREAM_READERS))
+		return -EPERM;
+
+	spin_lock_irqsave(&stream->ntv2_chn->state_lock, flags);
+	stream->readers[reader].callback_func = func;
+	stream->readers[reader].callback_data = data;
+	spin_unlock_irqrestore(&stream->ntv2_chn->state_lock, flags);
+
+	return 0;
+}
+
+bool ntv2_channel_reader_active(struct ntv2_channel_stream *stream, int except)
+{
+	unsigned long flags;
+	bool active = false;
+	int i;
+
+	if (stream == NULL)
+		return false;
+
+	spin_lock_irqsave(&stream->ntv2_chn->state_lock, flags);
+	for (i = 0; i < NTV2_MAX_STREAM_READERS; i++) {
+		if ((i != except) && stream->readers[i].enable)
+			active = true;
+	}
+	spin_unlock_irqrestore(&stream->ntv2_chn->state_lock, flags);
+
+	return active;
+}
+
+bool ntv2_channel_format_owner(struct ntv2_channel_stream *stream, int except)
+{
+	unsigned long flags;
+	bool owner = false;
+	int i;
+
+	if (stream == NULL)
+		return false;
+
+	spin_lock_irqsave(&stream->ntv2_chn->state_lock, flags);
+	for (i = 0; i < NTV2_MAX_STREAM_READERS; i++) {
+		if ((i != except) && stream->readers[i].enable && !stream->readers[i].follow)
+			owner = true;
+	}
+	spin_unlock_irqrestore(&stream->ntv2_chn->state_lock, flags);
+
+	return owner;
+}
+
+struct ntv2_stream_data *ntv2_channel_data_ready_reader(struct ntv2_channel_stream *stream,
+														int reader)
+{
+	struct ntv2_channel *ntv2_chn;
+	struct ntv2_stream_reader *rdr;
+	struct ntv2_stream_data *data = NULL;
+	struct ntv2_stream_data *ptr;
+	struct ntv2_stream_data *next;
+	unsigned long flags;
+	u32 mask;
+	u32 ratio;
+	u32 skip;
+
+	if ((stream == NULL) ||
+		(reader < 0) ||
+		(reader >= NTV2_MAX_STREAM_READERS))
+		return NULL;
+
+	ntv2_chn = stream->ntv2_chn;
+	rdr = &stream->readers[reader];
+	mask = 1 << reader;
+
+	/* get the next captured buffer not yet seen by this reader */
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+	if (stream->queue_enable && rdr->enable) {
+		ratio = rdr->interval / stream->video.frame_interval;
+		list_for_each_entry_safe(ptr, next, &stream->data_ready_list, list) {
+			if (((ptr->reader_pending & mask) == 0) ||
+				((ptr->reader_taken & mask) != 0))
+				continue;
+			/* decimate the shared stream to the reader interval */
+			if (ratio > 1) {
+				skip = rdr->skip;
+				rdr->skip = (rdr->skip + 1) % ratio;
+				if (skip != 0) {
+					ntv2_channel_reader_complete(stream, ptr, reader);
+					continue;
+				}
+			}
+			ptr->reader_taken |= mask;
+			data = ptr;
+			break;
+		}
+	}
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+
+	if (data != NULL) {
+		NTV2_MSG_CHANNEL_STREAM("%s: %s reader %d data ready %d\n",
+								ntv2_chn->name,
+								ntv2_stream_name(stream->type),
+								reader,
+								data->index);
+	}
+
+	return data;
+}
+
+void ntv2_channel_data_done_reader(struct ntv2_stream_data *ntv2_data, int reader)
+{
+	struct ntv2_channel_stream *stream;
+	struct ntv2_channel *ntv2_chn;
+	unsigned long flags;
+
+	if ((ntv2_data == NULL) ||
+		(reader < 0) ||
+		(reader >= NTV2_MAX_STREAM_READERS))
+		return;
+
+	stream = ntv2_data->ntv2_str;
+	if (stream == NULL)
+		return;
+
+	ntv2_chn = stream->ntv2_chn;
+	if (ntv2_chn == NULL)
+		return;
+
+	NTV2_MSG_CHANNEL_STREAM("%s: %s reader %d data done %d\n",
+							ntv2_chn->name,
+							ntv2_stream_name(stream->type),
+							reader,
+							ntv2_data->index);
+
+	/* buffer done when the last reader is done */
+	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+	if (stream->queue_enable && ((ntv2_data->reader_taken & (1 << reader)) != 0))
+		ntv2_channel_reader_complete(stream, ntv2_data, reader);
+	spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+}
+
 int ntv2_channel_interrupt(struct ntv2_channel *ntv2_chn,
 						   struct ntv2_interrupt_status* irq_status)
 {
@@ -614,6 +1272,7 @@ int ntv2_channel_interrupt(struct ntv2_channel *ntv2_chn,
 	ntv2_chn->int_status.interrupt_input = ntv2_chn->int_status.interrupt_input || input;
 	ntv2_chn->int_status.interrupt_output = ntv2_chn->int_status.interrupt_output || output;
 	ntv2_chn->int_status.interrupt_time = irq_status->v4l2_time;
+	ntv2_chn->int_status.irq_time = irq_status->v4l2_time;
 	ntv2_chn->int_status.audio_input_offset = aud_in;
 	ntv2_chn->int_status.audio_output_offset = aud_out;
 	spin_unlock_irqrestore(&ntv2_chn->int_lock, flags);
@@ -632,6 +1291,7 @@ void ntv2_channel_dpc(unsigned long data)
 	unsigned long callback_data;
 	unsigned long flags;
 	int i;
+	int j;
 
 	if (ntv2_chn == NULL)
 		return;
@@ -644,6 +1304,11 @@ void ntv2_channel_dpc(unsigned long data)
 
 	ntv2_chn->dpc_status.interrupt_rate = ntv2_video_output_interrupt_rate(ntv2_chn->vid_reg, ntv2_chn->index);
 	ntv2_chn->dpc_status.stat_time = ntv2_system_time();
+#ifdef NTV2_USE_VB2_BUFFER_TIMESTAMP
+	/* replace the isr time with the filtered frame time */
+	if (ntv2_chn->dpc_status.interrupt_input)
+		ntv2_channel_frame_clock(ntv2_chn);
+#endif
 
 	spin_lock_irqsave(&ntv2_chn->state_lock, flags);
 
@@ -673,15 +1338,140 @@ void ntv2_channel_dpc(unsigned long data)
 			spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
 			if (callback_func != NULL)
 				(*callback_func)(callback_data);
+			for (j = 0; j < NTV2_MAX_STREAM_READERS; j++) {
+				spin_lock_irqsave(&ntv2_chn->state_lock, flags);
+				callback_func = stream->readers[j].callback_func;
+				callback_data = stream->readers[j].callback_data;
+				spin_unlock_irqrestore(&ntv2_chn->state_lock, flags);
+				if (callback_func != NULL)
+					(*callback_func)(callback_data);
+			}
 		}
 	}
 }
 
+#ifdef NTV2_USE_VB2_BUFFER_TIMESTAMP
+/*
+ * Track the input frame period with a phase/frequency filter so the frame
+ * times step by the measured period instead of following isr latency.
+ */
+static void ntv2_channel_frame_clock(struct ntv2_channel *ntv2_chn)
+{
+	struct ntv2_channel_clock *clock = &ntv2_chn->input_clock;
+	struct ntv2_channel_stream *stream = ntv2_chn->streams[ntv2_stream_type_vidin];
+	s64 irq_time = (s64)ntv2_chn->dpc_status.interrupt_time;
+	u32 frame_rate;
+	u32 scale;
+	s64 nominal;
+	s64 period;
+	s64 frames;
+	s64 error;
+
+	if (stream == NULL)
+		return;
+
+	frame_rate = stream->video.video_format.frame_rate;
+	scale = ntv2_frame_rate_scale(frame_rate);
+	if (scale == 0)
+		return;
+	nominal = (s64)div_u64((u64)ntv2_frame_rate_duration(frame_rate) * NSEC_PER_SEC, scale);
+	if (nominal == 0)
+		return;
+
+	if (clock->lock && (clock->frame_rate == frame_rate)) {
+		period = clock->frame_period >> NTV2_CHANNEL_CLOCK_SHIFT;
+
+		/* whole frames since the last filtered time */
+		frames = div64_s64(irq_time - clock->frame_time + period / 2, period);
+		if ((frames >= 1) && (frames <= NTV2_CHANNEL_CLOCK_MAX_FRAMES)) {
+			error = irq_time - (clock->frame_time + frames * period);
+			if ((error > -(period / 4)) && (error < (period / 4))) {
+				/* pull phase by 1/16 and period by 1/256 of the error */
+				clock->frame_time += frames * period + div_s64(error, 16);
+				clock->frame_period += div_s64(error, (s32)frames);
+				clock->frame_period = clamp_t(s64, clock->frame_period,
+											  (nominal - nominal / 1000) << NTV2_CHANNEL_CLOCK_SHIFT,
+											  (nominal + nominal / 1000) << NTV2_CHANNEL_CLOCK_SHIFT);
+				ntv2_chn->dpc_status.interrupt_time = (v4l2_time_t)clock->frame_time;
+				return;
+			}
+		}
+
+		NTV2_MSG_CHANNEL_STATE("%s: input frame clock resync\n", ntv2_chn->name);
+	}
+
+	/* lock to this interrupt */
+	clock->frame_rate = frame_rate;
+	clock->frame_time = irq_time;
+	clock->frame_period = nominal << NTV2_CHANNEL_CLOCK_SHIFT;
+	clock->lock = true;
+}
+#endif
+
+static void ntv2_channel_reader_interval(struct ntv2_channel_stream *stream)
+{
+	u32 interval = 0;
+	int i;
+
+	/* the card stream runs at the finest enabled reader interval */
+	for (i = 0; i < NTV2_MAX_STREAM_READERS; i++) {
+		if (stream->readers[i].enable)
+			interval = (interval == 0)? stream->readers[i].interval :
+				gcd(interval, stream->readers[i].interval);
+	}
+	if (interval == 0)
+		interval = 1;
+
+	if (stream->video.frame_interval != interval) {
+		stream->video.frame_interval = interval;
+		stream->video.frame_skip = 0;
+		for (i = 0; i < NTV2_MAX_STREAM_READERS; i++)
+			stream->readers[i].skip = 0;
+	}
+}
+
+static void ntv2_channel_reader_release(struct ntv2_channel_stream *stream,
+										int reader, bool taken)
+{
+	struct ntv2_stream_data *ptr;
+	struct ntv2_stream_data *next;
+	u32 mask = 1 << reader;
+
+	list_for_each_entry_safe(ptr, next, &stream->data_ready_list, list) {
+		if ((ptr->reader_pending & mask) == 0)
+			continue;
+		if (!taken && ((ptr->reader_taken & mask) != 0))
+			continue;
+		ntv2_channel_reader_complete(stream, ptr, reader);
+	}
+}
+
+static void ntv2_channel_reader_complete(struct ntv2_channel_stream *stream,
+										 struct ntv2_stream_data *data,
+										 int reader)
+{
+	u32 mask = 1 << reader;
+
+	data->reader_pending &= ~mask;
+	data->reader_taken &= ~mask;
+
+	/* recycle the frame when no reader needs it */
+	if (data->reader_pending == 0) {
+		list_del_init(&data->list);
+		list_add_tail(&data->list, &stream->data_done_list);
+	}
+}
+
 static int ntv2_streamops_nop(struct ntv2_channel_stream *stream)
 {
 	return 0;
 }
 
+static int ntv2_streamops_busy(struct ntv2_channel_stream *stream)
+{
+	return -EBUSY;
+}
+
 static void ntv2_streamops_initialize(struct ntv2_stream_ops *ops)
 {
 	ops->setup = ntv2_streamops_nop;
@@ -691,4 +1481,6 @@ static void ntv2_streamops_initialize(struct ntv2_stream_ops *ops)
 	ops->update_format = ntv2_streamops_nop;
 	ops->update_route = ntv2_streamops_nop;
 	ops->interrupt = ntv2_streamops_nop;
+	ops->update_position = ntv2_streamops_nop;
+	ops->reconfigure = ntv2_streamops_busy;
 }
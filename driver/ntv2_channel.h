@@ -25,6 +25,11 @@
 #define NTV2_MAX_CHANNEL_STREAMS		8
 #define NTV2_MAX_CHANNEL_BUFFERS		64
 #define NTV2_CHANNEL_STATISTIC_INTERVAL	5000000
+#define NTV2_MAX_FRAME_INTERVAL			60
+#define NTV2_MAX_STREAM_READERS			5
+#define NTV2_ANC_FIELD_SIZE				0x2000
+#define NTV2_CHANNEL_CLOCK_SHIFT		8
+#define NTV2_CHANNEL_CLOCK_MAX_FRAMES	8
 
 enum ntv2_channel_state {
 	ntv2_channel_state_unknown,
@@ -41,12 +46,20 @@ struct ntv2_channel_status {
 	bool							interrupt_input;
 	bool							interrupt_output;
 	v4l2_time_t						interrupt_time;
+	v4l2_time_t						irq_time;
 	u32								interrupt_rate;
 	u32								audio_input_offset;
 	u32								audio_output_offset;
 	s64								stat_time;
 };
 
+struct ntv2_channel_clock {
+	u32								frame_rate;
+	s64								frame_time;
+	s64								frame_period;
+	bool							lock;
+};
+
 struct ntv2_video_data {
 	u32								frame_number;
 	u32								address;
@@ -54,6 +67,8 @@ struct ntv2_video_data {
 	u32								timecode_low;
 	u32								timecode_high;
 	bool							timecode_present;
+	u32								anc_address[2];
+	u32								anc_size[2];
 };
 
 struct ntv2_audio_data {
@@ -62,6 +77,7 @@ struct ntv2_audio_data {
 	u32								data_size[2];
 	u32								num_channels;
 	u32								sample_size;
+	bool							silence;
 };
 
 struct ntv2_stream_data {
@@ -71,6 +87,9 @@ struct ntv2_stream_data {
 
 	enum ntv2_stream_type			type;
 	v4l2_time_t						timestamp;
+	v4l2_time_t						irq_time;
+	u32								reader_pending;
+	u32								reader_taken;
 
 	union {
 		struct ntv2_video_data		video;
@@ -86,10 +105,13 @@ struct ntv2_video_stream {
 	u32								frame_first;
 	u32								frame_last;
 	u32								frame_size;
+	u32								frame_interval;
+	u32								frame_skip;
 	bool							hardware_enable[NTV2_MAX_CHANNELS];
 
 	int								csc_index;
 	int								num_cscs;
+	int								anc_index;
 
 	struct ntv2_stream_data			*frame_active;
 	struct ntv2_stream_data			*frame_next;
@@ -109,14 +131,21 @@ struct ntv2_audio_stream {
 	u32								num_channels;
 	u32								sample_size;
 	u32								audio_offset;
+	u32								transfer_offset;
 	u32								ring_address;
 	u32								ring_offset;
 	u32								ring_size;
 	u32								ring_init;
 	u32								sync_cadence;
 	u32								sync_tolerance;
+	u32								sync_ratio;
+	u32								sync_fraction;
+	u32								sync_rate;
+	v4l2_time_t						sync_time;
+	u32								sync_time_offset;
 	bool							hardware_enable;
 	bool							embedded_clock;
+	bool							source_update;
 
 	s64								total_sample_count;
 	s64								total_transfer_count;
@@ -126,6 +155,16 @@ struct ntv2_audio_stream {
     s64								last_display_time;
 };
 
+struct ntv2_stream_reader {
+	bool							enable;
+	bool							run;
+	bool							follow;
+	u32								interval;
+	u32								skip;
+	ntv2_channel_callback			callback_func;
+	unsigned long					callback_data;
+};
+
 struct ntv2_stream_ops {
 	int (*setup)(struct ntv2_channel_stream *stream);
 	int (*release)(struct ntv2_channel_stream *stream);
@@ -134,6 +173,8 @@ struct ntv2_stream_ops {
 	int (*update_format)(struct ntv2_channel_stream *stream);
 	int (*update_route)(struct ntv2_channel_stream *stream);
 	int (*interrupt)(struct ntv2_channel_stream *stream);
+	int (*update_position)(struct ntv2_channel_stream *stream);
+	int (*reconfigure)(struct ntv2_channel_stream *stream);
 };
 
 struct ntv2_channel_stream {
@@ -151,6 +192,9 @@ struct ntv2_channel_stream {
 	unsigned long					frame_callback_data;
 	v4l2_time_t						timestamp;
 
+	struct ntv2_stream_reader		readers[NTV2_MAX_STREAM_READERS];
+	struct mutex					reader_mutex;
+
 	struct ntv2_stream_data			data_array[NTV2_MAX_CHANNEL_BUFFERS];
 	struct list_head 				data_ready_list;
 	struct list_head 				data_done_list;
@@ -179,6 +223,7 @@ struct ntv2_channel {
 	spinlock_t 						int_lock;
 	struct ntv2_channel_status		int_status;
 	struct ntv2_channel_status		dpc_status;
+	struct ntv2_channel_clock		input_clock;
 
 	struct ntv2_channel_stream		*streams[ntv2_stream_type_size];
 };
@@ -197,13 +242,13 @@ struct ntv2_channel_stream *ntv2_channel_stream(struct ntv2_channel *ntv2_chn,
 												enum ntv2_stream_type stype);
 
 int ntv2_channel_set_video_format(struct ntv2_channel_stream *stream,
-								  struct ntv2_video_format *vidf);
+								  const struct ntv2_video_format *vidf);
 
 int ntv2_channel_get_video_format(struct ntv2_channel_stream *stream,
 								  struct ntv2_video_format *vidf);
 
 int ntv2_channel_set_pixel_format(struct ntv2_channel_stream *stream,
-								  struct ntv2_pixel_format *pixf);
+								  const struct ntv2_pixel_format *pixf);
 
 int ntv2_channel_get_pixel_format(struct ntv2_channel_stream *stream,
 								  struct ntv2_pixel_format *pixf);
@@ -220,6 +265,9 @@ int ntv2_channel_set_source_format(struct ntv2_channel_stream *stream,
 int ntv2_channel_get_source_format(struct ntv2_channel_stream *stream,
 								   struct ntv2_source_format *souf);
 
+int ntv2_channel_get_audio_rate(struct ntv2_channel_stream *stream,
+								u32 *rate);
+
 int ntv2_channel_set_frame_callback(struct ntv2_channel_stream *stream,
 									ntv2_channel_callback func,
 									unsigned long data);
@@ -231,9 +279,41 @@ int ntv2_channel_start(struct ntv2_channel_stream *stream);
 int ntv2_channel_stop(struct ntv2_channel_stream *stream);
 int ntv2_channel_flush(struct ntv2_channel_stream *stream);
 
+int ntv2_channel_update_position(struct ntv2_channel_stream *stream);
+int ntv2_channel_reconfigure(struct ntv2_channel_stream *stream,
+							 struct ntv2_input_format *inpf,
+							 const struct ntv2_video_format *vidf,
+							 const struct ntv2_pixel_format *pixf);
+
 struct ntv2_stream_data *ntv2_channel_data_ready(struct ntv2_channel_stream *stream);
 void ntv2_channel_data_done(struct ntv2_stream_data *ntv2_data);
 
+struct ntv2_stream_data *ntv2_channel_data_free(struct ntv2_channel_stream *stream);
+void ntv2_channel_data_queue(struct ntv2_stream_data *ntv2_data);
+
+int ntv2_channel_enable_reader(struct ntv2_channel_stream *stream, int reader,
+							   struct ntv2_input_format *inpf,
+							   const struct ntv2_video_format *vidf,
+							   const struct ntv2_pixel_format *pixf);
+int ntv2_channel_disable_reader(struct ntv2_channel_stream *stream, int reader);
+
+int ntv2_channel_start_reader(struct ntv2_channel_stream *stream, int reader);
+int ntv2_channel_stop_reader(struct ntv2_channel_stream *stream, int reader);
+int ntv2_channel_flush_reader(struct ntv2_channel_stream *stream, int reader);
+
+int ntv2_channel_set_reader_interval(struct ntv2_channel_stream *stream,
+									 int reader, u32 interval);
+int ntv2_channel_set_reader_callback(struct ntv2_channel_stream *stream,
+									 int reader,
+									 ntv2_channel_callback func,
+									 unsigned long data);
+bool ntv2_channel_reader_active(struct ntv2_channel_stream *stream, int except);
+bool ntv2_channel_format_owner(struct ntv2_channel_stream *stream, int except);
+
+struct ntv2_stream_data *ntv2_channel_data_ready_reader(struct ntv2_channel_stream *stream,
+														int reader);
+void ntv2_channel_data_done_reader(struct ntv2_stream_data *ntv2_data, int reader);
+
 int ntv2_channel_interrupt(struct ntv2_channel *ntv2_chn,
 						   struct ntv2_interrupt_status* irq_status);
 #endif
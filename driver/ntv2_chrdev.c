@@ -145,7 +145,8 @@ struct ntv2_chrdev *ntv2_chrdev_open(struct ntv2_object *ntv2_obj,
 {
 	struct ntv2_chrdev *ntv2_chr = NULL;
 
-	ntv2_chr = kzalloc(sizeof(struct ntv2_chrdev), GFP_KERNEL);
+	ntv2_chr = kzalloc_node(sizeof(struct ntv2_chrdev), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_chr == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_chrdev instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
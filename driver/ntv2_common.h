@@ -37,10 +37,19 @@
 #include <linux/vmalloc.h>
 #include <linux/version.h>
 #include <linux/kthread.h>
+#include <linux/workqueue.h>
+#include <linux/completion.h>
+#include <linux/bitmap.h>
+#include <linux/jhash.h>
+#include <linux/topology.h>
+#include <linux/hrtimer.h>
+#include <linux/gcd.h>
 #include <linux/serial.h>
 #include <linux/serial_core.h>
 #include <linux/tty.h>
 #include <linux/tty_flip.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
 
 #define GSPCA_DEBUG
 
@@ -75,6 +84,9 @@
 #define NTV2_USE_TTY_GROUP					/* 3.17.0 required */
 #define NTV2_RGB_PIXEL_FORMATS				/* 3.17.0 required */
 #endif
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4,2,0))
+#define NTV2_USE_PROBE_ASYNC				/* 4.2.0 optional */
+#endif
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(4,4,0))
 #define NTV2_USE_VB2_V4L2_BUFFER			/* 4.4.0 required */
 #define NTV2_USE_QUEUE_SETUP_PARG			/* 4.4.0 required */
@@ -86,6 +98,9 @@
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(4,8,0))
 #define NTV2_USE_QUEUE_SETUP_DEVICE			/* 4.8.0 required */
 #endif
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4,12,0))
+#define NTV2_USE_META_CAPTURE				/* 4.12.0 optional */
+#endif
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(4,15,0))
 #define NTV2_USE_TIMER_SETUP				/* 4.15.0 required */
 #endif
@@ -94,18 +109,31 @@
 #define NTV2_USE_PIXEL_ASPECT				/* 5.0.0 required */
 #define NTV2_USE_PCI_CHANNEL_STATE_T
 #endif
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(5,3,0))
+#define NTV2_USE_KTIME_CLOCKTAI				/* 5.3.0 optional */
+#endif
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(5,4,0))
 #define NTV2_VIDEO_DEVICE_CAPABILITES		/* 5.4.0 required */
+#define NTV2_USE_ENUM_FMT_MERGED			/* 5.4.0 required */
 #endif
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(5,4,0))
 #define NTV2_USE_IOREMAP					/* 5.6.0 required */
 #endif
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(5,6,0))
+#define NTV2_USE_SND_AUDIO_TSTAMP			/* 5.6.0 optional */
+#endif
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(5,7,0))
 #define NTV2_USE_VFL_TYPE_VIDEO				/* 5.7.0 required */
 #endif
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(6,1,0))
 #define NTV2_USE_TERMIOS_CONST
 #endif
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(6,13,0))
+#define NTV2_USE_HRTIMER_SETUP				/* 6.13.0 optional */
+#endif
+#if defined(CONFIG_DEBUG_FS) && defined(NTV2_USE_VB2_BUFFER_TIMESTAMP)
+#define NTV2_USE_FRAME_TRACE				/* debugfs frame latency trace */
+#endif
 /* 5.0.0 does build */
 
 /*
@@ -124,6 +152,17 @@
 */
 //#define NTV2_USE_VB2_DMA_SG
 
+/* pixel formats missing from older videodev2.h */
+#ifndef V4L2_PIX_FMT_V210
+#define V4L2_PIX_FMT_V210	v4l2_fourcc('v', '2', '1', '0')
+#endif
+#ifndef V4L2_PIX_FMT_P030
+#define V4L2_PIX_FMT_P030	v4l2_fourcc('P', '0', '3', '0')
+#endif
+
+/* extractor packets of field 1 followed by field 2 */
+#define NTV2_META_FMT_ANC	v4l2_fourcc('N', 'T', 'A', 'N')
+
 #include "ntv2_params.h"
 
 #endif
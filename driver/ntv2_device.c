@@ -40,6 +40,7 @@ static void ntv2_device_irq_release(struct ntv2_device *ntv2_dev);
 
 static irqreturn_t ntv2_device_interrupt(int irq, void* dev_id);
 static void ntv2_device_init_hardware(struct ntv2_device *ntv2_dev);
+static void ntv2_device_async_configure(struct work_struct *work);
 static void ntv2_device_monitor(unsigned long data);
 
 /*
@@ -61,6 +62,7 @@ struct ntv2_device *ntv2_device_open(struct ntv2_module *ntv2_mod,
 	INIT_LIST_HEAD(&ntv2_dev->list);
 	ntv2_dev->ntv2_dev = ntv2_dev;
 	ntv2_dev->ntv2_mod = ntv2_mod;
+	ntv2_dev->numa_node = NUMA_NO_NODE;
 
 	/* video list */
 	INIT_LIST_HEAD(&ntv2_dev->video_list);
@@ -83,6 +85,9 @@ struct ntv2_device *ntv2_device_open(struct ntv2_module *ntv2_mod,
 	spin_lock_init(&ntv2_dev->channel_lock);
 	atomic_set(&ntv2_dev->channel_index, 0);
 
+	/* deferred configuration */
+	INIT_WORK(&ntv2_dev->async_work, ntv2_device_async_configure);
+
 	NTV2_MSG_DEVICE_INFO("%s: open ntv2_device\n", ntv2_dev->name);
 
 	return ntv2_dev;
@@ -106,6 +111,9 @@ void ntv2_device_close(struct ntv2_device *ntv2_dev)
 
 	NTV2_MSG_DEVICE_INFO("%s: close ntv2_device\n", ntv2_dev->name);
 
+	/* wait for deferred configuration */
+	cancel_work_sync(&ntv2_dev->async_work);
+
 	ntv2_pci_disable(ntv2_dev->pci_dma);
 
 	/* delete all serial objects */
@@ -175,16 +183,15 @@ int ntv2_device_configure(struct ntv2_device *ntv2_dev,
 	struct ntv2_channel *ntv2_chn;
 	struct ntv2_video *ntv2_vid;
 	struct ntv2_audio *ntv2_aud;
-	struct ntv2_serial *ntv2_ser;
 	unsigned long flags;
 	u32 device_id;
 	int num_channels;
 	int num_video;
 	int num_audio;
-	int num_serial;
 	int index;
 	int result;
 	int i;
+	int j;
 
 	if ((ntv2_dev == NULL) || (pdev == NULL))
 		return -EPERM;
@@ -331,7 +338,6 @@ int ntv2_device_configure(struct ntv2_device *ntv2_dev,
 	num_video = ntv2_dev->features->num_video_channels;
 	num_audio = ntv2_dev->features->num_audio_channels;
 	num_channels = max(num_video, num_audio);
-	num_serial = ntv2_dev->features->num_serial_ports;
 
 	for (i = 0; i < num_channels; i++) {
 		/* allocate and initialize channel instance */
@@ -353,25 +359,79 @@ int ntv2_device_configure(struct ntv2_device *ntv2_dev,
 		spin_unlock_irqrestore(&ntv2_dev->channel_lock, flags);
 
 		if (i < num_video) {
-			/* allocate and initialize video device instance */
+			/* readers of the same channel share the video index */
 			index = atomic_inc_return(&ntv2_dev->video_index) - 1;
-			ntv2_vid = ntv2_video_open((struct ntv2_object*)ntv2_dev, "vid", index);
-
-			/* configure video device */
-			result = ntv2_video_configure(ntv2_vid,
-										  ntv2_dev->features,
-										  ntv2_chn,
-										  ntv2_dev->inp_mon,
-										  ntv2_dev->pci_dma);
-			if (result != 0) {
-				ntv2_video_close(ntv2_vid);
-				return result;
+			for (j = 0; j < ntv2_module_info()->video_readers; j++) {
+				/* allocate and initialize video device instance */
+				ntv2_vid = ntv2_video_open((struct ntv2_object*)ntv2_dev, "vid", index, j,
+										   ntv2_video_type_capture);
+
+				/* configure video device */
+				result = ntv2_video_configure(ntv2_vid,
+											  ntv2_dev->features,
+											  ntv2_chn,
+											  ntv2_dev->inp_mon,
+											  ntv2_dev->pci_dma);
+				if (result != 0) {
+					ntv2_video_close(ntv2_vid);
+					return result;
+				}
+
+				/* add to the video list */
+				spin_lock_irqsave(&ntv2_dev->video_lock, flags);
+				list_add_tail(&ntv2_vid->list, &ntv2_dev->video_list);
+				spin_unlock_irqrestore(&ntv2_dev->video_lock, flags);
 			}
 
-			/* add to the video list */
-			spin_lock_irqsave(&ntv2_dev->video_lock, flags);
-			list_add_tail(&ntv2_vid->list, &ntv2_dev->video_list);
-			spin_unlock_irqrestore(&ntv2_dev->video_lock, flags);
+			/* playback needs a bidirectional sdi connector */
+			if (ntv2_module_info()->video_outputs &&
+				(i < ntv2_dev->features->num_sdi_inputs)) {
+				/* allocate and initialize video output instance */
+				ntv2_vid = ntv2_video_open((struct ntv2_object*)ntv2_dev, "out", index, 0,
+										   ntv2_video_type_output);
+
+				/* configure video device */
+				result = ntv2_video_configure(ntv2_vid,
+											  ntv2_dev->features,
+											  ntv2_chn,
+											  ntv2_dev->inp_mon,
+											  ntv2_dev->pci_dma);
+				if (result != 0) {
+					ntv2_video_close(ntv2_vid);
+					return result;
+				}
+
+				/* add to the video list */
+				spin_lock_irqsave(&ntv2_dev->video_lock, flags);
+				list_add_tail(&ntv2_vid->list, &ntv2_dev->video_list);
+				spin_unlock_irqrestore(&ntv2_dev->video_lock, flags);
+			}
+#ifdef NTV2_USE_META_CAPTURE
+			/* ancillary data is one more reader of the capture stream */
+			if (ntv2_module_info()->video_anc &&
+				(i < ntv2_dev->features->num_anc_extractors)) {
+				/* allocate and initialize ancillary capture instance */
+				ntv2_vid = ntv2_video_open((struct ntv2_object*)ntv2_dev, "anc", index,
+										   ntv2_module_info()->video_readers,
+										   ntv2_video_type_anc);
+
+				/* configure video device */
+				result = ntv2_video_configure(ntv2_vid,
+											  ntv2_dev->features,
+											  ntv2_chn,
+											  ntv2_dev->inp_mon,
+											  ntv2_dev->pci_dma);
+				if (result != 0) {
+					ntv2_video_close(ntv2_vid);
+					return result;
+				}
+
+				/* add to the video list */
+				spin_lock_irqsave(&ntv2_dev->video_lock, flags);
+				list_add_tail(&ntv2_vid->list, &ntv2_dev->video_list);
+				spin_unlock_irqrestore(&ntv2_dev->video_lock, flags);
+			}
+#endif
 		}
 
 		if (i < num_audio) {
@@ -398,40 +458,14 @@ int ntv2_device_configure(struct ntv2_device *ntv2_dev,
 		}
 	}
 
-	/* register the pcm devices */
-	if (num_audio > 0) {
-		result = snd_card_register(ntv2_dev->snd_card);
-		if (result < 0) {
-			NTV2_MSG_DEVICE_ERROR("%s: *error* snd_card_register failed code %d\n",
-								  ntv2_dev->name, result);
-		}
-	}
-
-	for (i = 0; i < num_serial; i++) {
-		/* allocate and initialize serial device instance */
-		index = atomic_inc_return(&ntv2_dev->serial_index) - 1;
-		ntv2_ser = ntv2_serial_open((struct ntv2_object*)ntv2_dev, "ser", index);
-
-		/* configure serial device */
-		result = ntv2_serial_configure(ntv2_ser,
-									   ntv2_dev->features,
-									   ntv2_dev->vid_reg);
-		if (result != 0) {
-			ntv2_serial_close(ntv2_ser);
-			return result;
-		}
-
-		/* add to the serial list */
-		spin_lock_irqsave(&ntv2_dev->serial_lock, flags);
-		list_add_tail(&ntv2_ser->list, &ntv2_dev->serial_list);
-		spin_unlock_irqrestore(&ntv2_dev->serial_lock, flags);
-	}
-
 	/* enable interrupts */
 	result = ntv2_pci_enable(ntv2_dev->pci_dma);
 	if (result != 0)
 		return result;
 
+	/* the video nodes are ready, register the rest in the background */
+	schedule_work(&ntv2_dev->async_work);
+
 	return 0;
 }
 
@@ -509,6 +543,7 @@ static int ntv2_device_pci_configure(struct ntv2_device *ntv2_dev, struct pci_de
 	NTV2_MSG_DEVICE_INFO("%s: configure pci resources\n", ntv2_dev->name);
 
 	ntv2_dev->pci_dev = pdev;
+	ntv2_dev->numa_node = dev_to_node(&pdev->dev);
 
 	/* determine barness */
 	switch (pdev->device)
@@ -751,6 +786,10 @@ static int ntv2_device_irq_configure(struct ntv2_device *ntv2_dev)
 	}
 	ntv2_dev->irq_handler = ntv2_device_interrupt;
 
+	/* keep the interrupt and its tasklets on the board numa node */
+	if (ntv2_dev->numa_node != NUMA_NO_NODE)
+		irq_set_affinity_hint(pdev->irq, cpumask_of_node(ntv2_dev->numa_node));
+
 	NTV2_MSG_DEVICE_INFO("%s: pci msi irq %d\n", ntv2_dev->name, pdev->irq);
 
 	return 0;
@@ -767,6 +806,7 @@ static void ntv2_device_irq_release(struct ntv2_device *ntv2_dev)
 						 ntv2_dev->name, pdev->irq);
 
 	if (ntv2_dev->irq_handler != NULL) {
+		irq_set_affinity_hint(pdev->irq, NULL);
 		free_irq(pdev->irq, (void*)ntv2_dev);
 		ntv2_dev->irq_handler = NULL;
 	}
@@ -816,17 +856,74 @@ static irqreturn_t ntv2_device_interrupt(int irq, void* dev_id)
 			result = IRQ_HANDLED;
 	}
 
-	/* process uart interrupts */
+	/* process hdmi input interrupts */
+	res = ntv2_input_interrupt(ntv2_dev->inp_mon, &irq_status);
+	if (res == IRQ_HANDLED)
+		result = IRQ_HANDLED;
+
+	/* process uart interrupts (ports are added after interrupts are enabled) */
+	spin_lock(&ntv2_dev->serial_lock);
 	list_for_each(ptr, &ntv2_dev->serial_list) {
 		ser = list_entry(ptr, struct ntv2_serial, list);
 		res = ntv2_serial_interrupt(ser, &irq_status);
 		if (res == IRQ_HANDLED)
 			result = IRQ_HANDLED;
 	}
+	spin_unlock(&ntv2_dev->serial_lock);
 
 	return result;
 }
 
+/*
+ * Configure the pieces that do not gate the video nodes
+ */
+static void ntv2_device_async_configure(struct work_struct *work)
+{
+	struct ntv2_device *ntv2_dev = container_of(work, struct ntv2_device, async_work);
+	struct ntv2_serial *ntv2_ser;
+	unsigned long flags;
+	int num_serial;
+	int index;
+	int result;
+	int i;
+
+	NTV2_MSG_DEVICE_INFO("%s: deferred configure start\n", ntv2_dev->name);
+
+	/* register the pcm devices */
+	if (ntv2_dev->features->num_audio_channels > 0) {
+		result = snd_card_register(ntv2_dev->snd_card);
+		if (result < 0) {
+			NTV2_MSG_DEVICE_ERROR("%s: *error* snd_card_register failed code %d\n",
+								  ntv2_dev->name, result);
+		}
+	}
+
+	num_serial = ntv2_dev->features->num_serial_ports;
+	for (i = 0; i < num_serial; i++) {
+		/* allocate and initialize serial device instance */
+		index = atomic_inc_return(&ntv2_dev->serial_index) - 1;
+		ntv2_ser = ntv2_serial_open((struct ntv2_object*)ntv2_dev, "ser", index);
+
+		/* configure serial device */
+		result = ntv2_serial_configure(ntv2_ser,
+									   ntv2_dev->features,
+									   ntv2_dev->vid_reg);
+		if (result != 0) {
+			NTV2_MSG_DEVICE_ERROR("%s: *error* serial port %d configure failed code %d\n",
+								  ntv2_dev->name, index, result);
+			ntv2_serial_close(ntv2_ser);
+			continue;
+		}
+
+		/* add to the serial list */
+		spin_lock_irqsave(&ntv2_dev->serial_lock, flags);
+		list_add_tail(&ntv2_ser->list, &ntv2_dev->serial_list);
+		spin_unlock_irqrestore(&ntv2_dev->serial_lock, flags);
+	}
+
+	NTV2_MSG_DEVICE_INFO("%s: deferred configure complete\n", ntv2_dev->name);
+}
+
 static void ntv2_device_init_hardware(struct ntv2_device *ntv2_dev)
 {
 	int num;
@@ -20,11 +20,31 @@
 #include "ntv2_common.h"
 #include "ntv2_device.h"
 #include "ntv2_nwldma.h"
+#include "ntv2_channel.h"
 
 MODULE_DESCRIPTION("AJA NTV2 V4L2 Driver");
 MODULE_AUTHOR("AJA Video Systems Inc. (http://www.aja.com)");
 MODULE_LICENSE("GPL v2");
 
+static bool mplane;
+module_param(mplane, bool, 0444);
+MODULE_PARM_DESC(mplane, "use the multiplanar video capture api");
+
+static uint readers = 1;
+module_param(readers, uint, 0444);
+MODULE_PARM_DESC(readers, "number of video capture nodes per channel (1-4)");
+
+static bool outputs;
+module_param(outputs, bool, 0444);
+MODULE_PARM_DESC(outputs, "add a video output node per sdi channel");
+
+static bool anc;
+module_param(anc, bool, 0444);
+MODULE_PARM_DESC(anc, "add an ancillary data capture node per sdi channel");
+
+static bool tai;
+module_param(tai, bool, 0444);
+MODULE_PARM_DESC(tai, "use clock tai for video buffer timestamps");
 
 static int ntv2_probe(struct pci_dev *pdev, const struct pci_device_id *ent)
 {
@@ -45,6 +65,10 @@ static int ntv2_probe(struct pci_dev *pdev, const struct pci_device_id *ent)
 	/* allocate and initialize ntv2 device instance */
 	index = atomic_inc_return(&ntv2_mod->device_index) - 1;
 	ntv2_dev = ntv2_device_open(ntv2_mod, "dev", index);
+	if (ntv2_dev == NULL) {
+		pci_disable_device(pdev);
+		return -ENOMEM;
+	}
 
 	NTV2_MSG_INFO("%s: device probe start\n", ntv2_dev->name);
 
@@ -222,6 +246,11 @@ static struct pci_driver ntv2_pci_driver = {
 	.remove			= ntv2_remove,
 	.err_handler	= &ntv2_pci_errors,
 	.shutdown		= ntv2_shutdown,
+#ifdef NTV2_USE_PROBE_ASYNC
+	.driver			= {
+		.probe_type	= PROBE_PREFER_ASYNCHRONOUS,
+	},
+#endif
 };
 
 static int __init ntv2_module_init(void)
@@ -232,6 +261,14 @@ static int __init ntv2_module_init(void)
 	/* initialize device module info */
 	ntv2_module_initialize();
 	ntv2_mod = ntv2_module_info();
+	ntv2_mod->video_mplane = mplane;
+	/* the last stream reader is kept for the ancillary node */
+	ntv2_mod->video_readers = clamp_t(u32, readers, 1, NTV2_MAX_STREAM_READERS - 1);
+	ntv2_mod->video_outputs = outputs;
+	ntv2_mod->video_anc = anc;
+#ifdef NTV2_USE_VB2_BUFFER_TIMESTAMP
+	ntv2_mod->video_tai = tai;
+#endif
 
 	NTV2_MSG_INFO("%s: module init version %s\n", ntv2_mod->name, ntv2_mod->version);
 
@@ -252,16 +289,29 @@ static int __init ntv2_module_init(void)
 		return result;
 	}
 
+#ifdef NTV2_USE_FRAME_TRACE
+	/* debugfs root for the video trace files */
+	ntv2_mod->debugfs_root = debugfs_create_dir(ntv2_mod->name, NULL);
+	if (IS_ERR(ntv2_mod->debugfs_root))
+		ntv2_mod->debugfs_root = NULL;
+#endif
+
 	/* probe the devices */
 	result = pci_register_driver(&ntv2_pci_driver);
 	if (result < 0) {
 		NTV2_MSG_ERROR("%s: *error* pci_register_driver failed code %d\n",
 					   ntv2_mod->name, result);
 		uart_unregister_driver(&ntv2_uart_driver);
+#ifdef NTV2_USE_FRAME_TRACE
+		debugfs_remove_recursive(ntv2_mod->debugfs_root);
+		ntv2_mod->debugfs_root = NULL;
+#endif
 		return result;
 	}
+#ifndef NTV2_USE_PROBE_ASYNC
 	if (atomic_read(&ntv2_mod->device_index) == 0)
 		NTV2_MSG_INFO("%s: no ntv2 boards found\n", ntv2_mod->name);
+#endif
 
 	NTV2_MSG_INFO("%s: module init complete\n", ntv2_mod->name);
 	
@@ -277,6 +327,10 @@ static void __exit ntv2_module_exit(void)
    	pci_unregister_driver(&ntv2_pci_driver);
 	unregister_chrdev_region(ntv2_mod->cdev_number, ntv2_mod->cdev_max);
 	uart_unregister_driver(&ntv2_uart_driver);
+#ifdef NTV2_USE_FRAME_TRACE
+	debugfs_remove_recursive(ntv2_mod->debugfs_root);
+	ntv2_mod->debugfs_root = NULL;
+#endif
 	ntv2_module_release();
 
 	NTV2_MSG_INFO("%s: module exit complete\n", ntv2_mod->name);
@@ -20,15 +20,18 @@
 #include "ntv2_features.h"
 #include "ntv2_konareg.h"
 
-static bool ntv2_features_init = false;
-
-static void ntv2_features_initialize(void);
 static void ntv2_features_corvid44(struct ntv2_features *features);
 static void ntv2_features_corvid88(struct ntv2_features *features);
 static void ntv2_features_kona4(struct ntv2_features *features);
 static void ntv2_features_corvidhbr(struct ntv2_features *features);
 static void ntv2_features_konahdmi(struct ntv2_features *features);
 static void ntv2_features_kona1(struct ntv2_features *features);
+static u32 ntv2_features_timings_hash(const struct v4l2_dv_timings *t);
+static const struct ntv2_video_format
+*ntv2_features_next_timings(struct ntv2_features *features,
+							const struct v4l2_dv_timings *t,
+							unsigned pclock_delta,
+							u32 *slot);
 
 
 struct ntv2_features *ntv2_features_open(struct ntv2_object *ntv2_obj,
@@ -39,7 +42,8 @@ struct ntv2_features *ntv2_features_open(struct ntv2_object *ntv2_obj,
 	if (ntv2_obj == NULL) 
 		return NULL;
 
-	features = kzalloc(sizeof(struct ntv2_features), GFP_KERNEL);
+	features = kzalloc_node(sizeof(struct ntv2_features), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (features == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_feature instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
@@ -51,11 +55,6 @@ struct ntv2_features *ntv2_features_open(struct ntv2_object *ntv2_obj,
 	features->ntv2_dev = ntv2_obj->ntv2_dev;
 	spin_lock_init(&features->state_lock);
 
-	if (!ntv2_features_init) {
-		ntv2_features_initialize();
-		ntv2_features_init = true;
-	}
-
 	return features;
 }
 
@@ -89,7 +88,7 @@ int ntv2_features_configure(struct ntv2_features *features, u32 id)
 	return 0;
 }
 
-struct ntv2_video_config
+const struct ntv2_video_config
 *ntv2_features_get_video_config(struct ntv2_features *features,
 								int channel_index)
 {
@@ -100,7 +99,7 @@ struct ntv2_video_config
 	return features->video_config[channel_index];
 }
 
-struct ntv2_audio_config
+const struct ntv2_audio_config
 *ntv2_features_get_audio_config(struct ntv2_features *features,
 								int channel_index)
 {
@@ -111,7 +110,7 @@ struct ntv2_audio_config
 	return features->audio_config[channel_index];
 }
 
-struct ntv2_input_config
+const struct ntv2_input_config
 *ntv2_features_get_input_config(struct ntv2_features *features,
 								int channel_index,
 								int config_index)
@@ -142,7 +141,7 @@ int ntv2_features_num_input_configs(struct ntv2_features *features,
 	return num;
 }
 
-struct ntv2_input_config
+const struct ntv2_input_config
 *ntv2_features_get_default_input_config(struct ntv2_features *features,
 										int channel_index)
 {
@@ -153,7 +152,7 @@ struct ntv2_input_config
 	return features->input_config[channel_index][0];
 }
 
-struct ntv2_widget_config
+const struct ntv2_widget_config
 *ntv2_features_get_csc_config(struct ntv2_features *features,
 							  int channel_index,
 							  int input_index)
@@ -184,7 +183,7 @@ int ntv2_features_num_csc_configs(struct ntv2_features *features,
 	return num;
 }
 
-struct ntv2_widget_config
+const struct ntv2_widget_config
 *ntv2_features_get_default_csc_config(struct ntv2_features *features,
 									  int channel_index)
 {
@@ -195,7 +194,7 @@ struct ntv2_widget_config
 	return features->csc_config[channel_index][0];
 }
 
-struct ntv2_source_config
+const struct ntv2_source_config
 *ntv2_features_get_source_config(struct ntv2_features *features,
 								int channel_index,
 								int source_index)
@@ -226,7 +225,7 @@ int ntv2_features_num_source_configs(struct ntv2_features *features,
 	return num;
 }
 
-struct ntv2_source_config
+const struct ntv2_source_config
 *ntv2_features_get_default_source_config(struct ntv2_features *features,
 										 int channel_index,
 										 bool noauto)
@@ -244,7 +243,7 @@ struct ntv2_source_config
 	return features->source_config[channel_index][index];
 }
 
-struct ntv2_pixel_format
+const struct ntv2_pixel_format
 *ntv2_features_get_pixel_format(struct ntv2_features *features,
 								int channel_index,
 								int format_index)
@@ -275,7 +274,7 @@ int ntv2_features_num_pixel_formats(struct ntv2_features *features,
 	return num;
 }
 
-struct ntv2_pixel_format
+const struct ntv2_pixel_format
 *ntv2_features_get_default_pixel_format(struct ntv2_features *features,
 										int channel_index)
 {
@@ -286,7 +285,7 @@ struct ntv2_pixel_format
 	return features->pixel_formats[0];
 }
 
-struct ntv2_video_format
+const struct ntv2_video_format
 *ntv2_features_get_video_format(struct ntv2_features *features,
 								int channel_index,
 								int format_index)
@@ -317,7 +316,7 @@ int ntv2_features_num_video_formats(struct ntv2_features *features,
 	return num;
 }
 
-struct ntv2_video_format
+const struct ntv2_video_format
 *ntv2_features_get_default_video_format(struct ntv2_features *features,
 										int channel_index)
 {
@@ -328,7 +327,60 @@ struct ntv2_video_format
 	return features->video_formats[0];
 }
 
-struct ntv2_source_config
+const struct ntv2_video_format
+*ntv2_features_find_video_format(struct ntv2_features *features,
+								 int channel_index,
+								 u32 video_standard,
+								 u32 frame_rate,
+								 u32 frame_flags)
+{
+	const struct ntv2_video_format *vidf;
+	u32 rate_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g |
+		ntv2_kona_frame_6g | ntv2_kona_frame_12g;
+	int i;
+
+	if ((features == NULL) ||
+		(channel_index < 0) || (channel_index >= NTV2_MAX_CHANNELS) ||
+		(video_standard >= NTV2_MAX_VIDEO_STANDARDS) ||
+		(frame_rate >= NTV2_MAX_FRAME_RATES))
+		return NULL;
+
+	/* formats sharing a standard and rate differ by sdi data rate (1080p vs 2160p) */
+	i = features->video_format_index[video_standard][frame_rate];
+	while (i != 0) {
+		vidf = features->video_formats[i - 1];
+		if ((vidf->frame_flags & rate_flags) == (frame_flags & rate_flags))
+			return vidf;
+		i = features->video_format_chain[i - 1];
+	}
+
+	return NULL;
+}
+
+const struct ntv2_video_format
+*ntv2_features_find_timings_format(struct ntv2_features *features,
+								   int channel_index,
+								   const struct v4l2_dv_timings *t,
+								   bool drop_frame)
+{
+	const struct ntv2_video_format *vidf;
+	u32 slot;
+
+	if ((features == NULL) ||
+		(channel_index < 0) || (channel_index >= NTV2_MAX_CHANNELS) ||
+		(t == NULL))
+		return NULL;
+
+	slot = ntv2_features_timings_hash(t);
+	while ((vidf = ntv2_features_next_timings(features, t, 0, &slot)) != NULL) {
+		if (drop_frame == ntv2_frame_rate_drop(vidf->frame_rate))
+			return vidf;
+	}
+
+	return NULL;
+}
+
+const struct ntv2_source_config
 *ntv2_features_find_source_config(struct ntv2_features *features,
 								  int channel_index,
 								  enum ntv2_input_type input_type,
@@ -351,7 +403,7 @@ struct ntv2_source_config
 	return NULL;
 }
 
-struct ntv2_widget_config
+const struct ntv2_widget_config
 *ntv2_features_find_csc_config(struct ntv2_features *features,
 							   int channel_index, int num_cscs)
 {
@@ -371,9 +423,9 @@ struct ntv2_widget_config
 	return NULL;
 }
 
-void ntv2_features_gen_input_format(struct ntv2_input_config *config,
-									struct ntv2_video_format *vidf,
-									struct ntv2_pixel_format *pixf,
+void ntv2_features_gen_input_format(const struct ntv2_input_config *config,
+									const struct ntv2_video_format *vidf,
+									const struct ntv2_pixel_format *pixf,
 									struct ntv2_input_format *inpf)
 {
 
@@ -395,7 +447,7 @@ void ntv2_features_gen_input_format(struct ntv2_input_config *config,
 	return;
 }
 
-void ntv2_features_gen_source_format(struct ntv2_source_config *config,
+void ntv2_features_gen_source_format(const struct ntv2_source_config *config,
 									 struct ntv2_source_format *souf)
 {
 	if ((config == NULL) ||
@@ -410,7 +462,17 @@ void ntv2_features_gen_source_format(struct ntv2_source_config *config,
 	return;
 }
 
-u32 ntv2_features_line_pitch(struct ntv2_pixel_format *format, u32 pixels)
+u32 ntv2_features_line_bytes(const struct ntv2_pixel_format *format, u32 pixels)
+{
+	if ((format == NULL) ||
+		(format->cadence_pixels == 0))
+		return 0;
+
+	/* whole pixel cadences without the pitch alignment */
+	return (pixels + format->cadence_pixels - 1) / format->cadence_pixels * format->cadence_bytes;
+}
+
+u32 ntv2_features_line_pitch(const struct ntv2_pixel_format *format, u32 pixels)
 {
 	u32 width;
 	u32 pitch;
@@ -420,14 +482,51 @@ u32 ntv2_features_line_pitch(struct ntv2_pixel_format *format, u32 pixels)
 		(format->pitch_alignment == 0))
 		return 0;
 
-	width = (pixels + format->cadence_pixels - 1) / format->cadence_pixels * format->cadence_bytes;
+	width = ntv2_features_line_bytes(format, pixels);
 	pitch = (width + format->pitch_alignment - 1) / format->pitch_alignment * format->pitch_alignment;
 
 	return pitch;
 }
 
-u32 ntv2_features_ntv2_frame_size(struct ntv2_video_format *vidf,
-								  struct ntv2_pixel_format *pixf)
+u32 ntv2_features_frame_lines(const struct ntv2_pixel_format *format, u32 lines)
+{
+	if (format == NULL)
+		return 0;
+
+	/* semi-planar chroma follows the luma plane */
+	if ((format->num_planes > 1) && (format->plane_line_divisor != 0))
+		return lines + lines / format->plane_line_divisor;
+
+	return lines;
+}
+
+u32 ntv2_features_buffer_planes(const struct ntv2_pixel_format *format)
+{
+	if ((format == NULL) || (format->buffer_planes == 0))
+		return 1;
+
+	return format->buffer_planes;
+}
+
+u32 ntv2_features_plane_lines(const struct ntv2_pixel_format *format, u32 plane, u32 lines)
+{
+	if (format == NULL)
+		return 0;
+
+	/* contiguous planes share one buffer */
+	if (ntv2_features_buffer_planes(format) == 1)
+		return (plane == 0)? ntv2_features_frame_lines(format, lines) : 0;
+
+	if (plane == 0)
+		return lines;
+	if ((plane == 1) && (format->plane_line_divisor != 0))
+		return lines / format->plane_line_divisor;
+
+	return 0;
+}
+
+u32 ntv2_features_ntv2_frame_size(const struct ntv2_video_format *vidf,
+								  const struct ntv2_pixel_format *pixf)
 {
 	u32 pitch;
 
@@ -436,11 +535,11 @@ u32 ntv2_features_ntv2_frame_size(struct ntv2_video_format *vidf,
 		return 0;
 
 	pitch = ntv2_features_line_pitch(pixf, ntv2_frame_geometry_width(vidf->frame_geometry));
-	return pitch * ntv2_frame_geometry_height(vidf->frame_geometry);
+	return pitch * ntv2_features_frame_lines(pixf, ntv2_frame_geometry_height(vidf->frame_geometry));
 }
 
-u32 ntv2_features_v4l2_frame_size(struct ntv2_video_format *vidf,
-								  struct ntv2_pixel_format *pixf)
+u32 ntv2_features_v4l2_frame_size(const struct ntv2_video_format *vidf,
+								  const struct ntv2_pixel_format *pixf)
 {
 	u32 pitch;
 
@@ -449,12 +548,12 @@ u32 ntv2_features_v4l2_frame_size(struct ntv2_video_format *vidf,
 		return 0;
 
 	pitch = ntv2_features_line_pitch(pixf, vidf->v4l2_timings.bt.width);
-	return pitch * vidf->v4l2_timings.bt.height;
+	return pitch * ntv2_features_frame_lines(pixf, vidf->v4l2_timings.bt.height);
 }
 
 int ntv2_features_get_frame_range(struct ntv2_features *features,
-								  struct ntv2_video_format *vidf,
-								  struct ntv2_pixel_format *pixf,
+								  const struct ntv2_video_format *vidf,
+								  const struct ntv2_pixel_format *pixf,
 								  int index,
 								  u32 *first,
 								  u32 *last,
@@ -671,7 +770,8 @@ bool ntv2_features_find_dv_timings_cap(struct ntv2_features *features,
 									   const struct v4l2_dv_timings_cap *cap,
 									   unsigned pclock_delta)
 {
-	int i;
+	const struct ntv2_video_format *vidf;
+	u32 slot;
 
 	if (features == NULL)
 		return false;
@@ -679,12 +779,10 @@ bool ntv2_features_find_dv_timings_cap(struct ntv2_features *features,
 	if (!ntv2_features_valid_dv_timings(features, t, cap))
 		return false;
 
-	for (i = 0; NTV2_MAX_VIDEO_FORMATS; i++) {
-		if (features->v4l2_timings[i] == NULL)
-			break;
-		if (ntv2_features_valid_dv_timings(features, features->v4l2_timings[i], cap) &&
-		    ntv2_features_match_dv_timings(t, features->v4l2_timings[i], pclock_delta)) {
-			*t = *features->v4l2_timings[i];
+	slot = ntv2_features_timings_hash(t);
+	while ((vidf = ntv2_features_next_timings(features, t, pclock_delta, &slot)) != NULL) {
+		if (ntv2_features_valid_dv_timings(features, &vidf->v4l2_timings, cap)) {
+			*t = vidf->v4l2_timings;
 			return true;
 		}
 	}
@@ -715,6 +813,41 @@ bool ntv2_features_match_dv_timings(const struct v4l2_dv_timings *t1,
 	return false;
 }
 
+static u32 ntv2_features_timings_hash(const struct v4l2_dv_timings *t)
+{
+	const struct v4l2_bt_timings *bt = &t->bt;
+	u32 key[5];
+
+	/* hash only the fields that must match exactly (not the pixel clock) */
+	key[0] = bt->width | (bt->height << 16);
+	key[1] = bt->interlaced | (bt->polarities << 8);
+	key[2] = bt->hfrontporch;
+	key[3] = bt->vfrontporch | (bt->vsync << 16);
+	key[4] = bt->vbackporch;
+
+	return jhash2(key, ARRAY_SIZE(key), 0) & (NTV2_TIMINGS_HASH_SIZE - 1);
+}
+
+static const struct ntv2_video_format
+*ntv2_features_next_timings(struct ntv2_features *features,
+							const struct v4l2_dv_timings *t,
+							unsigned pclock_delta,
+							u32 *slot)
+{
+	const struct ntv2_video_format *vidf;
+	u8 entry;
+
+	/* walk the probe chain in video format order */
+	while ((entry = features->v4l2_timings_hash[*slot]) != 0) {
+		*slot = (*slot + 1) & (NTV2_TIMINGS_HASH_SIZE - 1);
+		vidf = features->video_formats[entry - 1];
+		if (ntv2_features_match_dv_timings(t, &vidf->v4l2_timings, pclock_delta))
+			return vidf;
+	}
+
+	return NULL;
+}
+
 int ntv2_features_req_line_interleave_channels(struct ntv2_features *features)
 {
 	if (features == NULL)
@@ -876,1045 +1009,989 @@ static const struct v4l2_dv_timings_cap ntv2_timings_cap_hdmi20 = {
 	)
 };
 
-static struct v4l2_dv_timings		dvt_720x480i5994 = V4L2_DV_BT_CEA_720X480I59_94;
-static struct v4l2_dv_timings		dvt_720x576i50 = V4L2_DV_BT_CEA_720X576I50;
-static struct v4l2_dv_timings		dvt_1280x720p50 = V4L2_DV_BT_CEA_1280X720P50;
-static struct v4l2_dv_timings		dvt_1280x720p60 = V4L2_DV_BT_CEA_1280X720P60;
-static struct v4l2_dv_timings		dvt_1920x1080i50 = V4L2_DV_BT_CEA_1920X1080I50;
-static struct v4l2_dv_timings		dvt_1920x1080i60 = V4L2_DV_BT_CEA_1920X1080I60;
-static struct v4l2_dv_timings		dvt_1920x1080p24 = V4L2_DV_BT_CEA_1920X1080P24;
-static struct v4l2_dv_timings		dvt_1920x1080p25 = V4L2_DV_BT_CEA_1920X1080P25;
-static struct v4l2_dv_timings		dvt_1920x1080p30 = V4L2_DV_BT_CEA_1920X1080P30;
-static struct v4l2_dv_timings		dvt_1920x1080p50 = V4L2_DV_BT_CEA_1920X1080P50;
-static struct v4l2_dv_timings		dvt_1920x1080p60 = V4L2_DV_BT_CEA_1920X1080P60;
-static struct v4l2_dv_timings		dvt_3840x2160p24 = V4L2_DV_BT_CEA_3840X2160P24;
-static struct v4l2_dv_timings		dvt_3840x2160p25 = V4L2_DV_BT_CEA_3840X2160P25;
-static struct v4l2_dv_timings		dvt_3840x2160p30 = V4L2_DV_BT_CEA_3840X2160P30;
-static struct v4l2_dv_timings		dvt_3840x2160p50 = V4L2_DV_BT_CEA_3840X2160P50;
-static struct v4l2_dv_timings		dvt_3840x2160p60 = V4L2_DV_BT_CEA_3840X2160P60;
-
-static struct ntv2_video_config		nvc_capture;
-static struct ntv2_video_config		nvc_playback;
-static struct ntv2_video_config		nvc_both;
-static struct ntv2_audio_config		nac_capture;
-static struct ntv2_audio_config		nac_playback;
-static struct ntv2_audio_config		nac_both;
-static struct ntv2_serial_config	nsc_uartlite;
-
-static struct ntv2_input_config		nic_sdi_single_1;
-static struct ntv2_input_config		nic_sdi_single_2;
-static struct ntv2_input_config		nic_sdi_single_3;
-static struct ntv2_input_config		nic_sdi_single_4;
-static struct ntv2_input_config		nic_sdi_single_5;
-static struct ntv2_input_config		nic_sdi_single_6;
-static struct ntv2_input_config		nic_sdi_single_7;
-static struct ntv2_input_config		nic_sdi_single_8;
-static struct ntv2_input_config		nic_sdi_dual_12;
-static struct ntv2_input_config		nic_sdi_dual_34;
-static struct ntv2_input_config		nic_sdi_dual_56;
-static struct ntv2_input_config		nic_sdi_dual_78;
-static struct ntv2_input_config		nic_sdi_quad_1234;
-static struct ntv2_input_config		nic_sdi_quad_5678;
-static struct ntv2_input_config		nic_hdmi_adv_14_1;
-static struct ntv2_input_config		nic_hdmi_aja_20_1;
-static struct ntv2_input_config		nic_hdmi_aja_13_2;
-static struct ntv2_input_config		nic_hdmi_aja_20_2;
-static struct ntv2_input_config		nic_hdmi_adv_13_3;
-static struct ntv2_input_config		nic_hdmi_adv_13_4;
-
-static struct ntv2_widget_config	nwc_csc_1_1;
-static struct ntv2_widget_config	nwc_csc_1_2;
-static struct ntv2_widget_config	nwc_csc_1_4;
-static struct ntv2_widget_config	nwc_csc_2_1;
-static struct ntv2_widget_config	nwc_csc_3_1;
-static struct ntv2_widget_config	nwc_csc_3_2;
-static struct ntv2_widget_config	nwc_csc_4_1;
-static struct ntv2_widget_config	nwc_csc_5_1;
-static struct ntv2_widget_config	nwc_csc_5_2;
-static struct ntv2_widget_config	nwc_csc_5_4;
-static struct ntv2_widget_config	nwc_csc_6_1;
-static struct ntv2_widget_config	nwc_csc_7_1;
-static struct ntv2_widget_config	nwc_csc_7_2;
-static struct ntv2_widget_config	nwc_csc_8_1;
-
-static struct ntv2_source_config	asc_auto;
-static struct ntv2_source_config	asc_sdi_1;
-static struct ntv2_source_config	asc_sdi_2;
-static struct ntv2_source_config	asc_sdi_3;
-static struct ntv2_source_config	asc_sdi_4;
-static struct ntv2_source_config	asc_sdi_5;
-static struct ntv2_source_config	asc_sdi_6;
-static struct ntv2_source_config	asc_sdi_7;
-static struct ntv2_source_config	asc_sdi_8;
-static struct ntv2_source_config	asc_aes;
-static struct ntv2_source_config	asc_analog;
-static struct ntv2_source_config	asc_hdmi_adv_1;
-static struct ntv2_source_config	asc_hdmi_aja_1;
-static struct ntv2_source_config	asc_hdmi_aja_2;
-static struct ntv2_source_config	asc_hdmi_adv_3;
-static struct ntv2_source_config	asc_hdmi_adv_4;
-
-static struct ntv2_video_format 	nvf_525i5994;
-static struct ntv2_video_format 	nvf_625i5000;
-static struct ntv2_video_format 	nvf_720p5000;
-static struct ntv2_video_format 	nvf_720p5994;
-static struct ntv2_video_format 	nvf_720p6000;
-static struct ntv2_video_format 	nvf_1080p2398;
-static struct ntv2_video_format 	nvf_1080p2400;
-static struct ntv2_video_format 	nvf_1080p2500;
-static struct ntv2_video_format 	nvf_1080p2997;
-static struct ntv2_video_format 	nvf_1080p3000;
-static struct ntv2_video_format 	nvf_1080p5000;
-static struct ntv2_video_format 	nvf_1080p5994;
-static struct ntv2_video_format 	nvf_1080p6000;
-static struct ntv2_video_format 	nvf_1080i5000;
-static struct ntv2_video_format 	nvf_1080i5994;
-static struct ntv2_video_format 	nvf_1080i6000;
-static struct ntv2_video_format 	nvf_2160p2398;
-static struct ntv2_video_format 	nvf_2160p2400;
-static struct ntv2_video_format 	nvf_2160p2500;
-static struct ntv2_video_format 	nvf_2160p2997;
-static struct ntv2_video_format 	nvf_2160p3000;
-static struct ntv2_video_format 	nvf_2160p5000;
-static struct ntv2_video_format 	nvf_2160p5994;
-static struct ntv2_video_format 	nvf_2160p6000;
-
-static struct ntv2_pixel_format 	npf_uyvy;
-static struct ntv2_pixel_format 	npf_yuyv;
-static struct ntv2_pixel_format 	npf_rgb;
-static struct ntv2_pixel_format 	npf_bgr;
-static struct ntv2_pixel_format 	npf_rgba;
-static struct ntv2_pixel_format 	npf_bgra;
-
-static void ntv2_features_initialize(void) {
-	struct ntv2_video_config *nvc;
-	struct ntv2_video_format *nvf;
-	struct ntv2_pixel_format *npf;
-	struct ntv2_audio_config *nac;
-	struct ntv2_input_config *nic;
-	struct ntv2_widget_config *nwc;
-	struct ntv2_source_config *nss;
-	struct ntv2_serial_config *nsc;
-
-	/* video configuration */
-	nvc = &nvc_capture;
-	memset(nvc, 0, sizeof(struct ntv2_video_config));
-	nvc->capture = true;
-	nvc->playback = false;
-
-	nvc = &nvc_playback;
-	memset(nvc, 0, sizeof(struct ntv2_video_config));
-	nvc->capture = false;
-	nvc->playback = true;
-
-	nvc = &nvc_both;
-	memset(nvc, 0, sizeof(struct ntv2_video_config));
-	nvc->capture = true;
-	nvc->playback = true;
-
-	/* audio configuration */
-	nac = &nac_capture;
-	memset(nac, 0, sizeof(struct ntv2_audio_config));
-	nac->capture = true;
-	nac->playback = false;
-	nac->sample_rate = 48000;
-	nac->num_channels = 16;
-	nac->sample_size = 4;
-	nac->ring_size = 0x3fc000;
-	nac->ring_offset_samples = 64;
-	nac->sync_tolerance = 10000;
-
-	nac = &nac_playback;
-	memset(nac, 0, sizeof(struct ntv2_audio_config));
-	nac->capture = false;
-	nac->playback = true;
-	nac->sample_rate = 48000;
-	nac->num_channels = 16;
-	nac->sample_size = 4;
-	nac->ring_size = 0x3fc000;
-	nac->ring_offset_samples = 64;
-	nac->sync_tolerance = 10000;
-
-	nac = &nac_both;
-	memset(nac, 0, sizeof(struct ntv2_audio_config));
-	nac->capture = true;
-	nac->playback = true;
-	nac->sample_rate = 48000;
-	nac->num_channels = 16;
-	nac->sample_size = 4;
-	nac->ring_size = 0x3fc000;
-	nac->ring_offset_samples = 64;
-	nac->sync_tolerance = 10000;
-
-	/* serial port configuration */
-	nsc = &nsc_uartlite;
-	nsc->type = PORT_UARTLITE;
-	nsc->fifo_size = 16;
-
-	/* sdi single link inputs */
-	nic = &nic_sdi_single_1;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 1";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_single;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g;
-	nic->reg_index = 0;
-	nic->input_index = 0;
-	nic->num_inputs = 1;
-
-	nic = &nic_sdi_single_2;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 2";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_single;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g;
-	nic->reg_index = 1;
-	nic->input_index = 1;
-	nic->num_inputs = 1;
-
-	nic = &nic_sdi_single_3;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 3";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_single;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g;
-	nic->reg_index = 2;
-	nic->input_index = 2;
-	nic->num_inputs = 1;
-
-	nic = &nic_sdi_single_4;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 4";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_single;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g;
-	nic->reg_index = 3;
-	nic->input_index = 3;
-	nic->num_inputs = 1;
-
-	nic = &nic_sdi_single_5;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 5";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_single;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g;
-	nic->reg_index = 4;
-	nic->input_index = 4;
-	nic->num_inputs = 1;
-
-	nic = &nic_sdi_single_6;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 6";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_single;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g;
-	nic->reg_index = 5;
-	nic->input_index = 5;
-	nic->num_inputs = 1;
-
-	nic = &nic_sdi_single_7;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 7";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_single;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g;
-	nic->reg_index = 6;
-	nic->input_index = 6;
-	nic->num_inputs = 1;
-
-	nic = &nic_sdi_single_8;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 8";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_single;
-	nic->reg_index = 7;
-	nic->input_index = 7;
-	nic->num_inputs = 1;
-
-	/* sdi dual link inputs */
-	nic = &nic_sdi_dual_12;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 1-2";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_dual;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | 
-		ntv2_kona_frame_3g | ntv2_kona_frame_6g; 
-	nic->reg_index = 0;
-	nic->input_index = 0;
-	nic->num_inputs = 2;
-
-	nic = &nic_sdi_dual_34;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 3-4";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_dual;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | 
-		ntv2_kona_frame_3g | ntv2_kona_frame_6g; 
-	nic->reg_index = 2;
-	nic->input_index = 2;
-	nic->num_inputs = 2;
-
-	nic = &nic_sdi_dual_56;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 5-6";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_dual;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | 
-		ntv2_kona_frame_3g | ntv2_kona_frame_6g; 
-	nic->reg_index = 4;
-	nic->input_index = 4;
-	nic->num_inputs = 2;
-
-	nic = &nic_sdi_dual_78;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 7-8";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_dual;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | 
-		ntv2_kona_frame_3g | ntv2_kona_frame_6g; 
-	nic->reg_index = 6;
-	nic->input_index = 6;
-	nic->num_inputs = 2;
-
-	/* sdi quad link inputs */
-	nic = &nic_sdi_quad_1234;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 1-4";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_quad;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | 
-		ntv2_kona_frame_3g | ntv2_kona_frame_6g | ntv2_kona_frame_12g; 
-	nic->reg_index = 0;
-	nic->input_index = 0;
-	nic->num_inputs = 4;
-
-	nic = &nic_sdi_quad_5678;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "SDI 5-8";
-	nic->type = ntv2_input_type_sdi;
-	nic->v4l2_timings_cap = ntv2_timings_cap_sdi_quad;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | 
-		ntv2_kona_frame_3g | ntv2_kona_frame_6g | ntv2_kona_frame_12g; 
-	nic->reg_index = 4;
-	nic->input_index = 4;
-	nic->num_inputs = 4;
-
-	/* hdmi inputs */
-	nic = &nic_hdmi_adv_14_1;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "HDMI 1";
-	nic->type = ntv2_input_type_hdmi_adv;
-	nic->v4l2_timings_cap = ntv2_timings_cap_hdmi14;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | 
-		ntv2_kona_frame_3g | ntv2_kona_frame_6g; 
-	nic->reg_index = 0;
-	nic->input_index = 0;
-	nic->num_inputs = 1;
-
-	nic = &nic_hdmi_aja_20_1;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "HDMI 1";
-	nic->type = ntv2_input_type_hdmi_aja;
-	nic->v4l2_timings_cap = ntv2_timings_cap_hdmi20;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | 
-		ntv2_kona_frame_3g | ntv2_kona_frame_6g | ntv2_kona_frame_12g; 
-	nic->reg_index = 1;
-	nic->input_index = 0;
-	nic->num_inputs = 1;
-
-	nic = &nic_hdmi_aja_13_2;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "HDMI 2";
-	nic->type = ntv2_input_type_hdmi_aja;
-	nic->v4l2_timings_cap = ntv2_timings_cap_hdmi13;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g;
-	nic->reg_index = 2;
-	nic->input_index = 1;
-	nic->num_inputs = 1;
-
-	nic = &nic_hdmi_aja_20_2;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "HDMI 2";
-	nic->type = ntv2_input_type_hdmi_aja;
-	nic->v4l2_timings_cap = ntv2_timings_cap_hdmi20;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | 
-		ntv2_kona_frame_3g | ntv2_kona_frame_6g | ntv2_kona_frame_12g; 
-	nic->reg_index = 2;
-	nic->input_index = 1;
-	nic->num_inputs = 1;
-
-	nic = &nic_hdmi_adv_13_3;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "HDMI 3";
-	nic->type = ntv2_input_type_hdmi_adv;
-	nic->v4l2_timings_cap = ntv2_timings_cap_hdmi13;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g;
-	nic->reg_index = 1;
-	nic->input_index = 2;
-	nic->num_inputs = 1;
-
-	nic = &nic_hdmi_adv_13_4;
-	memset(nic, 0, sizeof(struct ntv2_input_config));
-	nic->name = "HDMI 4";
-	nic->type = ntv2_input_type_hdmi_adv;
-	nic->v4l2_timings_cap = ntv2_timings_cap_hdmi13;
-	nic->frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g;
-	nic->reg_index = 2;
-	nic->input_index = 3;
-	nic->num_inputs = 1;
-
-	/* csc converters */
-	nwc = &nwc_csc_1_1;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 1";
-	nwc->widget_index = 0;
-	nwc->num_widgets = 1;
-
-	nwc = &nwc_csc_1_2;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 1-2";
-	nwc->widget_index = 0;
-	nwc->num_widgets = 2;
-
-	nwc = &nwc_csc_1_4;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 1-4";
-	nwc->widget_index = 0;
-	nwc->num_widgets = 4;
-	
-	nwc = &nwc_csc_2_1;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 2";
-	nwc->widget_index = 1;
-	nwc->num_widgets = 1;
-
-	nwc = &nwc_csc_3_1;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 3";
-	nwc->widget_index = 2;
-	nwc->num_widgets = 1;
-
-	nwc = &nwc_csc_3_2;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 3-4";
-	nwc->widget_index = 2;
-	nwc->num_widgets = 2;
-
-	nwc = &nwc_csc_4_1;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 4";
-	nwc->widget_index = 3;
-	nwc->num_widgets = 1;
-
-	nwc = &nwc_csc_5_1;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 5";
-	nwc->widget_index = 4;
-	nwc->num_widgets = 1;
-
-	nwc = &nwc_csc_5_2;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 5-6";
-	nwc->widget_index = 4;
-	nwc->num_widgets = 2;
-
-	nwc = &nwc_csc_5_4;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 5-8";
-	nwc->widget_index = 4;
-	nwc->num_widgets = 4;
-
-	nwc = &nwc_csc_6_1;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 6";
-	nwc->widget_index = 5;
-	nwc->num_widgets = 1;
-
-	nwc = &nwc_csc_7_1;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 7";
-	nwc->widget_index = 6;
-	nwc->num_widgets = 1;
-
-	nwc = &nwc_csc_7_2;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 7-8";
-	nwc->widget_index = 6;
-	nwc->num_widgets = 2;
-
-	nwc = &nwc_csc_8_1;
-	memset(nwc, 0, sizeof(struct ntv2_widget_config));
-	nwc->name = "CSC 8";
-	nwc->widget_index = 7;
-	nwc->num_widgets = 1;
-
-	/* audio auto source */
-	nss = &asc_auto;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "Auto";
-	nss->type = ntv2_input_type_auto;
-	nss->audio_source = 0;
-	nss->num_channels = 0;
-	nss->reg_index = 0;
-	nss->input_index = 0;
-	nss->num_inputs = 0;
-
-	/* audio aes source */
-	nss = &asc_aes;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "AES";
-	nss->type = ntv2_input_type_aes;
-	nss->audio_source = ntv2_kona_audio_source_aes;
-	nss->num_channels = 16;
-	nss->reg_index = 0;
-	nss->input_index = 0;
-	nss->num_inputs = 1;
-
-	/* audio sdi source */
-	nss = &asc_sdi_1;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "SDI 1";
-	nss->type = ntv2_input_type_sdi;
-	nss->audio_source = ntv2_kona_audio_source_embedded;
-	nss->num_channels = 16;
-	nss->reg_index = 0;
-	nss->input_index = 0;
-	nss->num_inputs = 1;
-
-	nss = &asc_sdi_2;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "SDI 2";
-	nss->type = ntv2_input_type_sdi;
-	nss->audio_source = ntv2_kona_audio_source_embedded;
-	nss->num_channels = 16;
-	nss->reg_index = 1;
-	nss->input_index = 1;
-	nss->num_inputs = 1;
-
-	nss = &asc_sdi_3;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "SDI 3";
-	nss->type = ntv2_input_type_sdi;
-	nss->audio_source = ntv2_kona_audio_source_embedded;
-	nss->num_channels = 16;
-	nss->reg_index = 2;
-	nss->input_index = 2;
-	nss->num_inputs = 1;
-
-	nss = &asc_sdi_4;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "SDI 4";
-	nss->type = ntv2_input_type_sdi;
-	nss->audio_source = ntv2_kona_audio_source_embedded;
-	nss->num_channels = 16;
-	nss->reg_index = 3;
-	nss->input_index = 3;
-	nss->num_inputs = 1;
-
-	nss = &asc_sdi_5;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "SDI 5";
-	nss->type = ntv2_input_type_sdi;
-	nss->audio_source = ntv2_kona_audio_source_embedded;
-	nss->num_channels = 16;
-	nss->reg_index = 4;
-	nss->input_index = 4;
-	nss->num_inputs = 1;
-
-	nss = &asc_sdi_6;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "SDI 6";
-	nss->type = ntv2_input_type_sdi;
-	nss->audio_source = ntv2_kona_audio_source_embedded;
-	nss->num_channels = 16;
-	nss->reg_index = 5;
-	nss->input_index = 5;
-	nss->num_inputs = 1;
-
-	nss = &asc_sdi_7;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "SDI 7";
-	nss->type = ntv2_input_type_sdi;
-	nss->audio_source = ntv2_kona_audio_source_embedded;
-	nss->num_channels = 16;
-	nss->reg_index = 6;
-	nss->input_index = 6;
-	nss->num_inputs = 1;
-
-	nss = &asc_sdi_8;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "SDI 8";
-	nss->type = ntv2_input_type_sdi;
-	nss->audio_source = ntv2_kona_audio_source_embedded;
-	nss->num_channels = 16;
-	nss->reg_index = 7;
-	nss->input_index = 7;
-	nss->num_inputs = 1;
-
-	/* audio analog source */
-	nss = &asc_analog;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "Analog";
-	nss->type = ntv2_input_type_analog;
-	nss->audio_source = ntv2_kona_audio_source_analog;
-	nss->num_channels = 2;
-	nss->reg_index = 0;
-	nss->input_index = 0;
-	nss->num_inputs = 1;
-
-	/* audio hdmi source */
-	nss = &asc_hdmi_adv_1;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "HDMI 1";
-	nss->type = ntv2_input_type_hdmi_adv;
-	nss->audio_source = ntv2_kona_audio_source_hdmi;
-	nss->num_channels = 8;
-	nss->reg_index = 0;
-	nss->input_index = 0;
-	nss->num_inputs = 1;
-
-	nss = &asc_hdmi_aja_1;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "HDMI 1";
-	nss->type = ntv2_input_type_hdmi_aja;
-	nss->audio_source = ntv2_kona_audio_source_hdmi;
-	nss->num_channels = 8;
-	nss->reg_index = 0;
-	nss->input_index = 0;
-	nss->num_inputs = 1;
-
-	nss = &asc_hdmi_aja_2;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "HDMI 2";
-	nss->type = ntv2_input_type_hdmi_aja;
-	nss->audio_source = ntv2_kona_audio_source_hdmi;
-	nss->num_channels = 8;
-	nss->reg_index = 1;
-	nss->input_index = 1;
-	nss->num_inputs = 1;
-
-	nss = &asc_hdmi_adv_3;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "HDMI 3";
-	nss->type = ntv2_input_type_hdmi_adv;
-	nss->audio_source = ntv2_kona_audio_source_hdmi;
-	nss->num_channels = 8;
-	nss->reg_index = 0;
-	nss->input_index = 2;
-	nss->num_inputs = 1;
-
-	nss = &asc_hdmi_adv_4;
-	memset(nss, 0, sizeof(struct ntv2_source_config));
-	nss->name = "HDMI 4";
-	nss->type = ntv2_input_type_hdmi_adv;
-	nss->audio_source = ntv2_kona_audio_source_hdmi;
-	nss->num_channels = 8;
-	nss->reg_index = 1;
-	nss->input_index = 3;
-	nss->num_inputs = 1;
-
-	/* 525i5994 timing */
-	nvf = &nvf_525i5994;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "525i5994";
-	nvf->v4l2_timings = dvt_720x480i5994;
-	nvf->video_standard = ntv2_kona_video_standard_525i;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_720x486;
-	nvf->frame_rate = ntv2_kona_frame_rate_2997;
-	nvf->frame_flags =
+/* video configuration */
+static const struct ntv2_video_config nvc_capture = {
+	.capture = true,
+	.playback = false,
+};
+
+static const struct ntv2_video_config nvc_playback = {
+	.capture = false,
+	.playback = true,
+};
+
+static const struct ntv2_video_config nvc_both = {
+	.capture = true,
+	.playback = true,
+};
+
+/* audio configuration */
+static const struct ntv2_audio_config nac_capture = {
+	.capture = true,
+	.playback = false,
+	.sample_rate = 48000,
+	.num_channels = 16,
+	.sample_size = 4,
+	.ring_size = 0x3fc000,
+	.ring_offset_samples = 64,
+	.sync_tolerance = 10000,
+};
+
+static const struct ntv2_audio_config nac_playback = {
+	.capture = false,
+	.playback = true,
+	.sample_rate = 48000,
+	.num_channels = 16,
+	.sample_size = 4,
+	.ring_size = 0x3fc000,
+	.ring_offset_samples = 64,
+	.sync_tolerance = 10000,
+};
+
+static const struct ntv2_audio_config nac_both = {
+	.capture = true,
+	.playback = true,
+	.sample_rate = 48000,
+	.num_channels = 16,
+	.sample_size = 4,
+	.ring_size = 0x3fc000,
+	.ring_offset_samples = 64,
+	.sync_tolerance = 10000,
+};
+
+/* serial port configuration */
+static const struct ntv2_serial_config nsc_uartlite = {
+	.type = PORT_UARTLITE,
+	.fifo_size = 16,
+};
+
+/* sdi single link inputs */
+static const struct ntv2_input_config nic_sdi_single_1 = {
+	.name = "SDI 1",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_single,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g,
+	.reg_index = 0,
+	.input_index = 0,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_sdi_single_2 = {
+	.name = "SDI 2",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_single,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g,
+	.reg_index = 1,
+	.input_index = 1,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_sdi_single_3 = {
+	.name = "SDI 3",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_single,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g,
+	.reg_index = 2,
+	.input_index = 2,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_sdi_single_4 = {
+	.name = "SDI 4",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_single,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g,
+	.reg_index = 3,
+	.input_index = 3,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_sdi_single_5 = {
+	.name = "SDI 5",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_single,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g,
+	.reg_index = 4,
+	.input_index = 4,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_sdi_single_6 = {
+	.name = "SDI 6",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_single,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g,
+	.reg_index = 5,
+	.input_index = 5,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_sdi_single_7 = {
+	.name = "SDI 7",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_single,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g,
+	.reg_index = 6,
+	.input_index = 6,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_sdi_single_8 = {
+	.name = "SDI 8",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_single,
+	.reg_index = 7,
+	.input_index = 7,
+	.num_inputs = 1,
+};
+
+/* sdi dual link inputs */
+static const struct ntv2_input_config nic_sdi_dual_12 = {
+	.name = "SDI 1-2",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_dual,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd |
+		ntv2_kona_frame_3g | ntv2_kona_frame_6g,
+	.reg_index = 0,
+	.input_index = 0,
+	.num_inputs = 2,
+};
+
+static const struct ntv2_input_config nic_sdi_dual_34 = {
+	.name = "SDI 3-4",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_dual,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd |
+		ntv2_kona_frame_3g | ntv2_kona_frame_6g,
+	.reg_index = 2,
+	.input_index = 2,
+	.num_inputs = 2,
+};
+
+static const struct ntv2_input_config nic_sdi_dual_56 = {
+	.name = "SDI 5-6",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_dual,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd |
+		ntv2_kona_frame_3g | ntv2_kona_frame_6g,
+	.reg_index = 4,
+	.input_index = 4,
+	.num_inputs = 2,
+};
+
+static const struct ntv2_input_config nic_sdi_dual_78 = {
+	.name = "SDI 7-8",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_dual,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd |
+		ntv2_kona_frame_3g | ntv2_kona_frame_6g,
+	.reg_index = 6,
+	.input_index = 6,
+	.num_inputs = 2,
+};
+
+/* sdi quad link inputs */
+static const struct ntv2_input_config nic_sdi_quad_1234 = {
+	.name = "SDI 1-4",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_quad,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd |
+		ntv2_kona_frame_3g | ntv2_kona_frame_6g | ntv2_kona_frame_12g,
+	.reg_index = 0,
+	.input_index = 0,
+	.num_inputs = 4,
+};
+
+static const struct ntv2_input_config nic_sdi_quad_5678 = {
+	.name = "SDI 5-8",
+	.type = ntv2_input_type_sdi,
+	.v4l2_timings_cap = &ntv2_timings_cap_sdi_quad,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd |
+		ntv2_kona_frame_3g | ntv2_kona_frame_6g | ntv2_kona_frame_12g,
+	.reg_index = 4,
+	.input_index = 4,
+	.num_inputs = 4,
+};
+
+/* hdmi inputs */
+static const struct ntv2_input_config nic_hdmi_adv_14_1 = {
+	.name = "HDMI 1",
+	.type = ntv2_input_type_hdmi_adv,
+	.v4l2_timings_cap = &ntv2_timings_cap_hdmi14,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd |
+		ntv2_kona_frame_3g | ntv2_kona_frame_6g,
+	.reg_index = 0,
+	.input_index = 0,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_hdmi_aja_20_1 = {
+	.name = "HDMI 1",
+	.type = ntv2_input_type_hdmi_aja,
+	.v4l2_timings_cap = &ntv2_timings_cap_hdmi20,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd |
+		ntv2_kona_frame_3g | ntv2_kona_frame_6g | ntv2_kona_frame_12g,
+	.reg_index = 1,
+	.input_index = 0,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_hdmi_aja_13_2 = {
+	.name = "HDMI 2",
+	.type = ntv2_input_type_hdmi_aja,
+	.v4l2_timings_cap = &ntv2_timings_cap_hdmi13,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g,
+	.reg_index = 2,
+	.input_index = 1,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_hdmi_aja_20_2 = {
+	.name = "HDMI 2",
+	.type = ntv2_input_type_hdmi_aja,
+	.v4l2_timings_cap = &ntv2_timings_cap_hdmi20,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd |
+		ntv2_kona_frame_3g | ntv2_kona_frame_6g | ntv2_kona_frame_12g,
+	.reg_index = 2,
+	.input_index = 1,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_hdmi_adv_13_3 = {
+	.name = "HDMI 3",
+	.type = ntv2_input_type_hdmi_adv,
+	.v4l2_timings_cap = &ntv2_timings_cap_hdmi13,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g,
+	.reg_index = 1,
+	.input_index = 2,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_input_config nic_hdmi_adv_13_4 = {
+	.name = "HDMI 4",
+	.type = ntv2_input_type_hdmi_adv,
+	.v4l2_timings_cap = &ntv2_timings_cap_hdmi13,
+	.frame_flags = ntv2_kona_frame_sd | ntv2_kona_frame_hd | ntv2_kona_frame_3g,
+	.reg_index = 2,
+	.input_index = 3,
+	.num_inputs = 1,
+};
+
+/* csc converters */
+static const struct ntv2_widget_config nwc_csc_1_1 = {
+	.name = "CSC 1",
+	.widget_index = 0,
+	.num_widgets = 1,
+};
+
+static const struct ntv2_widget_config nwc_csc_1_2 = {
+	.name = "CSC 1-2",
+	.widget_index = 0,
+	.num_widgets = 2,
+};
+
+static const struct ntv2_widget_config nwc_csc_1_4 = {
+	.name = "CSC 1-4",
+	.widget_index = 0,
+	.num_widgets = 4,
+};
+
+static const struct ntv2_widget_config nwc_csc_2_1 = {
+	.name = "CSC 2",
+	.widget_index = 1,
+	.num_widgets = 1,
+};
+
+static const struct ntv2_widget_config nwc_csc_3_1 = {
+	.name = "CSC 3",
+	.widget_index = 2,
+	.num_widgets = 1,
+};
+
+static const struct ntv2_widget_config nwc_csc_3_2 = {
+	.name = "CSC 3-4",
+	.widget_index = 2,
+	.num_widgets = 2,
+};
+
+static const struct ntv2_widget_config nwc_csc_4_1 = {
+	.name = "CSC 4",
+	.widget_index = 3,
+	.num_widgets = 1,
+};
+
+static const struct ntv2_widget_config nwc_csc_5_1 = {
+	.name = "CSC 5",
+	.widget_index = 4,
+	.num_widgets = 1,
+};
+
+static const struct ntv2_widget_config nwc_csc_5_2 = {
+	.name = "CSC 5-6",
+	.widget_index = 4,
+	.num_widgets = 2,
+};
+
+static const struct ntv2_widget_config nwc_csc_5_4 = {
+	.name = "CSC 5-8",
+	.widget_index = 4,
+	.num_widgets = 4,
+};
+
+static const struct ntv2_widget_config nwc_csc_6_1 = {
+	.name = "CSC 6",
+	.widget_index = 5,
+	.num_widgets = 1,
+};
+
+static const struct ntv2_widget_config nwc_csc_7_1 = {
+	.name = "CSC 7",
+	.widget_index = 6,
+	.num_widgets = 1,
+};
+
+static const struct ntv2_widget_config nwc_csc_7_2 = {
+	.name = "CSC 7-8",
+	.widget_index = 6,
+	.num_widgets = 2,
+};
+
+static const struct ntv2_widget_config nwc_csc_8_1 = {
+	.name = "CSC 8",
+	.widget_index = 7,
+	.num_widgets = 1,
+};
+
+/* audio auto source */
+static const struct ntv2_source_config asc_auto = {
+	.name = "Auto",
+	.type = ntv2_input_type_auto,
+	.audio_source = 0,
+	.num_channels = 0,
+	.reg_index = 0,
+	.input_index = 0,
+	.num_inputs = 0,
+};
+
+/* audio aes source */
+static const struct ntv2_source_config asc_aes = {
+	.name = "AES",
+	.type = ntv2_input_type_aes,
+	.audio_source = ntv2_kona_audio_source_aes,
+	.num_channels = 16,
+	.reg_index = 0,
+	.input_index = 0,
+	.num_inputs = 1,
+};
+
+/* audio sdi source */
+static const struct ntv2_source_config asc_sdi_1 = {
+	.name = "SDI 1",
+	.type = ntv2_input_type_sdi,
+	.audio_source = ntv2_kona_audio_source_embedded,
+	.num_channels = 16,
+	.reg_index = 0,
+	.input_index = 0,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_source_config asc_sdi_2 = {
+	.name = "SDI 2",
+	.type = ntv2_input_type_sdi,
+	.audio_source = ntv2_kona_audio_source_embedded,
+	.num_channels = 16,
+	.reg_index = 1,
+	.input_index = 1,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_source_config asc_sdi_3 = {
+	.name = "SDI 3",
+	.type = ntv2_input_type_sdi,
+	.audio_source = ntv2_kona_audio_source_embedded,
+	.num_channels = 16,
+	.reg_index = 2,
+	.input_index = 2,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_source_config asc_sdi_4 = {
+	.name = "SDI 4",
+	.type = ntv2_input_type_sdi,
+	.audio_source = ntv2_kona_audio_source_embedded,
+	.num_channels = 16,
+	.reg_index = 3,
+	.input_index = 3,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_source_config asc_sdi_5 = {
+	.name = "SDI 5",
+	.type = ntv2_input_type_sdi,
+	.audio_source = ntv2_kona_audio_source_embedded,
+	.num_channels = 16,
+	.reg_index = 4,
+	.input_index = 4,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_source_config asc_sdi_6 = {
+	.name = "SDI 6",
+	.type = ntv2_input_type_sdi,
+	.audio_source = ntv2_kona_audio_source_embedded,
+	.num_channels = 16,
+	.reg_index = 5,
+	.input_index = 5,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_source_config asc_sdi_7 = {
+	.name = "SDI 7",
+	.type = ntv2_input_type_sdi,
+	.audio_source = ntv2_kona_audio_source_embedded,
+	.num_channels = 16,
+	.reg_index = 6,
+	.input_index = 6,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_source_config asc_sdi_8 = {
+	.name = "SDI 8",
+	.type = ntv2_input_type_sdi,
+	.audio_source = ntv2_kona_audio_source_embedded,
+	.num_channels = 16,
+	.reg_index = 7,
+	.input_index = 7,
+	.num_inputs = 1,
+};
+
+/* audio analog source */
+static const struct ntv2_source_config asc_analog = {
+	.name = "Analog",
+	.type = ntv2_input_type_analog,
+	.audio_source = ntv2_kona_audio_source_analog,
+	.num_channels = 2,
+	.reg_index = 0,
+	.input_index = 0,
+	.num_inputs = 1,
+};
+
+/* audio hdmi source */
+static const struct ntv2_source_config asc_hdmi_adv_1 = {
+	.name = "HDMI 1",
+	.type = ntv2_input_type_hdmi_adv,
+	.audio_source = ntv2_kona_audio_source_hdmi,
+	.num_channels = 8,
+	.reg_index = 0,
+	.input_index = 0,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_source_config asc_hdmi_aja_1 = {
+	.name = "HDMI 1",
+	.type = ntv2_input_type_hdmi_aja,
+	.audio_source = ntv2_kona_audio_source_hdmi,
+	.num_channels = 8,
+	.reg_index = 0,
+	.input_index = 0,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_source_config asc_hdmi_aja_2 = {
+	.name = "HDMI 2",
+	.type = ntv2_input_type_hdmi_aja,
+	.audio_source = ntv2_kona_audio_source_hdmi,
+	.num_channels = 8,
+	.reg_index = 1,
+	.input_index = 1,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_source_config asc_hdmi_adv_3 = {
+	.name = "HDMI 3",
+	.type = ntv2_input_type_hdmi_adv,
+	.audio_source = ntv2_kona_audio_source_hdmi,
+	.num_channels = 8,
+	.reg_index = 0,
+	.input_index = 2,
+	.num_inputs = 1,
+};
+
+static const struct ntv2_source_config asc_hdmi_adv_4 = {
+	.name = "HDMI 4",
+	.type = ntv2_input_type_hdmi_adv,
+	.audio_source = ntv2_kona_audio_source_hdmi,
+	.num_channels = 8,
+	.reg_index = 1,
+	.input_index = 3,
+	.num_inputs = 1,
+};
+
+/* 525i5994 timing */
+static const struct ntv2_video_format nvf_525i5994 = {
+	.name = "525i5994",
+	.v4l2_timings = V4L2_DV_BT_CEA_720X480I59_94,
+	.video_standard = ntv2_kona_video_standard_525i,
+	.frame_geometry = ntv2_kona_frame_geometry_720x486,
+	.frame_rate = ntv2_kona_frame_rate_2997,
+	.frame_flags =
 		ntv2_kona_frame_picture_interlaced |
-		ntv2_kona_frame_sd;
-
-	/* 625i5000 timing */
-	nvf = &nvf_625i5000;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "625i5000";
-	nvf->v4l2_timings = dvt_720x576i50;
-	nvf->video_standard = ntv2_kona_video_standard_625i;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_720x576;
-	nvf->frame_rate = ntv2_kona_frame_rate_2500;
-	nvf->frame_flags =
+		ntv2_kona_frame_sd,
+};
+
+/* 625i5000 timing */
+static const struct ntv2_video_format nvf_625i5000 = {
+	.name = "625i5000",
+	.v4l2_timings = V4L2_DV_BT_CEA_720X576I50,
+	.video_standard = ntv2_kona_video_standard_625i,
+	.frame_geometry = ntv2_kona_frame_geometry_720x576,
+	.frame_rate = ntv2_kona_frame_rate_2500,
+	.frame_flags =
 		ntv2_kona_frame_picture_interlaced |
-		ntv2_kona_frame_sd;
-
-	/* 720p5000 timing */
-	nvf = &nvf_720p5000;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "720p5000";
-	nvf->v4l2_timings = dvt_1280x720p50;
-	nvf->video_standard = ntv2_kona_video_standard_720p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1280x720;
-	nvf->frame_rate = ntv2_kona_frame_rate_5000;
-	nvf->frame_flags =
+		ntv2_kona_frame_sd,
+};
+
+/* 720p5000 timing */
+static const struct ntv2_video_format nvf_720p5000 = {
+	.name = "720p5000",
+	.v4l2_timings = V4L2_DV_BT_CEA_1280X720P50,
+	.video_standard = ntv2_kona_video_standard_720p,
+	.frame_geometry = ntv2_kona_frame_geometry_1280x720,
+	.frame_rate = ntv2_kona_frame_rate_5000,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_hd;
-
-	/* 720p5994 timing */
-	nvf = &nvf_720p5994;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "720p5994";
-	nvf->v4l2_timings = dvt_1280x720p60;
-	nvf->video_standard = ntv2_kona_video_standard_720p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1280x720;
-	nvf->frame_rate = ntv2_kona_frame_rate_5994;
-	nvf->frame_flags =
+		ntv2_kona_frame_hd,
+};
+
+/* 720p5994 timing */
+static const struct ntv2_video_format nvf_720p5994 = {
+	.name = "720p5994",
+	.v4l2_timings = V4L2_DV_BT_CEA_1280X720P60,
+	.video_standard = ntv2_kona_video_standard_720p,
+	.frame_geometry = ntv2_kona_frame_geometry_1280x720,
+	.frame_rate = ntv2_kona_frame_rate_5994,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_hd;
-
-	/* 720p6000 timing */
-	nvf = &nvf_720p6000;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "720p6000";
-	nvf->v4l2_timings = dvt_1280x720p60;
-	nvf->video_standard = ntv2_kona_video_standard_720p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1280x720;
-	nvf->frame_rate = ntv2_kona_frame_rate_6000;
-	nvf->frame_flags =
+		ntv2_kona_frame_hd,
+};
+
+/* 720p6000 timing */
+static const struct ntv2_video_format nvf_720p6000 = {
+	.name = "720p6000",
+	.v4l2_timings = V4L2_DV_BT_CEA_1280X720P60,
+	.video_standard = ntv2_kona_video_standard_720p,
+	.frame_geometry = ntv2_kona_frame_geometry_1280x720,
+	.frame_rate = ntv2_kona_frame_rate_6000,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_hd;
-
-	/* 1080p2398 timing */
-	nvf = &nvf_1080p2398;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "1080p2398";
-	nvf->v4l2_timings = dvt_1920x1080p24;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_2398;
-	nvf->frame_flags =
+		ntv2_kona_frame_hd,
+};
+
+/* 1080p2398 timing */
+static const struct ntv2_video_format nvf_1080p2398 = {
+	.name = "1080p2398",
+	.v4l2_timings = V4L2_DV_BT_CEA_1920X1080P24,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_2398,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_hd;
-
-	/* 1080p2400 timing */
-	nvf = &nvf_1080p2400;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "1080p2400";
-	nvf->v4l2_timings = dvt_1920x1080p24;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_2400;
-	nvf->frame_flags =
+		ntv2_kona_frame_hd,
+};
+
+/* 1080p2400 timing */
+static const struct ntv2_video_format nvf_1080p2400 = {
+	.name = "1080p2400",
+	.v4l2_timings = V4L2_DV_BT_CEA_1920X1080P24,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_2400,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_hd;
-
-	/* 1080p2500 timing */
-	nvf = &nvf_1080p2500;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "1080p2500";
-	nvf->v4l2_timings = dvt_1920x1080p25;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_2500;
-	nvf->frame_flags =
+		ntv2_kona_frame_hd,
+};
+
+/* 1080p2500 timing */
+static const struct ntv2_video_format nvf_1080p2500 = {
+	.name = "1080p2500",
+	.v4l2_timings = V4L2_DV_BT_CEA_1920X1080P25,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_2500,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_hd;
-
-	/* 1080p2997 timing */
-	nvf = &nvf_1080p2997;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "1080p2997";
-	nvf->v4l2_timings = dvt_1920x1080p30;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_2997;
-	nvf->frame_flags =
+		ntv2_kona_frame_hd,
+};
+
+/* 1080p2997 timing */
+static const struct ntv2_video_format nvf_1080p2997 = {
+	.name = "1080p2997",
+	.v4l2_timings = V4L2_DV_BT_CEA_1920X1080P30,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_2997,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_hd;
-
-	/* 1080p3000 timing */
-	nvf = &nvf_1080p3000;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "1080p3000";
-	nvf->v4l2_timings = dvt_1920x1080p30;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_3000;
-	nvf->frame_flags =
+		ntv2_kona_frame_hd,
+};
+
+/* 1080p3000 timing */
+static const struct ntv2_video_format nvf_1080p3000 = {
+	.name = "1080p3000",
+	.v4l2_timings = V4L2_DV_BT_CEA_1920X1080P30,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_3000,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_hd;
-
-	/* 1080p5000 timing */
-	nvf = &nvf_1080p5000;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "1080p5000";
-	nvf->v4l2_timings = dvt_1920x1080p50;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_5000;
-	nvf->frame_flags =
+		ntv2_kona_frame_hd,
+};
+
+/* 1080p5000 timing */
+static const struct ntv2_video_format nvf_1080p5000 = {
+	.name = "1080p5000",
+	.v4l2_timings = V4L2_DV_BT_CEA_1920X1080P50,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_5000,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_3g;
-
-	/* 1080p5994 timing */
-	nvf = &nvf_1080p5994;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "1080p5994";
-	nvf->v4l2_timings = dvt_1920x1080p60;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_5994;
-	nvf->frame_flags =
+		ntv2_kona_frame_3g,
+};
+
+/* 1080p5994 timing */
+static const struct ntv2_video_format nvf_1080p5994 = {
+	.name = "1080p5994",
+	.v4l2_timings = V4L2_DV_BT_CEA_1920X1080P60,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_5994,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_3g;
-
-	/* 1080p6000 timing */
-	nvf = &nvf_1080p6000;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "1080p6000";
-	nvf->v4l2_timings = dvt_1920x1080p60;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_6000;
-	nvf->frame_flags =
+		ntv2_kona_frame_3g,
+};
+
+/* 1080p6000 timing */
+static const struct ntv2_video_format nvf_1080p6000 = {
+	.name = "1080p6000",
+	.v4l2_timings = V4L2_DV_BT_CEA_1920X1080P60,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_6000,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_3g;
-
-	/* 1080i5000 timing */
-	nvf = &nvf_1080i5000;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "1080i5000";
-	nvf->v4l2_timings = dvt_1920x1080i50;
-	nvf->video_standard = ntv2_kona_video_standard_1080i;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_2500;
-	nvf->frame_flags =
+		ntv2_kona_frame_3g,
+};
+
+/* 1080i5000 timing */
+static const struct ntv2_video_format nvf_1080i5000 = {
+	.name = "1080i5000",
+	.v4l2_timings = V4L2_DV_BT_CEA_1920X1080I50,
+	.video_standard = ntv2_kona_video_standard_1080i,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_2500,
+	.frame_flags =
 		ntv2_kona_frame_picture_interlaced |
-		ntv2_kona_frame_hd;
-
-	/* 1080i5994 timing */
-	nvf = &nvf_1080i5994;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "1080i5994";
-	nvf->v4l2_timings = dvt_1920x1080i60;
-	nvf->video_standard = ntv2_kona_video_standard_1080i;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_2997;
-	nvf->frame_flags =
+		ntv2_kona_frame_hd,
+};
+
+/* 1080i5994 timing */
+static const struct ntv2_video_format nvf_1080i5994 = {
+	.name = "1080i5994",
+	.v4l2_timings = V4L2_DV_BT_CEA_1920X1080I60,
+	.video_standard = ntv2_kona_video_standard_1080i,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_2997,
+	.frame_flags =
 		ntv2_kona_frame_picture_interlaced |
-		ntv2_kona_frame_hd;
-
-	/* 1080i6000 timing */
-	nvf = &nvf_1080i6000;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "1080i6000";
-	nvf->v4l2_timings = dvt_1920x1080i60;
-	nvf->video_standard = ntv2_kona_video_standard_1080i;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_6000;
-	nvf->frame_flags =
+		ntv2_kona_frame_hd,
+};
+
+/* 1080i6000 timing */
+static const struct ntv2_video_format nvf_1080i6000 = {
+	.name = "1080i6000",
+	.v4l2_timings = V4L2_DV_BT_CEA_1920X1080I60,
+	.video_standard = ntv2_kona_video_standard_1080i,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_6000,
+	.frame_flags =
 		ntv2_kona_frame_picture_interlaced |
-		ntv2_kona_frame_hd;
-
-	/* 2160p2398 timing */
-	nvf = &nvf_2160p2398;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "2160p2398";
-	nvf->v4l2_timings = dvt_3840x2160p24;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_2398;
-	nvf->frame_flags =
+		ntv2_kona_frame_hd,
+};
+
+/* 2160p2398 timing */
+static const struct ntv2_video_format nvf_2160p2398 = {
+	.name = "2160p2398",
+	.v4l2_timings = V4L2_DV_BT_CEA_3840X2160P24,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_2398,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_6g;
-
-	/* 2160p2400 timing */
-	nvf = &nvf_2160p2400;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "2160p2400";
-	nvf->v4l2_timings = dvt_3840x2160p24;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_2400;
-	nvf->frame_flags =
+		ntv2_kona_frame_6g,
+};
+
+/* 2160p2400 timing */
+static const struct ntv2_video_format nvf_2160p2400 = {
+	.name = "2160p2400",
+	.v4l2_timings = V4L2_DV_BT_CEA_3840X2160P24,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_2400,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_6g;
-
-	/* 2160p2500 timing */
-	nvf = &nvf_2160p2500;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "2160p2500";
-	nvf->v4l2_timings = dvt_3840x2160p25;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_2500;
-	nvf->frame_flags =
+		ntv2_kona_frame_6g,
+};
+
+/* 2160p2500 timing */
+static const struct ntv2_video_format nvf_2160p2500 = {
+	.name = "2160p2500",
+	.v4l2_timings = V4L2_DV_BT_CEA_3840X2160P25,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_2500,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_6g;
-
-	/* 2160p2997 timing */
-	nvf = &nvf_2160p2997;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "2160p2997";
-	nvf->v4l2_timings = dvt_3840x2160p30;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_2997;
-	nvf->frame_flags =
+		ntv2_kona_frame_6g,
+};
+
+/* 2160p2997 timing */
+static const struct ntv2_video_format nvf_2160p2997 = {
+	.name = "2160p2997",
+	.v4l2_timings = V4L2_DV_BT_CEA_3840X2160P30,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_2997,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_6g;
-
-	/* 2160p3000 timing */
-	nvf = &nvf_2160p3000;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "2160p3000";
-	nvf->v4l2_timings = dvt_3840x2160p30;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_3000;
-	nvf->frame_flags =
+		ntv2_kona_frame_6g,
+};
+
+/* 2160p3000 timing */
+static const struct ntv2_video_format nvf_2160p3000 = {
+	.name = "2160p3000",
+	.v4l2_timings = V4L2_DV_BT_CEA_3840X2160P30,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_3000,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_6g;
-
-	/* 2160p5000 timing */
-	nvf = &nvf_2160p5000;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "2160p5000";
-	nvf->v4l2_timings = dvt_3840x2160p50;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_5000;
-	nvf->frame_flags =
+		ntv2_kona_frame_6g,
+};
+
+/* 2160p5000 timing */
+static const struct ntv2_video_format nvf_2160p5000 = {
+	.name = "2160p5000",
+	.v4l2_timings = V4L2_DV_BT_CEA_3840X2160P50,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_5000,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_12g;
-
-	/* 2160p5994 timing */
-	nvf = &nvf_2160p5994;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "2160p5994";
-	nvf->v4l2_timings = dvt_3840x2160p60;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_5994;
-	nvf->frame_flags =
+		ntv2_kona_frame_12g,
+};
+
+/* 2160p5994 timing */
+static const struct ntv2_video_format nvf_2160p5994 = {
+	.name = "2160p5994",
+	.v4l2_timings = V4L2_DV_BT_CEA_3840X2160P60,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_5994,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_12g;
-
-	/* 2160p6000 timing */
-	nvf = &nvf_2160p6000;
-	memset(nvf, 0, sizeof(struct ntv2_video_format));
-	nvf->name = "2160p6000";
-	nvf->v4l2_timings = dvt_3840x2160p60;
-	nvf->video_standard = ntv2_kona_video_standard_1080p;
-	nvf->frame_geometry = ntv2_kona_frame_geometry_1920x1080;
-	nvf->frame_rate = ntv2_kona_frame_rate_6000;
-	nvf->frame_flags =
+		ntv2_kona_frame_12g,
+};
+
+/* 2160p6000 timing */
+static const struct ntv2_video_format nvf_2160p6000 = {
+	.name = "2160p6000",
+	.v4l2_timings = V4L2_DV_BT_CEA_3840X2160P60,
+	.video_standard = ntv2_kona_video_standard_1080p,
+	.frame_geometry = ntv2_kona_frame_geometry_1920x1080,
+	.frame_rate = ntv2_kona_frame_rate_6000,
+	.frame_flags =
 		ntv2_kona_frame_picture_progressive |
-		ntv2_kona_frame_12g;
-
-	/* UYVY16 format */
-	npf = &npf_uyvy;
-	memset(npf, 0, sizeof(struct ntv2_pixel_format));
-	npf->name = "UYVY16";
-	npf->v4l2_pixel_format = V4L2_PIX_FMT_UYVY;
-	npf->ntv2_pixel_format = ntv2_kona_fbf_8bit_ycbcr;
-	npf->pixel_flags =
+		ntv2_kona_frame_12g,
+};
+
+/* UYVY16 format */
+static const struct ntv2_pixel_format npf_uyvy = {
+	.name = "UYVY16",
+	.v4l2_pixel_format = V4L2_PIX_FMT_UYVY,
+	.ntv2_pixel_format = ntv2_kona_fbf_8bit_ycbcr,
+	.pixel_flags =
 		ntv2_kona_pixel_yuv |
 		ntv2_kona_pixel_422 |
-		ntv2_kona_pixel_8bit;
-	npf->cadence_pixels = 2;
-	npf->cadence_bytes = 4;
-	npf->pitch_alignment = 4;
-
-	/* YUYV16 format */
-	npf = &npf_yuyv;
-	memset(npf, 0, sizeof(struct ntv2_pixel_format));
-	npf->name = "YUYV16";
-	npf->v4l2_pixel_format = V4L2_PIX_FMT_YUYV;
-	npf->ntv2_pixel_format = ntv2_kona_fbf_8bit_yuy2;
-	npf->pixel_flags =
+		ntv2_kona_pixel_8bit,
+	.cadence_pixels = 2,
+	.cadence_bytes = 4,
+	.pitch_alignment = 4,
+};
+
+/* YUYV16 format */
+static const struct ntv2_pixel_format npf_yuyv = {
+	.name = "YUYV16",
+	.v4l2_pixel_format = V4L2_PIX_FMT_YUYV,
+	.ntv2_pixel_format = ntv2_kona_fbf_8bit_yuy2,
+	.pixel_flags =
 		ntv2_kona_pixel_yuv |
 		ntv2_kona_pixel_422 |
-		ntv2_kona_pixel_8bit;
-	npf->cadence_pixels = 2;
-	npf->cadence_bytes = 4;
-	npf->pitch_alignment = 4;
-
-	/* RGB24 format */
-	npf = &npf_rgb;
-	memset(npf, 0, sizeof(struct ntv2_pixel_format));
-	npf->name = "RGB24";
-	npf->v4l2_pixel_format = V4L2_PIX_FMT_RGB24;
-	npf->ntv2_pixel_format = ntv2_kona_fbf_24bit_rgb;
-	npf->pixel_flags =
+		ntv2_kona_pixel_8bit,
+	.cadence_pixels = 2,
+	.cadence_bytes = 4,
+	.pitch_alignment = 4,
+};
+
+/* RGB24 format */
+static const struct ntv2_pixel_format npf_rgb = {
+	.name = "RGB24",
+	.v4l2_pixel_format = V4L2_PIX_FMT_RGB24,
+	.ntv2_pixel_format = ntv2_kona_fbf_24bit_rgb,
+	.pixel_flags =
 		ntv2_kona_pixel_rgb |
 		ntv2_kona_pixel_444 |
-		ntv2_kona_pixel_8bit;
-	npf->cadence_pixels = 1;
-	npf->cadence_bytes = 3;
-	npf->pitch_alignment = 4;
-
-	/* BGR24 format */
-	npf = &npf_bgr;
-	memset(npf, 0, sizeof(struct ntv2_pixel_format));
-	npf->name = "BGR24";
-	npf->v4l2_pixel_format = V4L2_PIX_FMT_BGR24;
-	npf->ntv2_pixel_format = ntv2_kona_fbf_24bit_bgr;
-	npf->pixel_flags =
+		ntv2_kona_pixel_8bit,
+	.cadence_pixels = 1,
+	.cadence_bytes = 3,
+	.pitch_alignment = 4,
+};
+
+/* BGR24 format */
+static const struct ntv2_pixel_format npf_bgr = {
+	.name = "BGR24",
+	.v4l2_pixel_format = V4L2_PIX_FMT_BGR24,
+	.ntv2_pixel_format = ntv2_kona_fbf_24bit_bgr,
+	.pixel_flags =
 		ntv2_kona_pixel_rgb |
 		ntv2_kona_pixel_444 |
-		ntv2_kona_pixel_8bit;
-	npf->cadence_pixels = 1;
-	npf->cadence_bytes = 3;
-	npf->pitch_alignment = 4;
+		ntv2_kona_pixel_8bit,
+	.cadence_pixels = 1,
+	.cadence_bytes = 3,
+	.pitch_alignment = 4,
+};
+
+/* V210 format */
+static const struct ntv2_pixel_format npf_v210 = {
+	.name = "V210",
+	.v4l2_pixel_format = V4L2_PIX_FMT_V210,
+	.ntv2_pixel_format = ntv2_kona_fbf_10bit_ycbcr,
+	.pixel_flags =
+		ntv2_kona_pixel_yuv |
+		ntv2_kona_pixel_422 |
+		ntv2_kona_pixel_10bit,
+	.cadence_pixels = 6,
+	.cadence_bytes = 16,
+	.pitch_alignment = 128,
+};
+
+/* P030 format (three 10 bit samples per 32 bit word) */
+static const struct ntv2_pixel_format npf_p030 = {
+	.name = "P030",
+	.v4l2_pixel_format = V4L2_PIX_FMT_P030,
+	.ntv2_pixel_format = ntv2_kona_fbf_10bit_ycbcr_420pl2,
+	.pixel_flags =
+		ntv2_kona_pixel_yuv |
+		ntv2_kona_pixel_420 |
+		ntv2_kona_pixel_10bit,
+	.cadence_pixels = 3,
+	.cadence_bytes = 4,
+	.pitch_alignment = 4,
+	.num_planes = 2,
+	.plane_line_divisor = 2,
+};
+
+/* NV12M format */
+static const struct ntv2_pixel_format npf_nv12m = {
+	.name = "NV12M",
+	.v4l2_pixel_format = V4L2_PIX_FMT_NV12M,
+	.ntv2_pixel_format = ntv2_kona_fbf_8bit_ycbcr_420pl2,
+	.pixel_flags =
+		ntv2_kona_pixel_yuv |
+		ntv2_kona_pixel_420 |
+		ntv2_kona_pixel_8bit,
+	.cadence_pixels = 1,
+	.cadence_bytes = 1,
+	.pitch_alignment = 4,
+	.num_planes = 2,
+	.plane_line_divisor = 2,
+	.buffer_planes = 2,
+};
+
+/* NV16M format */
+static const struct ntv2_pixel_format npf_nv16m = {
+	.name = "NV16M",
+	.v4l2_pixel_format = V4L2_PIX_FMT_NV16M,
+	.ntv2_pixel_format = ntv2_kona_fbf_8bit_ycbcr_422pl2,
+	.pixel_flags =
+		ntv2_kona_pixel_yuv |
+		ntv2_kona_pixel_422 |
+		ntv2_kona_pixel_8bit,
+	.cadence_pixels = 1,
+	.cadence_bytes = 1,
+	.pitch_alignment = 4,
+	.num_planes = 2,
+	.plane_line_divisor = 1,
+	.buffer_planes = 2,
+};
 
 #ifdef NTV2_RGB_PIXEL_FORMATS
-	/* RGB32 format */
-	npf = &npf_rgba;
-	memset(npf, 0, sizeof(struct ntv2_pixel_format));
-	npf->name = "XRGB32";
-	npf->v4l2_pixel_format = V4L2_PIX_FMT_XRGB32;
-	npf->ntv2_pixel_format = ntv2_kona_fbf_rgba;
-	npf->pixel_flags =
+/* RGB32 format */
+static const struct ntv2_pixel_format npf_rgba = {
+	.name = "XRGB32",
+	.v4l2_pixel_format = V4L2_PIX_FMT_XRGB32,
+	.ntv2_pixel_format = ntv2_kona_fbf_rgba,
+	.pixel_flags =
 		ntv2_kona_pixel_rgb |
 		ntv2_kona_pixel_4444 |
-		ntv2_kona_pixel_8bit;
-	npf->cadence_pixels = 1;
-	npf->cadence_bytes = 4;
-	npf->pitch_alignment = 4;
-
-	/* BGR32 format */
-	npf = &npf_bgra;
-	memset(npf, 0, sizeof(struct ntv2_pixel_format));
-	npf->name = "XBGR32";
-	npf->v4l2_pixel_format = V4L2_PIX_FMT_XBGR32;
-	npf->ntv2_pixel_format = ntv2_kona_fbf_argb;
-	npf->pixel_flags =
+		ntv2_kona_pixel_8bit,
+	.cadence_pixels = 1,
+	.cadence_bytes = 4,
+	.pitch_alignment = 4,
+};
+
+/* BGR32 format */
+static const struct ntv2_pixel_format npf_bgra = {
+	.name = "XBGR32",
+	.v4l2_pixel_format = V4L2_PIX_FMT_XBGR32,
+	.ntv2_pixel_format = ntv2_kona_fbf_argb,
+	.pixel_flags =
 		ntv2_kona_pixel_rgb |
 		ntv2_kona_pixel_4444 |
-		ntv2_kona_pixel_8bit;
-	npf->cadence_pixels = 1;
-	npf->cadence_bytes = 4;
-	npf->pitch_alignment = 4;
-#else   
-	/* RGB32 format */
-	npf = &npf_rgba;
-	memset(npf, 0, sizeof(struct ntv2_pixel_format));
-	npf->name = "RGB32";
-	npf->v4l2_pixel_format = V4L2_PIX_FMT_RGB32;
-	npf->ntv2_pixel_format = ntv2_kona_fbf_abgr;
-	npf->pixel_flags =
+		ntv2_kona_pixel_8bit,
+	.cadence_pixels = 1,
+	.cadence_bytes = 4,
+	.pitch_alignment = 4,
+};
+#else
+/* RGB32 format */
+static const struct ntv2_pixel_format npf_rgba = {
+	.name = "RGB32",
+	.v4l2_pixel_format = V4L2_PIX_FMT_RGB32,
+	.ntv2_pixel_format = ntv2_kona_fbf_abgr,
+	.pixel_flags =
 		ntv2_kona_pixel_rgb |
 		ntv2_kona_pixel_4444 |
-		ntv2_kona_pixel_8bit;
-	npf->cadence_pixels = 1;
-	npf->cadence_bytes = 4;
-	npf->pitch_alignment = 4;
-
-	/* BGR32 format */
-	npf = &npf_bgra;
-	memset(npf, 0, sizeof(struct ntv2_pixel_format));
-	npf->name = "BGR32";
-	npf->v4l2_pixel_format = V4L2_PIX_FMT_BGR32;
-	npf->ntv2_pixel_format = ntv2_kona_fbf_argb;
-	npf->pixel_flags =
+		ntv2_kona_pixel_8bit,
+	.cadence_pixels = 1,
+	.cadence_bytes = 4,
+	.pitch_alignment = 4,
+};
+
+/* BGR32 format */
+static const struct ntv2_pixel_format npf_bgra = {
+	.name = "BGR32",
+	.v4l2_pixel_format = V4L2_PIX_FMT_BGR32,
+	.ntv2_pixel_format = ntv2_kona_fbf_argb,
+	.pixel_flags =
 		ntv2_kona_pixel_rgb |
 		ntv2_kona_pixel_4444 |
-		ntv2_kona_pixel_8bit;
-	npf->cadence_pixels = 1;
-	npf->cadence_bytes = 4;
-	npf->pitch_alignment = 4;
-#endif	
-}
+		ntv2_kona_pixel_8bit,
+	.cadence_pixels = 1,
+	.cadence_bytes = 4,
+	.pitch_alignment = 4,
+};
+#endif
 
 static void all_video_formats(struct ntv2_features *features)
 {
@@ -1948,6 +2025,10 @@ static void all_yuv_pixel_formats(struct ntv2_features *features)
 {
 	features->pixel_formats[0] = &npf_uyvy;
 	features->pixel_formats[1] = &npf_yuyv;
+	features->pixel_formats[2] = &npf_v210;
+	features->pixel_formats[3] = &npf_p030;
+	features->pixel_formats[4] = &npf_nv12m;
+	features->pixel_formats[5] = &npf_nv16m;
 }
 
 static void all_rgb_pixel_formats(struct ntv2_features *features)
@@ -1966,6 +2047,10 @@ static void all_pixel_formats(struct ntv2_features *features)
 	features->pixel_formats[3] = &npf_bgr;
 	features->pixel_formats[4] = &npf_rgba;
 	features->pixel_formats[5] = &npf_bgra;
+	features->pixel_formats[6] = &npf_v210;
+	features->pixel_formats[7] = &npf_p030;
+	features->pixel_formats[8] = &npf_nv12m;
+	features->pixel_formats[9] = &npf_nv16m;
 }
 
 static void build_v4l2_timings(struct ntv2_features *features)
@@ -1990,6 +2075,39 @@ static void build_v4l2_timings(struct ntv2_features *features)
 	}
 }
 
+static void build_format_index(struct ntv2_features *features)
+{
+	const struct ntv2_video_format *vidf;
+	u8 *link;
+	u32 slot;
+	int i;
+
+	memset(features->video_format_index, 0, sizeof(features->video_format_index));
+	memset(features->video_format_chain, 0, sizeof(features->video_format_chain));
+	memset(features->v4l2_timings_hash, 0, sizeof(features->v4l2_timings_hash));
+
+	for (i = 0; i < NTV2_MAX_VIDEO_FORMATS; i++) {
+		vidf = features->video_formats[i];
+		if (vidf == NULL)
+			break;
+
+		/* chain by standard and rate in table order */
+		if ((vidf->video_standard < NTV2_MAX_VIDEO_STANDARDS) &&
+			(vidf->frame_rate < NTV2_MAX_FRAME_RATES)) {
+			link = &features->video_format_index[vidf->video_standard][vidf->frame_rate];
+			while (*link != 0)
+				link = &features->video_format_chain[*link - 1];
+			*link = i + 1;
+		}
+
+		/* hash by timings, the table is twice the max formats so it never fills */
+		slot = ntv2_features_timings_hash(&vidf->v4l2_timings);
+		while (features->v4l2_timings_hash[slot] != 0)
+			slot = (slot + 1) & (NTV2_TIMINGS_HASH_SIZE - 1);
+		features->v4l2_timings_hash[slot] = i + 1;
+	}
+}
+
 static void ntv2_features_corvid44(struct ntv2_features *features) 
 {
 	int i;
@@ -2001,6 +2119,7 @@ static void ntv2_features_corvid44(struct ntv2_features *features)
 	features->num_csc_channels = 4;
 	features->num_sdi_inputs = 4;
 	features->num_reference_inputs = 1;
+	features->num_anc_extractors = 4;
 	features->frame_buffer_size = 0x40000000;
 	features->req_line_interleave_channels = 2;
 	features->req_sample_interleave_channels = 2;
@@ -2053,6 +2172,7 @@ static void ntv2_features_corvid44(struct ntv2_features *features)
 	all_video_formats(features);
 	all_pixel_formats(features);
 	build_v4l2_timings(features);
+	build_format_index(features);
 }
 
 static void ntv2_features_corvid88(struct ntv2_features *features) 
@@ -2066,6 +2186,7 @@ static void ntv2_features_corvid88(struct ntv2_features *features)
 	features->num_csc_channels = 8;
 	features->num_sdi_inputs = 8;
 	features->num_reference_inputs = 1;
+	features->num_anc_extractors = 8;
 	features->frame_buffer_size = 0x40000000;
 	features->req_line_interleave_channels = 2;
 	features->req_sample_interleave_channels = 2;
@@ -2153,6 +2274,7 @@ static void ntv2_features_corvid88(struct ntv2_features *features)
 	all_video_formats(features);
 	all_pixel_formats(features);
 	build_v4l2_timings(features);
+	build_format_index(features);
 }
 
 static void ntv2_features_kona4(struct ntv2_features *features) 
@@ -2166,6 +2288,7 @@ static void ntv2_features_kona4(struct ntv2_features *features)
 	features->num_csc_channels = 4;
 	features->num_sdi_inputs = 4;
 	features->num_reference_inputs = 1;
+	features->num_anc_extractors = 4;
 	features->num_aes_inputs = 1;
 	features->frame_buffer_size = 0x37800000;
 	features->req_line_interleave_channels = 2;
@@ -2223,6 +2346,7 @@ static void ntv2_features_kona4(struct ntv2_features *features)
 	all_video_formats(features);
 	all_pixel_formats(features);
 	build_v4l2_timings(features);
+	build_format_index(features);
 }
 
 static void ntv2_features_corvidhbr(struct ntv2_features *features) 
@@ -2278,6 +2402,7 @@ static void ntv2_features_corvidhbr(struct ntv2_features *features)
 
 	all_pixel_formats(features);
 	build_v4l2_timings(features);
+	build_format_index(features);
 
 	features->serial_config[0] = &nsc_uartlite;
 }
@@ -2337,6 +2462,7 @@ static void ntv2_features_konahdmi(struct ntv2_features *features)
 	all_video_formats(features);
 	all_pixel_formats(features);
 	build_v4l2_timings(features);
+	build_format_index(features);
 }
 
 static void ntv2_features_kona1(struct ntv2_features *features) 
@@ -2348,6 +2474,7 @@ static void ntv2_features_kona1(struct ntv2_features *features)
 	features->num_csc_channels = 1;
 	features->num_sdi_inputs = 1;
 	features->num_reference_inputs = 1;
+	features->num_anc_extractors = 1;
 	features->frame_buffer_size = 0x40000000;
 	features->req_line_interleave_channels = 2;
 	features->req_sample_interleave_channels = 2;
@@ -2378,5 +2505,6 @@ static void ntv2_features_kona1(struct ntv2_features *features)
 
 	all_pixel_formats(features);
 	build_v4l2_timings(features);
+	build_format_index(features);
 }
 
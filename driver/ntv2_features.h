@@ -22,6 +22,10 @@
 
 #include "ntv2_common.h"
 
+/* dv timings lookup hash (holds NTV2_MAX_VIDEO_FORMATS) */
+#define NTV2_TIMINGS_HASH_BITS		6
+#define NTV2_TIMINGS_HASH_SIZE		(1 << NTV2_TIMINGS_HASH_BITS)
+
 enum ntv2_component {
 	ntv2_component_unknown,
 	ntv2_component_sdi,
@@ -57,7 +61,7 @@ struct ntv2_input_config {
 	const char*					name;
 	enum ntv2_input_type		type;
 	enum ntv2_edid_type			edid;
-	struct v4l2_dv_timings_cap	v4l2_timings_cap;
+	const struct v4l2_dv_timings_cap	*v4l2_timings_cap;
 	u32							frame_flags;
 	int							reg_index;
 	int							input_index;
@@ -100,25 +104,29 @@ struct ntv2_features {
 	int							num_analog_inputs;
 	int							num_reference_inputs;
 	int							num_serial_ports;
+	int							num_anc_extractors;
 	u32							frame_buffer_size;
 	int							req_line_interleave_channels;
 	int							req_sample_interleave_channels;
 	int							req_square_division_channels;
 
-	struct ntv2_video_config	*video_config[NTV2_MAX_CHANNELS];
-	struct ntv2_input_config	*input_config[NTV2_MAX_CHANNELS][NTV2_MAX_INPUT_CONFIGS];
-	struct ntv2_widget_config	*csc_config[NTV2_MAX_CHANNELS][NTV2_MAX_CSC_CONFIGS];
+	const struct ntv2_video_config	*video_config[NTV2_MAX_CHANNELS];
+	const struct ntv2_input_config	*input_config[NTV2_MAX_CHANNELS][NTV2_MAX_INPUT_CONFIGS];
+	const struct ntv2_widget_config	*csc_config[NTV2_MAX_CHANNELS][NTV2_MAX_CSC_CONFIGS];
 
-	struct ntv2_audio_config	*audio_config[NTV2_MAX_CHANNELS];
-	struct ntv2_source_config	*source_config[NTV2_MAX_CHANNELS][NTV2_MAX_SOURCE_CONFIGS];
+	const struct ntv2_audio_config	*audio_config[NTV2_MAX_CHANNELS];
+	const struct ntv2_source_config	*source_config[NTV2_MAX_CHANNELS][NTV2_MAX_SOURCE_CONFIGS];
 
-	struct ntv2_video_format	*video_formats[NTV2_MAX_VIDEO_FORMATS];
-	struct ntv2_pixel_format	*pixel_formats[NTV2_MAX_PIXEL_FORMATS];
-	struct v4l2_dv_timings		*v4l2_timings[NTV2_MAX_VIDEO_FORMATS];
+	const struct ntv2_video_format	*video_formats[NTV2_MAX_VIDEO_FORMATS];
+	const struct ntv2_pixel_format	*pixel_formats[NTV2_MAX_PIXEL_FORMATS];
+	const struct v4l2_dv_timings	*v4l2_timings[NTV2_MAX_VIDEO_FORMATS];
+	u8							video_format_index[NTV2_MAX_VIDEO_STANDARDS][NTV2_MAX_FRAME_RATES];
+	u8							video_format_chain[NTV2_MAX_VIDEO_FORMATS];
+	u8							v4l2_timings_hash[NTV2_TIMINGS_HASH_SIZE];
 
 	unsigned long				component_owner[ntv2_component_size][NTV2_MAX_CHANNELS];
 
-	struct ntv2_serial_config	*serial_config[NTV2_MAX_CHANNELS];
+	const struct ntv2_serial_config	*serial_config[NTV2_MAX_CHANNELS];
 	enum ntv2_edid_type			hdmi_edid[NTV2_MAX_CHANNELS];
 };
 
@@ -129,84 +137,100 @@ void ntv2_features_close(struct ntv2_features *features);
 
 int ntv2_features_configure(struct ntv2_features *features, u32 id);
 
-struct ntv2_video_config
+const struct ntv2_video_config
 *ntv2_features_get_video_config(struct ntv2_features *features,
 								int channel_index);
 
-struct ntv2_audio_config
+const struct ntv2_audio_config
 *ntv2_features_get_audio_config(struct ntv2_features *features,
 								int channel_index);
 
-struct ntv2_input_config
+const struct ntv2_input_config
 *ntv2_features_get_input_config(struct ntv2_features *features,
 								int channel_index,
 								int config_index);
 int ntv2_features_num_input_configs(struct ntv2_features *features,
 									int channel_index);
-struct ntv2_input_config
+const struct ntv2_input_config
 *ntv2_features_get_default_input_config(struct ntv2_features *features,
 										int channel_index);
 
-struct ntv2_source_config
+const struct ntv2_source_config
 *ntv2_features_get_source_config(struct ntv2_features *features,
 								 int channel_index,
 								 int source_index);
 int ntv2_features_num_source_configs(struct ntv2_features *features,
 									 int channel_index);
-struct ntv2_source_config
+const struct ntv2_source_config
 *ntv2_features_get_default_source_config(struct ntv2_features *features,
 										 int channel_index,
 										 bool noauto);
 
-struct ntv2_pixel_format
+const struct ntv2_pixel_format
 *ntv2_features_get_pixel_format(struct ntv2_features *features,
 								int channel_index,
 								int format_index);
 int ntv2_features_num_pixel_formats(struct ntv2_features *features,
 									int channel_index);
-struct ntv2_pixel_format
+const struct ntv2_pixel_format
 *ntv2_features_get_default_pixel_format(struct ntv2_features *features,
 										int channel_index);
 
-struct ntv2_video_format
+const struct ntv2_video_format
 *ntv2_features_get_video_format(struct ntv2_features *features,
 								int channel_index,
 								int format_index);
 int ntv2_features_num_video_formats(struct ntv2_features *features,
 									int channel_index);
-struct ntv2_video_format
+const struct ntv2_video_format
 *ntv2_features_get_default_video_format(struct ntv2_features *features,
 										int channel_index);
-
-struct ntv2_source_config
+const struct ntv2_video_format
+*ntv2_features_find_video_format(struct ntv2_features *features,
+								 int channel_index,
+								 u32 video_standard,
+								 u32 frame_rate,
+								 u32 frame_flags);
+const struct ntv2_video_format
+*ntv2_features_find_timings_format(struct ntv2_features *features,
+								   int channel_index,
+								   const struct v4l2_dv_timings *t,
+								   bool drop_frame);
+
+const struct ntv2_source_config
 *ntv2_features_find_source_config(struct ntv2_features *features,
 								  int channel_index,
 								  enum ntv2_input_type input_type,
 								  int input_index);
 
-struct ntv2_widget_config
+const struct ntv2_widget_config
 *ntv2_features_find_csc_config(struct ntv2_features *features,
 							   int channel_index, int num_cscs);
 
-void ntv2_features_gen_input_format(struct ntv2_input_config *config,
-									struct ntv2_video_format *vidf,
-									struct ntv2_pixel_format *pixf,
+void ntv2_features_gen_input_format(const struct ntv2_input_config *config,
+									const struct ntv2_video_format *vidf,
+									const struct ntv2_pixel_format *pixf,
 									struct ntv2_input_format *inpf);
 
-void ntv2_features_gen_source_format(struct ntv2_source_config *config,
+void ntv2_features_gen_source_format(const struct ntv2_source_config *config,
 									 struct ntv2_source_format *format);
 
-u32 ntv2_features_line_pitch(struct ntv2_pixel_format *format, u32 pixels);
+u32 ntv2_features_line_bytes(const struct ntv2_pixel_format *format, u32 pixels);
+u32 ntv2_features_line_pitch(const struct ntv2_pixel_format *format, u32 pixels);
+
+u32 ntv2_features_frame_lines(const struct ntv2_pixel_format *format, u32 lines);
+u32 ntv2_features_buffer_planes(const struct ntv2_pixel_format *format);
+u32 ntv2_features_plane_lines(const struct ntv2_pixel_format *format, u32 plane, u32 lines);
 
-u32 ntv2_features_ntv2_frame_size(struct ntv2_video_format *vidf,
-								  struct ntv2_pixel_format *pixf);
+u32 ntv2_features_ntv2_frame_size(const struct ntv2_video_format *vidf,
+								  const struct ntv2_pixel_format *pixf);
 
-u32 ntv2_features_v4l2_frame_size(struct ntv2_video_format *vidf,
-								  struct ntv2_pixel_format *pixf);
+u32 ntv2_features_v4l2_frame_size(const struct ntv2_video_format *vidf,
+								  const struct ntv2_pixel_format *pixf);
 
 int ntv2_features_get_frame_range(struct ntv2_features *features,
-								  struct ntv2_video_format *vidf,
-								  struct ntv2_pixel_format *pixf,
+								  const struct ntv2_video_format *vidf,
+								  const struct ntv2_pixel_format *pixf,
 								  int index,
 								  u32 *first,
 								  u32 *last,
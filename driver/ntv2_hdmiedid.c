@@ -129,7 +129,8 @@ struct ntv2_hdmiedid *ntv2_hdmiedid_open(struct ntv2_object *ntv2_obj,
 {
 	struct ntv2_hdmiedid *ntv2_hed = NULL;
 
-	ntv2_hed = kzalloc(sizeof(struct ntv2_hdmiedid), GFP_KERNEL);
+	ntv2_hed = kzalloc_node(sizeof(struct ntv2_hdmiedid), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_hed == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_hdmiedid instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
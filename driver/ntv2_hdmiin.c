@@ -53,6 +53,13 @@
 #define FRAME_RATE_TOLERANCE		6
 /* high frequency clock phase adjustment (degrees?)*/
 #define CLOCK_PHASE_HF  			18
+/* i2c batch size and completion timeout (ms) */
+#define NTV2_HDMIIN_MAX_I2C_OPS		1024
+#define NTV2_HDMIIN_BATCH_TIMEOUT	2000
+/* monitor poll time while acquiring or without an interrupt (ms) */
+#define MONITOR_POLL_TIME			100
+/* monitor fallback poll time when the input is stable (ms) */
+#define MONITOR_IDLE_TIME			2000
 
 /* vic mapping */
 struct ntv2_video_code_info {
@@ -66,7 +73,27 @@ struct ntv2_video_code_info ntv2_avi_vic_info[NTV2_AVI_VIC_INFO_SIZE];
 #define NTV2_VSI_VIC_INFO_SIZE			8
 struct ntv2_video_code_info ntv2_vsi_vic_info[NTV2_VSI_VIC_INFO_SIZE];
 
+static bool ntv2_vic_info_init = false;
+static DEFINE_MUTEX(ntv2_vic_info_mutex);
+
+static void ntv2_hdmiin_vic_info_initialize(void);
 static int ntv2_hdmiin_monitor(void* data);
+static int ntv2_hdmiin_batch_add(struct ntv2_hdmiin *ntv2_hin,
+								 u8 device,
+								 struct ntv2_reg_value *reg_value,
+								 int count,
+								 bool filter);
+static void ntv2_hdmiin_batch_add_op(struct ntv2_hdmiin *ntv2_hin,
+									 struct ntv2_hdmiin_i2c_shadow *shadow,
+									 u8 device, u8 address, u8 data);
+static int ntv2_hdmiin_batch_add_edid(struct ntv2_hdmiin *ntv2_hin,
+									  struct ntv2_hdmiedid *ntv2_edid,
+									  u8 device);
+static int ntv2_hdmiin_batch_write(struct ntv2_hdmiin *ntv2_hin);
+static struct ntv2_hdmiin_i2c_shadow *ntv2_hdmiin_shadow_find(struct ntv2_hdmiin *ntv2_hin, u8 device);
+static int ntv2_hdmiin_shadow_load(struct ntv2_hdmiin *ntv2_hin, u8 device);
+static void ntv2_hdmiin_shadow_reset(struct ntv2_hdmiin *ntv2_hin);
+static int ntv2_hdmiin_write(struct ntv2_hdmiin *ntv2_hin, u8 address, u8 data);
 static int ntv2_hdmiin_write_multi(struct ntv2_hdmiin *ntv2_hin,
 								   u8 device,
 								   struct ntv2_reg_value *reg_value,
@@ -75,9 +102,6 @@ static int ntv2_hdmiin_read_verify(struct ntv2_hdmiin *ntv2_hin,
 								   u8 device,
 								   struct ntv2_reg_value *reg_value,
 								   int count);
-static int ntv2_hdmiin_write_edid(struct ntv2_hdmiin *ntv2_hin,
-								  struct ntv2_hdmiedid *ntv2_edid,
-								  u8 device);
 static int ntv2_hdmiin_initialize(struct ntv2_hdmiin *ntv2_hin);
 static void ntv2_hdmiin_hot_plug(struct ntv2_hdmiin *ntv2_hin);
 static int ntv2_hdmiin_set_color_mode(struct ntv2_hdmiin *ntv2_hin, bool yuv_input, bool yuv_output);
@@ -102,7 +126,8 @@ struct ntv2_hdmiin *ntv2_hdmiin_open(struct ntv2_object *ntv2_obj,
 {
 	struct ntv2_hdmiin *ntv2_hin = NULL;
 
-	ntv2_hin = kzalloc(sizeof(struct ntv2_hdmiin), GFP_KERNEL);
+	ntv2_hin = kzalloc_node(sizeof(struct ntv2_hdmiin), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_hin == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_hdmiin instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
@@ -114,6 +139,7 @@ struct ntv2_hdmiin *ntv2_hdmiin_open(struct ntv2_object *ntv2_obj,
 	ntv2_hin->ntv2_dev = ntv2_obj->ntv2_dev;
 
 	spin_lock_init(&ntv2_hin->state_lock);
+	init_waitqueue_head(&ntv2_hin->monitor_wait);
 
 	NTV2_MSG_HDMIIN_INFO("%s: open ntv2_hdmiin\n", ntv2_hin->name);
 
@@ -131,6 +157,7 @@ void ntv2_hdmiin_close(struct ntv2_hdmiin *ntv2_hin)
 
 	ntv2_hdmiedid_close(ntv2_hin->edid);
 	ntv2_konai2c_close(ntv2_hin->i2c_reg);
+	kfree(ntv2_hin->i2c_ops);
 
 	memset(ntv2_hin, 0, sizeof(struct ntv2_hdmiin));
 	kfree(ntv2_hin);
@@ -143,7 +170,6 @@ int ntv2_hdmiin_configure(struct ntv2_hdmiin *ntv2_hin,
 {
 	enum ntv2_edid_type edid_type = ntv2_edid_type_unknown;
 	int result = 0;
-	int i;
 
 	if ((ntv2_hin == NULL) ||
 		(features == NULL) ||
@@ -167,6 +193,11 @@ int ntv2_hdmiin_configure(struct ntv2_hdmiin *ntv2_hin,
 	if (result < 0)
 		return result;
 
+	ntv2_hin->i2c_ops = kcalloc_node(NTV2_HDMIIN_MAX_I2C_OPS, sizeof(struct ntv2_konai2c_op), GFP_KERNEL,
+								   ntv2_hin->ntv2_dev->numa_node);
+	if (ntv2_hin->i2c_ops == NULL)
+		return -ENOMEM;
+
 	/* configure edid */
 	edid_type = ntv2_features_hdmi_edid_type(ntv2_hin->features, port_index);
 	if (edid_type != ntv2_edid_type_unknown) {
@@ -183,6 +214,121 @@ int ntv2_hdmiin_configure(struct ntv2_hdmiin *ntv2_hin,
 		}
 	}
 
+	/* vic tables are shared by all inputs */
+	mutex_lock(&ntv2_vic_info_mutex);
+	if (!ntv2_vic_info_init) {
+		ntv2_hdmiin_vic_info_initialize();
+		ntv2_vic_info_init = true;
+	}
+	mutex_unlock(&ntv2_vic_info_mutex);
+
+	return 0;
+}
+
+int ntv2_hdmiin_enable(struct ntv2_hdmiin *ntv2_hin)
+{
+	if (ntv2_hin == NULL)
+		return -EPERM;
+
+	if (ntv2_hin->monitor_state == ntv2_task_state_enable)
+		return 0;
+
+	NTV2_MSG_HDMIIN_STATE("%s: enable hdmi input monitor\n", ntv2_hin->name);
+
+	ntv2_hin->irq_event = false;
+	ntv2_hin->irq_detect = false;
+
+	ntv2_hin->monitor_task = kthread_run(ntv2_hdmiin_monitor, (void*)ntv2_hin, ntv2_hin->name);
+	if (IS_ERR(ntv2_hin->monitor_task)) {
+		ntv2_hin->monitor_task = NULL;
+		return -ENOMEM;
+	}
+
+	ntv2_hin->monitor_state = ntv2_task_state_enable;
+
+	/* only the first receiver is routed to the board interrupt */
+	if (ntv2_hin->index == 0) {
+		ntv2_hdmi_input_interrupt_clear(ntv2_hin->vid_reg);
+		ntv2_hdmi_input_interrupt_enable(ntv2_hin->vid_reg, true);
+	}
+
+	return 0;
+}
+
+int ntv2_hdmiin_disable(struct ntv2_hdmiin *ntv2_hin)
+{
+	if (ntv2_hin == NULL)
+		return -EPERM;
+
+	if (ntv2_hin->monitor_state != ntv2_task_state_enable)
+		return 0;
+
+	NTV2_MSG_HDMIIN_STATE("%s: disable hdmi input monitor\n", ntv2_hin->name);
+
+	if (ntv2_hin->monitor_task != NULL) {
+		kthread_stop(ntv2_hin->monitor_task);
+		ntv2_hin->monitor_task = NULL;
+	}
+
+	/* the monitor may have unmasked it */
+	if (ntv2_hin->index == 0)
+		ntv2_hdmi_input_interrupt_enable(ntv2_hin->vid_reg, false);
+
+	ntv2_hin->monitor_state = ntv2_task_state_disable;
+
+	return 0;
+}
+
+int ntv2_hdmiin_get_input_format(struct ntv2_hdmiin *ntv2_hin,
+								 struct ntv2_hdmiin_format *format)
+{
+	unsigned long flags;
+
+	if ((ntv2_hin == NULL) ||
+		(format == NULL))
+		return -EPERM;
+
+	spin_lock_irqsave(&ntv2_hin->state_lock, flags);
+	*format = ntv2_hin->input_format;
+	spin_unlock_irqrestore(&ntv2_hin->state_lock, flags);
+
+	return 0;
+}
+
+int ntv2_hdmiin_interrupt(struct ntv2_hdmiin *ntv2_hin,
+						  struct ntv2_interrupt_status* irq_status)
+{
+	unsigned long flags;
+
+	if ((ntv2_hin == NULL) ||
+		(irq_status == NULL))
+		return IRQ_NONE;
+
+	if ((ntv2_hin->index != 0) ||
+		(ntv2_hin->monitor_state != ntv2_task_state_enable))
+		return IRQ_NONE;
+
+	if (!ntv2_hdmi_input_interrupt_active(irq_status))
+		return IRQ_NONE;
+
+	/* mask until the monitor has serviced the receiver */
+	ntv2_hdmi_input_interrupt_enable(ntv2_hin->vid_reg, false);
+	ntv2_hdmi_input_interrupt_clear(ntv2_hin->vid_reg);
+
+	spin_lock_irqsave(&ntv2_hin->state_lock, flags);
+	ntv2_hin->irq_event = true;
+	ntv2_hin->irq_detect = true;
+	spin_unlock_irqrestore(&ntv2_hin->state_lock, flags);
+
+	wake_up(&ntv2_hin->monitor_wait);
+
+	return IRQ_HANDLED;
+}
+
+static void ntv2_hdmiin_vic_info_initialize(void)
+{
+	int i;
+
 	/* initialize hdmi avi vic to ntv2 standard and rate table */
 	for (i = 0; i < NTV2_AVI_VIC_INFO_SIZE; i++) {
 		ntv2_avi_vic_info[i].video_standard = ntv2_kona_video_standard_none;
@@ -274,70 +420,14 @@ int ntv2_hdmiin_configure(struct ntv2_hdmiin *ntv2_hin,
 	ntv2_vsi_vic_info[3].frame_rate = ntv2_kona_frame_rate_2400;
 	ntv2_vsi_vic_info[4].video_standard = ntv2_kona_video_standard_4096x2160p;
 	ntv2_vsi_vic_info[4].frame_rate = ntv2_kona_frame_rate_2400;
-
-	return 0;
-}
-
-int ntv2_hdmiin_enable(struct ntv2_hdmiin *ntv2_hin)
-{
-	if (ntv2_hin == NULL)
-		return -EPERM;
-
-	if (ntv2_hin->monitor_state == ntv2_task_state_enable)
-		return 0;
-
-	NTV2_MSG_HDMIIN_STATE("%s: enable hdmi input monitor\n", ntv2_hin->name);
-
-	ntv2_hin->monitor_task = kthread_run(ntv2_hdmiin_monitor, (void*)ntv2_hin, ntv2_hin->name);
-	if (IS_ERR(ntv2_hin->monitor_task)) {
-		ntv2_hin->monitor_task = NULL;
-		return -ENOMEM;
-	}
-
-	ntv2_hin->monitor_state = ntv2_task_state_enable;
-
-	return 0;
-}
-
-int ntv2_hdmiin_disable(struct ntv2_hdmiin *ntv2_hin)
-{
-	if (ntv2_hin == NULL)
-		return -EPERM;
-
-	if (ntv2_hin->monitor_state != ntv2_task_state_enable)
-		return 0;
-
-	NTV2_MSG_HDMIIN_STATE("%s: disable hdmi input monitor\n", ntv2_hin->name);
-
-	if (ntv2_hin->monitor_task != NULL) {
-		kthread_stop(ntv2_hin->monitor_task);
-		ntv2_hin->monitor_task = NULL;
-	}
-
-	ntv2_hin->monitor_state = ntv2_task_state_disable;
-
-	return 0;
-}
-
-int ntv2_hdmiin_get_input_format(struct ntv2_hdmiin *ntv2_hin,
-								 struct ntv2_hdmiin_format *format)
-{
-	unsigned long flags;
-
-	if ((ntv2_hin == NULL) ||
-		(format == NULL))
-		return -EPERM;
-
-	spin_lock_irqsave(&ntv2_hin->state_lock, flags);
-	*format = ntv2_hin->input_format;
-	spin_unlock_irqrestore(&ntv2_hin->state_lock, flags);
-
-	return 0;
 }
 
 static int ntv2_hdmiin_monitor(void* data)
 {
 	struct ntv2_hdmiin *ntv2_hin = (struct ntv2_hdmiin *)data;
+	unsigned long flags;
+	u32 timeout;
+	bool irq;
 
 	if (ntv2_hin == NULL)
 		return -EPERM;
@@ -347,10 +437,26 @@ static int ntv2_hdmiin_monitor(void* data)
 	ntv2_hdmiin_initialize(ntv2_hin);
 
 	while(!kthread_should_stop()) {
+		spin_lock_irqsave(&ntv2_hin->state_lock, flags);
+		irq = ntv2_hin->irq_event;
+		ntv2_hin->irq_event = false;
+		spin_unlock_irqrestore(&ntv2_hin->state_lock, flags);
+
 		if (ntv2_hdmiin_periodic_update(ntv2_hin) < 0) {
 			ntv2_hdmiin_initialize(ntv2_hin);
 		}
-		msleep_interruptible(100);
+
+		/* receiver interrupts are cleared, take the next one */
+		if (irq)
+			ntv2_hdmi_input_interrupt_enable(ntv2_hin->vid_reg, true);
+
+		/* poll while acquiring, otherwise wait for the receiver interrupt */
+		timeout = MONITOR_POLL_TIME;
+		if (ntv2_hin->input_stable && ntv2_hin->irq_detect)
+			timeout = MONITOR_IDLE_TIME;
+		wait_event_interruptible_timeout(ntv2_hin->monitor_wait,
+										 ntv2_hin->irq_event || kthread_should_stop(),
+										 msecs_to_jiffies(timeout));
 	}
 
 	NTV2_MSG_HDMIIN_STATE("%s: hdmi input monitor task stop\n", ntv2_hin->name);
@@ -389,7 +495,8 @@ static int ntv2_hdmiin_initialize(struct ntv2_hdmiin *ntv2_hin)
 
 	/* reset the hdmi input chip */
 	ntv2_konai2c_set_device(i2c_reg, device_io_bank);
-	ntv2_konai2c_write(i2c_reg, 0xff, 0x80);
+	ntv2_hdmiin_write(ntv2_hin, 0xff, 0x80);
+	ntv2_hdmiin_shadow_reset(ntv2_hin);
 	usleep_range(50000, 50000);
 
 	/* configure hdmi input chip default state */
@@ -402,76 +509,264 @@ static int ntv2_hdmiin_initialize(struct ntv2_hdmiin *ntv2_hin)
 	if (res < 0)
 		goto bad_write;
 
-	/* continue config */
-	res = ntv2_hdmiin_write_multi(ntv2_hin, device_hdmi_bank, init_hdmi1, init_hdmi1_size);
+	/* read the reset state so only registers that differ are written */
+	if ((ntv2_hdmiin_shadow_load(ntv2_hin, device_io_bank) < 0) ||
+		(ntv2_hdmiin_shadow_load(ntv2_hin, device_hdmi_bank) < 0) ||
+		(ntv2_hdmiin_shadow_load(ntv2_hin, device_cp_bank) < 0) ||
+		(ntv2_hdmiin_shadow_load(ntv2_hin, device_repeater_bank) < 0) ||
+		(ntv2_hdmiin_shadow_load(ntv2_hin, device_dpll_bank) < 0) ||
+		((ntv2_hin->edid != NULL) &&
+		 (ntv2_hdmiin_shadow_load(ntv2_hin, device_edid_bank) < 0)))
+		goto bad_write;
+
+	/* queue the rest of the config as one batch, only idempotent tables are filtered */
+	res = ntv2_hdmiin_batch_add(ntv2_hin, device_hdmi_bank, init_hdmi1, init_hdmi1_size, true);
 	if (res < 0)
 		goto bad_write;
 	
-	res = ntv2_hdmiin_write_multi(ntv2_hin, device_io_bank, init_io2_non4k, init_io2_non4k_size);
+	res = ntv2_hdmiin_batch_add(ntv2_hin, device_io_bank, init_io2_non4k, init_io2_non4k_size, true);
 	if (res < 0)
 		goto bad_write;
 	ntv2_hin->i2c_color_default = 0xf2;  // must match init settings
   
-	res = ntv2_hdmiin_write_multi(ntv2_hin, device_cp_bank, init_cp3, init_cp3_size);
+	res = ntv2_hdmiin_batch_add(ntv2_hin, device_cp_bank, init_cp3, init_cp3_size, true);
 	if (res < 0)
 		goto bad_write;
 	
-	res = ntv2_hdmiin_write_multi(ntv2_hin, device_repeater_bank, init_rep4, init_rep4_size);
+	res = ntv2_hdmiin_batch_add(ntv2_hin, device_repeater_bank, init_rep4, init_rep4_size, true);
 	if (res < 0)
 		goto bad_write;
 	
-	res = ntv2_hdmiin_write_multi(ntv2_hin, device_dpll_bank, init_dpll5_non4k, init_dpll5_non4k_size);
+	res = ntv2_hdmiin_batch_add(ntv2_hin, device_dpll_bank, init_dpll5_non4k, init_dpll5_non4k_size, true);
 	if (res < 0)
 		goto bad_write;
 	
-	res = ntv2_hdmiin_write_multi(ntv2_hin, device_hdmi_bank, init_hdmi6, init_hdmi6_size);
+	res = ntv2_hdmiin_batch_add(ntv2_hin, device_hdmi_bank, init_hdmi6, init_hdmi6_size, false);
 	if (res < 0)
 		goto bad_write;
 
 	/* load edid */
 	if (ntv2_hin->edid != NULL) {
-		res = ntv2_hdmiin_write_edid(ntv2_hin, ntv2_hin->edid, device_edid_bank);
+		res = ntv2_hdmiin_batch_add_edid(ntv2_hin, ntv2_hin->edid, device_edid_bank);
 		if (res < 0)
 			goto bad_write;
 	}
 
 	/* final config */
-	res = ntv2_hdmiin_write_multi(ntv2_hin, device_hdmi_bank, init_hdmi8, init_hdmi8_size);
+	res = ntv2_hdmiin_batch_add(ntv2_hin, device_hdmi_bank, init_hdmi8, init_hdmi8_size, true);
 	if (res < 0)
 		goto bad_write;
 	ntv2_hin->i2c_hpa_default = 0x04;  // must match init settings
 
+	res = ntv2_hdmiin_batch_write(ntv2_hin);
+	if (res < 0)
+		goto bad_write;
+
 	/* hot plug */
 	ntv2_hdmiin_hot_plug(ntv2_hin);
 
 	return 0;
 
 bad_write:
+	ntv2_hin->i2c_num_ops = 0;
+	ntv2_hdmiin_shadow_reset(ntv2_hin);
 	return -EINVAL;
 }
 
+static int ntv2_hdmiin_batch_add(struct ntv2_hdmiin *ntv2_hin,
+								 u8 device,
+								 struct ntv2_reg_value *reg_value,
+								 int count,
+								 bool filter)
+{
+	struct ntv2_hdmiin_i2c_shadow *shadow;
+	int i;
+
+	if ((ntv2_hin->i2c_num_ops + count) > NTV2_HDMIIN_MAX_I2C_OPS) {
+		NTV2_MSG_HDMIIN_ERROR("%s: *error* i2c batch full  device %02x  count %d\n",
+							  ntv2_hin->name, device, count);
+		return -ENOSPC;
+	}
+
+	shadow = ntv2_hdmiin_shadow_find(ntv2_hin, device);
+	for (i = 0; i < count; i++) {
+		/* sequenced and self clearing writes always go out and leave the register unknown */
+		if (!filter) {
+			if (shadow != NULL)
+				clear_bit(reg_value[i].address, shadow->valid);
+			ntv2_hdmiin_batch_add_op(ntv2_hin, NULL, device,
+									 reg_value[i].address, reg_value[i].value);
+			continue;
+		}
+		ntv2_hdmiin_batch_add_op(ntv2_hin, shadow, device,
+								 reg_value[i].address, reg_value[i].value);
+	}
+
+	return 0;
+}
+
+static void ntv2_hdmiin_batch_add_op(struct ntv2_hdmiin *ntv2_hin,
+									 struct ntv2_hdmiin_i2c_shadow *shadow,
+									 u8 device, u8 address, u8 data)
+{
+	struct ntv2_konai2c_op *op;
+
+	/* skip writes that would not change the register */
+	if (shadow != NULL) {
+		if (test_bit(address, shadow->valid) &&
+			(shadow->value[address] == data))
+			return;
+		shadow->value[address] = data;
+		set_bit(address, shadow->valid);
+	}
+
+	op = &ntv2_hin->i2c_ops[ntv2_hin->i2c_num_ops++];
+	op->type = ntv2_konai2c_op_write;
+	op->device = device;
+	op->address = address;
+	op->data = data;
+}
+
+static int ntv2_hdmiin_batch_add_edid(struct ntv2_hdmiin *ntv2_hin,
+									  struct ntv2_hdmiedid *ntv2_edid,
+									  u8 device)
+{
+	struct ntv2_hdmiin_i2c_shadow *shadow;
+	u8* data = ntv2_hdmi_get_edid_data(ntv2_edid);
+	u32 size = ntv2_hdmi_get_edid_size(ntv2_edid);
+	u32 address = 0;
+
+	if ((size > NTV2_HDMIIN_I2C_REGS) ||
+		((ntv2_hin->i2c_num_ops + size) > NTV2_HDMIIN_MAX_I2C_OPS)) {
+		NTV2_MSG_HDMIIN_ERROR("%s: *error* i2c batch full  edid size %d\n",
+							  ntv2_hin->name, size);
+		return -ENOSPC;
+	}
+
+	shadow = ntv2_hdmiin_shadow_find(ntv2_hin, device);
+	for (address = 0; address < size; address++) {
+		ntv2_hdmiin_batch_add_op(ntv2_hin, shadow, device,
+								 (u8)address, data[address]);
+	}
+
+	return 0;
+}
+
+static int ntv2_hdmiin_batch_write(struct ntv2_hdmiin *ntv2_hin)
+{
+	struct ntv2_konai2c_batch batch;
+	struct ntv2_konai2c_op *op;
+	int res;
+
+	ntv2_konai2c_batch_init(&batch, ntv2_hin->i2c_ops, ntv2_hin->i2c_num_ops);
+	ntv2_hin->i2c_num_ops = 0;
+
+	if (batch.num_ops == 0)
+		return 0;
+
+	res = ntv2_konai2c_batch_submit(ntv2_hin->i2c_reg, &batch);
+	if (res >= 0)
+		res = ntv2_konai2c_batch_wait(ntv2_hin->i2c_reg, &batch, NTV2_HDMIIN_BATCH_TIMEOUT);
+	if (res < 0) {
+		/* register state is unknown after a failed batch */
+		ntv2_hdmiin_shadow_reset(ntv2_hin);
+		if ((batch.error_index >= 0) && (batch.error_index < batch.num_ops)) {
+			op = &batch.ops[batch.error_index];
+			NTV2_MSG_HDMIIN_ERROR("%s: *error* write batch failed  device %02x  address %02x\n",
+								  ntv2_hin->name, op->device, op->address);
+		} else {
+			NTV2_MSG_HDMIIN_ERROR("%s: *error* write batch failed\n", ntv2_hin->name);
+		}
+		return res;
+	}
+
+	return 0;
+}
+
 static int ntv2_hdmiin_write_multi(struct ntv2_hdmiin *ntv2_hin,
 								   u8 device,
 								   struct ntv2_reg_value *reg_value,
 								   int count)
 {
-	struct ntv2_konai2c *i2c_reg = ntv2_hin->i2c_reg;
+	int res;
+
+	res = ntv2_hdmiin_batch_add(ntv2_hin, device, reg_value, count, true);
+	if (res < 0) {
+		ntv2_hin->i2c_num_ops = 0;
+		ntv2_hdmiin_shadow_reset(ntv2_hin);
+		return res;
+	}
+
+	return ntv2_hdmiin_batch_write(ntv2_hin);
+}
+
+static struct ntv2_hdmiin_i2c_shadow *ntv2_hdmiin_shadow_find(struct ntv2_hdmiin *ntv2_hin, u8 device)
+{
 	int i;
+
+	for (i = 0; i < NTV2_HDMIIN_I2C_BANKS; i++) {
+		if ((ntv2_hin->i2c_shadow[i].device != 0) &&
+			(ntv2_hin->i2c_shadow[i].device == device))
+			return &ntv2_hin->i2c_shadow[i];
+	}
+
+	return NULL;
+}
+
+static int ntv2_hdmiin_shadow_load(struct ntv2_hdmiin *ntv2_hin, u8 device)
+{
+	struct ntv2_konai2c *i2c_reg = ntv2_hin->i2c_reg;
+	struct ntv2_hdmiin_i2c_shadow *shadow;
 	int res;
+	int i;
 
-	ntv2_konai2c_set_device(i2c_reg, device);
-	for (i = 0; i < count; i++) {
-		res = ntv2_konai2c_write(i2c_reg, reg_value[i].address, reg_value[i].value);
-		if (res < 0) {
-			NTV2_MSG_HDMIIN_ERROR("%s: *error* write multi failed  device %02x  address %02x\n",
-								  ntv2_hin->name, device, reg_value[i].address);
-			return res;
+	shadow = ntv2_hdmiin_shadow_find(ntv2_hin, device);
+	if (shadow == NULL) {
+		for (i = 0; i < NTV2_HDMIIN_I2C_BANKS; i++) {
+			if (ntv2_hin->i2c_shadow[i].device == 0) {
+				shadow = &ntv2_hin->i2c_shadow[i];
+				break;
+			}
 		}
+		if (shadow == NULL)
+			return -ENOSPC;
+	}
+
+	/* one i2c transaction reads the whole bank into the controller ram */
+	ntv2_konai2c_set_device(i2c_reg, device);
+	res = ntv2_konai2c_cache_update(i2c_reg);
+	if (res < 0) {
+		NTV2_MSG_HDMIIN_ERROR("%s: *error* shadow cache update failed  device %02x\n",
+							  ntv2_hin->name, device);
+		memset(shadow, 0, sizeof(struct ntv2_hdmiin_i2c_shadow));
+		return res;
 	}
 
+	shadow->device = device;
+	for (i = 0; i < NTV2_HDMIIN_I2C_REGS; i++)
+		shadow->value[i] = ntv2_konai2c_cache_read(i2c_reg, (u8)i);
+	bitmap_fill(shadow->valid, NTV2_HDMIIN_I2C_REGS);
+
 	return 0;
 }
 
+static void ntv2_hdmiin_shadow_reset(struct ntv2_hdmiin *ntv2_hin)
+{
+	memset(ntv2_hin->i2c_shadow, 0, sizeof(ntv2_hin->i2c_shadow));
+}
+
+static int ntv2_hdmiin_write(struct ntv2_hdmiin *ntv2_hin, u8 address, u8 data)
+{
+	struct ntv2_hdmiin_i2c_shadow *shadow;
+
+	/* direct writes are often actions (clears, toggles) so drop the shadow value */
+	shadow = ntv2_hdmiin_shadow_find(ntv2_hin, ntv2_konai2c_get_device(ntv2_hin->i2c_reg));
+	if (shadow != NULL)
+		clear_bit(address, shadow->valid);
+
+	return ntv2_konai2c_write(ntv2_hin->i2c_reg, address, data);
+}
+
 static int ntv2_hdmiin_read_verify(struct ntv2_hdmiin *ntv2_hin,
 								   u8 device,
 								   struct ntv2_reg_value *reg_value,
@@ -501,29 +796,6 @@ static int ntv2_hdmiin_read_verify(struct ntv2_hdmiin *ntv2_hin,
 	return 0;
 }
 
-static int ntv2_hdmiin_write_edid(struct ntv2_hdmiin *ntv2_hin,
-								  struct ntv2_hdmiedid *ntv2_edid,
-								  u8 device)
-{
-	struct ntv2_konai2c *i2c_reg = ntv2_hin->i2c_reg;
-	u8* data = ntv2_hdmi_get_edid_data(ntv2_edid);
-	u32 size = ntv2_hdmi_get_edid_size(ntv2_edid);
-	u32 address = 0;
-	int res;
-
-	ntv2_konai2c_set_device(i2c_reg, device);
-	for (address = 0; address < size; address++) {
-		res = ntv2_konai2c_write(i2c_reg, (u8)address, data[address]);
-		if (res < 0) {
-			NTV2_MSG_HDMIIN_ERROR("%s: *error* write edid failed  device %02x  address %02x\n",
-								  ntv2_hin->name, device, address);
-			return res;
-		}
-	}
-
-	return 0;
-}
-
 int ntv2_hdmiin_periodic_update(struct ntv2_hdmiin *ntv2_hin)
 {
 	struct ntv2_register *vid_reg;
@@ -546,6 +818,7 @@ int ntv2_hdmiin_periodic_update(struct ntv2_hdmiin *ntv2_hin)
 
 	vid_reg = ntv2_hin->vid_reg;
 	i2c_reg = ntv2_hin->i2c_reg;
+	ntv2_hin->input_stable = false;
 
 	/* read io bank */
 	ntv2_konai2c_set_device(i2c_reg, device_io_bank);
@@ -556,6 +829,14 @@ int ntv2_hdmiin_periodic_update(struct ntv2_hdmiin *ntv2_hin)
 			return res;
 	}
 
+	/* clear the interrupts not handled below so INT1 can release */
+	data = ntv2_konai2c_cache_read(i2c_reg, lock_interrupt_status_reg) & lock_interrupt_mask;
+	if (data != 0)
+		ntv2_hdmiin_write(ntv2_hin, lock_interrupt_clear_reg, data);
+	data = ntv2_konai2c_cache_read(i2c_reg, cable_interrupt_status_reg) & cable_interrupt_mask;
+	if (data != 0)
+		ntv2_hdmiin_write(ntv2_hin, cable_interrupt_clear_reg, data);
+
 	/* cable detect */
 	data = ntv2_konai2c_cache_read(i2c_reg, cable_detect_reg);
 	present = (data & cable_detect_mask) == cable_detect_mask;
@@ -573,6 +854,8 @@ int ntv2_hdmiin_periodic_update(struct ntv2_hdmiin *ntv2_hin)
 		ntv2_hdmiin_set_no_video(ntv2_hin);		
 		ntv2_hin->relock_reports = NTV2_REPORT_ANY;
 		ntv2_hin->relock_reports &= ~NTV2_REPORT_CABLE;
+		/* nothing to do until plugged */
+		ntv2_hin->input_stable = true;
 		return res;
 	}
 
@@ -580,7 +863,7 @@ int ntv2_hdmiin_periodic_update(struct ntv2_hdmiin *ntv2_hin)
 	data = ntv2_konai2c_cache_read(i2c_reg, tmds_lock_detect_reg);
 	tmds_lock_change = (data & tmds_lock_detect_mask) == tmds_lock_detect_mask;
 	if (tmds_lock_change) {
-		ntv2_konai2c_write(i2c_reg, tmds_lock_clear_reg, tmds_lock_clear_mask);
+		ntv2_hdmiin_write(ntv2_hin, tmds_lock_clear_reg, tmds_lock_clear_mask);
 		NTV2_MSG_HDMIIN_STATE("%s: tmds lock transition detected\n",
 							  ntv2_hin->name);
 		ntv2_hin->tmds_frequency = 0;
@@ -591,7 +874,7 @@ int ntv2_hdmiin_periodic_update(struct ntv2_hdmiin *ntv2_hin)
 	data = ntv2_konai2c_cache_read(i2c_reg, tmds_frequency_detect_reg);
 	tmds_frequency_change = (data & tmds_frequency_detect_mask) == tmds_frequency_detect_mask;
 	if (tmds_frequency_change) {
-		ntv2_konai2c_write(i2c_reg, tmds_frequency_clear_reg, tmds_frequency_clear_mask);
+		ntv2_hdmiin_write(ntv2_hin, tmds_frequency_clear_reg, tmds_frequency_clear_mask);
 		NTV2_MSG_HDMIIN_STATE("%s: tmds frequency transistion detected\n",
 							  ntv2_hin->name);
 		/* this happens on switch to uhd mode */
@@ -930,6 +1213,7 @@ int ntv2_hdmiin_periodic_update(struct ntv2_hdmiin *ntv2_hin)
 		ntv2_hin->relock_reports &= ~NTV2_REPORT_FORMAT;
 	}
 
+	ntv2_hin->input_stable = true;
 	return 0;
 
 bad_lock:
@@ -956,9 +1240,9 @@ static void ntv2_hdmiin_hot_plug(struct ntv2_hdmiin *ntv2_hin)
 {
 	ntv2_konai2c_set_device(ntv2_hin->i2c_reg, device_hdmi_bank);
 
-	ntv2_konai2c_write(ntv2_hin->i2c_reg, hdmi_hpa_reg, ntv2_hin->i2c_hpa_default | hdmi_hpa_manual_mask);
+	ntv2_hdmiin_write(ntv2_hin, hdmi_hpa_reg, ntv2_hin->i2c_hpa_default | hdmi_hpa_manual_mask);
 	msleep_interruptible(250);
-	ntv2_konai2c_write(ntv2_hin->i2c_reg, hdmi_hpa_reg, ntv2_hin->i2c_hpa_default & ~hdmi_hpa_manual_mask);
+	ntv2_hdmiin_write(ntv2_hin, hdmi_hpa_reg, ntv2_hin->i2c_hpa_default & ~hdmi_hpa_manual_mask);
 }
 
 static int ntv2_hdmiin_set_color_mode(struct ntv2_hdmiin *ntv2_hin, bool yuv_input, bool yuv_output)
@@ -967,20 +1251,20 @@ static int ntv2_hdmiin_set_color_mode(struct ntv2_hdmiin *ntv2_hin, bool yuv_inp
 
 	if (ntv2_hin->uhd_mode) {
 		if (yuv_input) {
-			ntv2_konai2c_write(ntv2_hin->i2c_reg, 0x03, 0x96);
+			ntv2_hdmiin_write(ntv2_hin, 0x03, 0x96);
 			ntv2_hin->yuv_mode = true;
 		} else {
-			ntv2_konai2c_write(ntv2_hin->i2c_reg, 0x03, 0x54);
+			ntv2_hdmiin_write(ntv2_hin, 0x03, 0x54);
 			ntv2_hin->yuv_mode = false;
 		}
 	} else {
 		if (yuv_output) {
-			ntv2_konai2c_write(ntv2_hin->i2c_reg, 0x02, (ntv2_hin->i2c_color_default & ~0x06) | 0x04);
-			ntv2_konai2c_write(ntv2_hin->i2c_reg, 0x03, 0x82);
+			ntv2_hdmiin_write(ntv2_hin, 0x02, (ntv2_hin->i2c_color_default & ~0x06) | 0x04);
+			ntv2_hdmiin_write(ntv2_hin, 0x03, 0x82);
 			ntv2_hin->yuv_mode = true;
 		} else {
-			ntv2_konai2c_write(ntv2_hin->i2c_reg, 0x02, (ntv2_hin->i2c_color_default & ~0x06) | 0x02);
-			ntv2_konai2c_write(ntv2_hin->i2c_reg, 0x03, 0x42);
+			ntv2_hdmiin_write(ntv2_hin, 0x02, (ntv2_hin->i2c_color_default & ~0x06) | 0x02);
+			ntv2_hdmiin_write(ntv2_hin, 0x03, 0x42);
 			ntv2_hin->yuv_mode = false;
 		}
 	}
@@ -995,22 +1279,25 @@ static int ntv2_hdmiin_set_uhd_mode(struct ntv2_hdmiin *ntv2_hin, bool enable)
 	if (enable)
 	{
 		NTV2_MSG_HDMIIN_STATE("%s: enable uhd mode\n", ntv2_hin->name);
-		res = ntv2_hdmiin_write_multi(ntv2_hin, device_io_bank, init_io2_4k, init_io2_4k_size);
-		if (res < 0)
-			return res;;
-		res = ntv2_hdmiin_write_multi(ntv2_hin, device_dpll_bank, init_dpll5_4k, init_dpll5_4k_size);
-		if (res < 0)
-			return res;;
+		res = ntv2_hdmiin_batch_add(ntv2_hin, device_io_bank, init_io2_4k, init_io2_4k_size, true);
+		if (res >= 0)
+			res = ntv2_hdmiin_batch_add(ntv2_hin, device_dpll_bank, init_dpll5_4k, init_dpll5_4k_size, true);
 	} else {
 		NTV2_MSG_HDMIIN_STATE("%s: disable uhd mode\n", ntv2_hin->name);
-		res = ntv2_hdmiin_write_multi(ntv2_hin, device_io_bank, init_io2_non4k, init_io2_non4k_size);
-		if (res < 0)
-			return res;;
-		res = ntv2_hdmiin_write_multi(ntv2_hin, device_dpll_bank, init_dpll5_non4k, init_dpll5_non4k_size);
-		if (res < 0)
-			return res;
+		res = ntv2_hdmiin_batch_add(ntv2_hin, device_io_bank, init_io2_non4k, init_io2_non4k_size, true);
+		if (res >= 0)
+			res = ntv2_hdmiin_batch_add(ntv2_hin, device_dpll_bank, init_dpll5_non4k, init_dpll5_non4k_size, true);
+	}
+	if (res < 0) {
+		ntv2_hin->i2c_num_ops = 0;
+		ntv2_hdmiin_shadow_reset(ntv2_hin);
+		return res;
 	}
 
+	res = ntv2_hdmiin_batch_write(ntv2_hin);
+	if (res < 0)
+		return res;
+
 	ntv2_hin->uhd_mode = enable;
 
 	return 0;
@@ -1023,7 +1310,7 @@ static int ntv2_hdmi_set_derep_mode(struct ntv2_hdmiin *ntv2_hin, bool enable)
 	NTV2_MSG_HDMIIN_STATE("%s: %s derep mode\n", ntv2_hin->name, enable? "enable" : "disable");
 
 	ntv2_konai2c_set_device(ntv2_hin->i2c_reg, device_hdmi_bank);
-	res = ntv2_konai2c_write(ntv2_hin->i2c_reg, 0x41, enable? 0x11 : 0x00);
+	res = ntv2_hdmiin_write(ntv2_hin, 0x41, enable? 0x11 : 0x00);
 	if (res < 0)
 		return res;
 
@@ -1057,36 +1344,36 @@ static void ntv2_hdmiin_config_pixel_clock(struct ntv2_hdmiin *ntv2_hin)
 	if (ntv2_hin->tmds_frequency <= TMDS_DOUBLING_FREQ)
 	{
 		/* adi required for TMDS frequency 27Mhz and below */
-		ntv2_konai2c_write(i2c_reg, 0x85, 0x11);
-		ntv2_konai2c_write(i2c_reg, 0x9C, 0x80);
-		ntv2_konai2c_write(i2c_reg, 0x9C, 0xC0);
-		ntv2_konai2c_write(i2c_reg, 0x9C, 0x00);
-		ntv2_konai2c_write(i2c_reg, 0x85, 0x11);
-		ntv2_konai2c_write(i2c_reg, 0x86, 0x9B);
-		ntv2_konai2c_write(i2c_reg, 0x9B, 0x03);
+		ntv2_hdmiin_write(ntv2_hin, 0x85, 0x11);
+		ntv2_hdmiin_write(ntv2_hin, 0x9C, 0x80);
+		ntv2_hdmiin_write(ntv2_hin, 0x9C, 0xC0);
+		ntv2_hdmiin_write(ntv2_hin, 0x9C, 0x00);
+		ntv2_hdmiin_write(ntv2_hin, 0x85, 0x11);
+		ntv2_hdmiin_write(ntv2_hin, 0x86, 0x9B);
+		ntv2_hdmiin_write(ntv2_hin, 0x9B, 0x03);
 
 		ntv2_konai2c_set_device(i2c_reg, device_io_bank);
-		ntv2_konai2c_write(i2c_reg, 0x19, 0xC0 | phase);
+		ntv2_hdmiin_write(ntv2_hin, 0x19, 0xC0 | phase);
 		ntv2_hin->pixel_double_mode = true;
 	}
 	else
 	{
 		/* adi required for TMDS frequency above 27Mhz */
-		ntv2_konai2c_write(i2c_reg, 0x85, 0x10);
-		ntv2_konai2c_write(i2c_reg, 0x9C, 0x80);
-		ntv2_konai2c_write(i2c_reg, 0x9C, 0xC0);
-		ntv2_konai2c_write(i2c_reg, 0x9C, 0x00);
-		ntv2_konai2c_write(i2c_reg, 0x85, 0x10);
-		ntv2_konai2c_write(i2c_reg, 0x86, 0x9B);
-		ntv2_konai2c_write(i2c_reg, 0x9B, 0x03);
+		ntv2_hdmiin_write(ntv2_hin, 0x85, 0x10);
+		ntv2_hdmiin_write(ntv2_hin, 0x9C, 0x80);
+		ntv2_hdmiin_write(ntv2_hin, 0x9C, 0xC0);
+		ntv2_hdmiin_write(ntv2_hin, 0x9C, 0x00);
+		ntv2_hdmiin_write(ntv2_hin, 0x85, 0x10);
+		ntv2_hdmiin_write(ntv2_hin, 0x86, 0x9B);
+		ntv2_hdmiin_write(ntv2_hin, 0x9B, 0x03);
 
 		ntv2_konai2c_set_device(i2c_reg, device_io_bank);
-		ntv2_konai2c_write(i2c_reg, 0x19, 0x80 | phase);
+		ntv2_hdmiin_write(ntv2_hin, 0x19, 0x80 | phase);
 		ntv2_hin->pixel_double_mode = false;
 	}
 
 	if (invert)
-		ntv2_konai2c_write(i2c_reg, 0x06, 0xa7);
+		ntv2_hdmiin_write(ntv2_hin, 0x06, 0xa7);
 }
 
 static u32 ntv2_hdmiin_read_paired_value(struct ntv2_hdmiin *ntv2_hin, u8 reg, u32 bits, u32 shift)
@@ -1535,7 +1822,7 @@ static int ntv2_hdmiin_set_video_format(struct ntv2_hdmiin *ntv2_hin,
 
 	/* enable hdmi to fpga link */
 	ntv2_konai2c_set_device(i2c_reg, device_io_bank);
-	ntv2_konai2c_write(i2c_reg, tristate_reg, tristate_enable_outputs);
+	ntv2_hdmiin_write(ntv2_hin, tristate_reg, tristate_enable_outputs);
 
 	/* setup fpga hdmi input data */
 	video_setup = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_video_mode, video_mode);
@@ -1634,7 +1921,7 @@ static void ntv2_hdmiin_set_no_video(struct ntv2_hdmiin *ntv2_hin)
 
 	/* disable hdmi to fpga link */
 	ntv2_konai2c_set_device(i2c_reg, device_io_bank);
-	ntv2_konai2c_write(i2c_reg, tristate_reg, tristate_disable_outputs);
+	ntv2_hdmiin_write(ntv2_hin, tristate_reg, tristate_disable_outputs);
 
 	/* clear fpga hdmi input data */
 	ntv2_reg_write(vid_reg, ntv2_kona_reg_hdmiin_video_setup, ntv2_hin->index, 0);
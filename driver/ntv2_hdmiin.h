@@ -26,8 +26,18 @@ struct ntv2_features;
 struct ntv2_register;
 struct ntv2_input_config;
 struct ntv2_konai2c;
+struct ntv2_konai2c_op;
 struct ntv2_hdmiedid;
 
+#define NTV2_HDMIIN_I2C_BANKS			8
+#define NTV2_HDMIIN_I2C_REGS			256
+
+struct ntv2_hdmiin_i2c_shadow {
+	u8								device;
+	u8								value[NTV2_HDMIIN_I2C_REGS];
+	DECLARE_BITMAP(valid, NTV2_HDMIIN_I2C_REGS);
+};
+
 struct ntv2_hdmiin_format {
 	u32								video_standard;
 	u32								frame_rate;
@@ -45,6 +55,9 @@ struct ntv2_hdmiin {
 	struct ntv2_features			*features;
 	struct ntv2_register			*vid_reg;
 	struct ntv2_konai2c				*i2c_reg;
+	struct ntv2_konai2c_op			*i2c_ops;
+	int								i2c_num_ops;
+	struct ntv2_hdmiin_i2c_shadow	i2c_shadow[NTV2_HDMIIN_I2C_BANKS];
 	struct ntv2_hdmiedid			*edid;
 	spinlock_t 						state_lock;
 
@@ -76,6 +89,7 @@ struct ntv2_hdmiin {
 	bool							audio_locked;
 	bool							avi_packet_present;
 	bool							vsi_packet_present;
+	bool							input_stable;
 
 	u32								h_active_pixels;
 	u32								h_total_pixels;
@@ -100,6 +114,9 @@ struct ntv2_hdmiin {
 
 	struct task_struct 				*monitor_task;
 	enum ntv2_task_state			monitor_state;
+	wait_queue_head_t				monitor_wait;
+	bool							irq_event;
+	bool							irq_detect;
 };
 
 struct ntv2_hdmiin *ntv2_hdmiin_open(struct ntv2_object *ntv2_obj,
@@ -117,6 +134,9 @@ int ntv2_hdmiin_disable(struct ntv2_hdmiin *ntv2_hin);
 int ntv2_hdmiin_get_input_format(struct ntv2_hdmiin *ntv2_hin,
 								 struct ntv2_hdmiin_format *format);
 
+int ntv2_hdmiin_interrupt(struct ntv2_hdmiin *ntv2_hin,
+						  struct ntv2_interrupt_status* irq_status);
+
 int ntv2_hdmiin_periodic_update(struct ntv2_hdmiin *ntv2_hin);
 
 #endif
@@ -189,6 +189,17 @@ static struct ntv2_hdmi_clock_data c_hdmi_clock_data[] = {
 	{ ntv2_clock_type_unknown, 0,       0,                                    0 }
 };
 
+/* format data timing hash and clock data line rate index (entry index + 1) */
+#define NTV2_HDMI_FORMAT_HASH_BITS		8
+#define NTV2_HDMI_FORMAT_HASH_SIZE		(1 << NTV2_HDMI_FORMAT_HASH_BITS)
+#define NTV2_HDMI_LINE_RATE_SIZE		32
+#define NTV2_HDMI_LINE_RATE_DEPTH		4
+
+static u8 c_hdmi_format_hash[NTV2_HDMI_FORMAT_HASH_SIZE];
+static u8 c_hdmi_clock_index[NTV2_HDMI_LINE_RATE_SIZE][NTV2_HDMI_LINE_RATE_DEPTH];
+static bool c_hdmi_index_init = false;
+static DEFINE_MUTEX(c_hdmi_index_mutex);
+
 
 static const u32 c_default_timeout		= 250;
 static const u32 c_redriver_time		= 10;
@@ -196,6 +207,7 @@ static const u32 c_plug_time			= 250;
 static const u32 c_lock_wait_max		= 2;
 static const u32 c_unlock_wait_max		= 4;
 static const u32 c_plug_wait_max		= 32;
+static const u32 c_idle_timeout			= 2000;
 
 
 static int ntv2_hdmiin4_monitor(void* data);
@@ -203,6 +215,7 @@ static void ntv2_hdmiin4_initialize(struct ntv2_hdmiin4 *ntv2_hin);
 
 static bool is_input_locked(struct ntv2_hdmiin4 *ntv2_hin);
 static bool is_deserializer_locked(struct ntv2_hdmiin4 *ntv2_hin);
+static bool is_cable_present(struct ntv2_hdmiin4 *ntv2_hin);
 static void reset_lock(struct ntv2_hdmiin4 *ntv2_hin);
 static void hot_plug(struct ntv2_hdmiin4 *ntv2_hin);
 static bool has_video_input_changed(struct ntv2_hdmiin4 *ntv2_hin);
@@ -212,6 +225,7 @@ static bool has_audio_control_changed(struct ntv2_hdmiin4 *ntv2_hin);
 static bool config_audio_control(struct ntv2_hdmiin4 *ntv2_hin);
 static void set_no_video(struct ntv2_hdmiin4 *ntv2_hin);
 static bool edid_write(struct ntv2_hdmiin4 *ntv2_hin, struct ntv2_hdmiedid* edid);
+static bool edid_match(struct ntv2_hdmiin4 *ntv2_hin, u8* data, u32 count);
 static bool edid_write_data(struct ntv2_hdmiin4 *ntv2_hin, u8 address, u8 data);
 static bool edid_read_data(struct ntv2_hdmiin4 *ntv2_hin, u8 address, u8* data);
 static bool edid_wait_not_busy(struct ntv2_hdmiin4 *ntv2_hin);
@@ -233,13 +247,16 @@ static struct ntv2_hdmi_format_data* find_format_data(u32 h_sync_start,
 													 enum ntv2_hdmi_clock_type	clockType);
 static struct ntv2_hdmi_clock_data* find_clock_data(u32 lineRate, u32 tmdsRate);
 static bool compare_tmds_rate(u32 tmdsRate, u32 tmdsRef);
+static u32 format_data_hash(struct ntv2_hdmi_format_data *data);
+static void build_data_index(void);
 
 struct ntv2_hdmiin4 *ntv2_hdmiin4_open(struct ntv2_object *ntv2_obj,
 									   const char *name, int index)
 {
 	struct ntv2_hdmiin4 *ntv2_hin = NULL;
 
-	ntv2_hin = kzalloc(sizeof(struct ntv2_hdmiin4), GFP_KERNEL);
+	ntv2_hin = kzalloc_node(sizeof(struct ntv2_hdmiin4), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_hin == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_hdmiin4 instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
@@ -251,6 +268,7 @@ struct ntv2_hdmiin4 *ntv2_hdmiin4_open(struct ntv2_object *ntv2_obj,
 	ntv2_hin->ntv2_dev = ntv2_obj->ntv2_dev;
 
 	spin_lock_init(&ntv2_hin->state_lock);
+	init_waitqueue_head(&ntv2_hin->monitor_wait);
 
 	NTV2_MSG_HDMIIN_INFO("%s: open ntv2_hdmiin4\n", ntv2_hin->name);
 
@@ -290,6 +308,14 @@ int ntv2_hdmiin4_configure(struct ntv2_hdmiin4 *ntv2_hin,
 	ntv2_hin->features = features;
 	ntv2_hin->vid_reg = vid_reg;
 
+	/* format lookup tables are shared by all inputs */
+	mutex_lock(&c_hdmi_index_mutex);
+	if (!c_hdmi_index_init) {
+		build_data_index();
+		c_hdmi_index_init = true;
+	}
+	mutex_unlock(&c_hdmi_index_mutex);
+
 	/* configure edid */
 	edid_type = ntv2_features_hdmi_edid_type(ntv2_hin->features, port_index);
 	if (edid_type != ntv2_edid_type_unknown) {
@@ -319,6 +345,9 @@ int ntv2_hdmiin4_enable(struct ntv2_hdmiin4 *ntv2_hin)
 
 	NTV2_MSG_HDMIIN_STATE("%s: enable hdmi input monitor\n", ntv2_hin->name);
 
+	ntv2_hin->irq_event = false;
+	ntv2_hin->irq_detect = false;
+
 	ntv2_hin->monitor_task = kthread_run(ntv2_hdmiin4_monitor, (void*)ntv2_hin, ntv2_hin->name);
 	if (IS_ERR(ntv2_hin->monitor_task)) {
 		ntv2_hin->monitor_task = NULL;
@@ -327,6 +356,12 @@ int ntv2_hdmiin4_enable(struct ntv2_hdmiin4 *ntv2_hin)
 
 	ntv2_hin->monitor_state = ntv2_task_state_enable;
 
+	/* only the first receiver is routed to the board interrupt */
+	if (ntv2_hin->index == 0) {
+		ntv2_hdmi_input_interrupt_clear(ntv2_hin->vid_reg);
+		ntv2_hdmi_input_interrupt_enable(ntv2_hin->vid_reg, true);
+	}
+
 	return 0;
 }
 
@@ -345,6 +380,10 @@ int ntv2_hdmiin4_disable(struct ntv2_hdmiin4 *ntv2_hin)
 		ntv2_hin->monitor_task = NULL;
 	}
 
+	/* the monitor may have unmasked it */
+	if (ntv2_hin->index == 0)
+		ntv2_hdmi_input_interrupt_enable(ntv2_hin->vid_reg, false);
+
 	ntv2_hin->monitor_state = ntv2_task_state_disable;
 
 	return 0;
@@ -366,15 +405,49 @@ int ntv2_hdmiin4_get_input_format(struct ntv2_hdmiin4 *ntv2_hin,
 	return 0;
 }
 
+int ntv2_hdmiin4_interrupt(struct ntv2_hdmiin4 *ntv2_hin,
+						   struct ntv2_interrupt_status* irq_status)
+{
+	unsigned long flags;
+
+	if ((ntv2_hin == NULL) ||
+		(irq_status == NULL))
+		return IRQ_NONE;
+
+	if ((ntv2_hin->index != 0) ||
+		(ntv2_hin->monitor_state != ntv2_task_state_enable))
+		return IRQ_NONE;
+
+	if (!ntv2_hdmi_input_interrupt_active(irq_status))
+		return IRQ_NONE;
+
+	/* mask until the monitor has checked the receiver */
+	ntv2_hdmi_input_interrupt_enable(ntv2_hin->vid_reg, false);
+	ntv2_hdmi_input_interrupt_clear(ntv2_hin->vid_reg);
+
+	spin_lock_irqsave(&ntv2_hin->state_lock, flags);
+	ntv2_hin->irq_event = true;
+	ntv2_hin->irq_detect = true;
+	spin_unlock_irqrestore(&ntv2_hin->state_lock, flags);
+
+	wake_up(&ntv2_hin->monitor_wait);
+
+	return IRQ_HANDLED;
+}
+
 static int ntv2_hdmiin4_monitor(void* data)
 {
 	struct ntv2_hdmiin4 *ntv2_hin = (struct ntv2_hdmiin4 *)data;
+	unsigned long flags;
 	u32 lockWait = 0;
 	u32 unlockWait = 0;
 	u32 plugWait = 0;
+	u32 timeout;
 	bool lock = false;
 	bool reset = false;
 	bool new_input = true;
+	bool idle;
+	bool irq;
 
 	if (ntv2_hin == NULL)
 		return 0;
@@ -385,6 +458,12 @@ static int ntv2_hdmiin4_monitor(void* data)
 
 	while(!kthread_should_stop())
 	{
+		spin_lock_irqsave(&ntv2_hin->state_lock, flags);
+		irq = ntv2_hin->irq_event;
+		ntv2_hin->irq_event = false;
+		spin_unlock_irqrestore(&ntv2_hin->state_lock, flags);
+		idle = false;
+
 		if (is_input_locked(ntv2_hin)) {
 			reset = false;
 			unlockWait = 0;
@@ -424,6 +503,8 @@ static int ntv2_hdmiin4_monitor(void* data)
 				}
 				new_input = false;
 			}
+
+			idle = (ntv2_hin->video_standard != ntv2_kona_video_standard_none);
 		} 
 		else {
 			lockWait = 0;
@@ -445,6 +526,13 @@ static int ntv2_hdmiin4_monitor(void* data)
 				reset = true;
 			}
 
+			/* no source to hot plug */
+			if (!is_cable_present(ntv2_hin)) {
+				plugWait = 0;
+				idle = true;
+				goto wait;
+			}
+
 			plugWait++;
 			if (plugWait > c_plug_wait_max) {
 				plugWait = 0;
@@ -453,7 +541,17 @@ static int ntv2_hdmiin4_monitor(void* data)
 		}
 
 	wait:
-		msleep_interruptible(c_default_timeout);
+		/* the receiver state has been read, take the next interrupt */
+		if (irq)
+			ntv2_hdmi_input_interrupt_enable(ntv2_hin->vid_reg, true);
+
+		/* poll while acquiring, otherwise wait for the receiver interrupt */
+		timeout = c_default_timeout;
+		if (idle && ntv2_hin->irq_detect)
+			timeout = c_idle_timeout;
+		wait_event_interruptible_timeout(ntv2_hin->monitor_wait,
+										 ntv2_hin->irq_event || kthread_should_stop(),
+										 msecs_to_jiffies(timeout));
 	}
 
 	NTV2_MSG_HDMIIN_STATE("%s: hdmi input monitor task stop\n", ntv2_hin->name);
@@ -547,6 +645,18 @@ static bool is_deserializer_locked(struct ntv2_hdmiin4 *ntv2_hin)
 	return false;
 }
 
+static bool is_cable_present(struct ntv2_hdmiin4 *ntv2_hin)
+{
+	struct ntv2_register *vid_reg = ntv2_hin->vid_reg;
+	u32 mask = NTV2_FLD_MASK(ntv2_kona_fld_hdmiin4_videocontrol_hdmi5vdetect);
+	u32 value;
+
+	value =  ntv2_reg_read(vid_reg, ntv2_kona_reg_hdmiin4_videocontrol, ntv2_hin->index);
+	if ((value & mask) == mask) return true;
+
+	return false;
+}
+
 static void reset_lock(struct ntv2_hdmiin4 *ntv2_hin)
 {
 	struct ntv2_register *vid_reg = ntv2_hin->vid_reg;
@@ -1113,29 +1223,53 @@ static struct ntv2_hdmi_format_data* find_format_data(u32 h_sync_start,
 													  u32 v_total_f2,
 													  enum ntv2_hdmi_clock_type clock_type)
 {
-	int i = 0;
-	while (c_hdmi_format_data[i].video_standard != ntv2_kona_video_standard_none)
+	struct ntv2_hdmi_format_data match;
+	struct ntv2_hdmi_format_data *data;
+	u32 slot;
+	int i;
+
+	memset(&match, 0, sizeof(match));
+	match.h_sync_start = h_sync_start;
+	match.h_sync_end = h_sync_end;
+	match.h_de_start = h_de_start;
+	match.h_total = h_total;
+	match.v_trans_f1 = v_trans_f1;
+	match.v_trans_f2 = v_trans_f2;
+	match.v_sync_start_f1 = v_sync_start_f1;
+	match.v_sync_end_f1 = v_sync_end_f1;
+	match.v_de_start_f1 = v_de_start_f1;
+	match.v_de_start_f2 = v_de_start_f2;
+	match.v_sync_start_f2 = v_sync_start_f2;
+	match.v_sync_end_f2 = v_sync_end_f2;
+	match.v_total_f1 = v_total_f1;
+	match.v_total_f2 = v_total_f2;
+	match.clock_type = clock_type;
+
+	/* walk the probe chain in table order */
+	slot = format_data_hash(&match);
+	while ((i = c_hdmi_format_hash[slot]) != 0)
 	{
+		data = &c_hdmi_format_data[i - 1];
 		if (
-			(h_sync_start == c_hdmi_format_data[i].h_sync_start) &&
-			(h_sync_end == c_hdmi_format_data[i].h_sync_end) &&
-			(h_de_start == c_hdmi_format_data[i].h_de_start) &&
-			(h_total == c_hdmi_format_data[i].h_total) &&
-			(v_trans_f1 == c_hdmi_format_data[i].v_trans_f1) &&
-			(v_trans_f2 == c_hdmi_format_data[i].v_trans_f2) &&
-			(v_sync_start_f1 == c_hdmi_format_data[i].v_sync_start_f1) &&
-			(v_sync_end_f1 == c_hdmi_format_data[i].v_sync_end_f1) &&
-			(v_de_start_f1 == c_hdmi_format_data[i].v_de_start_f1) &&
-			(v_de_start_f2 == c_hdmi_format_data[i].v_de_start_f2) &&
-			(v_sync_start_f2 == c_hdmi_format_data[i].v_sync_start_f2) &&
-			(v_sync_end_f2 == c_hdmi_format_data[i].v_sync_end_f2) &&
-			(v_total_f1 == c_hdmi_format_data[i].v_total_f1) &&
-			(v_total_f2 == c_hdmi_format_data[i].v_total_f2) &&
-			(clock_type == c_hdmi_format_data[i].clock_type))
+			(h_sync_start == data->h_sync_start) &&
+			(h_sync_end == data->h_sync_end) &&
+			(h_de_start == data->h_de_start) &&
+			(h_total == data->h_total) &&
+			(v_trans_f1 == data->v_trans_f1) &&
+			(v_trans_f2 == data->v_trans_f2) &&
+			(v_sync_start_f1 == data->v_sync_start_f1) &&
+			(v_sync_end_f1 == data->v_sync_end_f1) &&
+			(v_de_start_f1 == data->v_de_start_f1) &&
+			(v_de_start_f2 == data->v_de_start_f2) &&
+			(v_sync_start_f2 == data->v_sync_start_f2) &&
+			(v_sync_end_f2 == data->v_sync_end_f2) &&
+			(v_total_f1 == data->v_total_f1) &&
+			(v_total_f2 == data->v_total_f2) &&
+			(clock_type == data->clock_type))
 		{
-			return &c_hdmi_format_data[i];
+			return data;
 		}
-		i++;
+		slot = (slot + 1) & (NTV2_HDMI_FORMAT_HASH_SIZE - 1);
 	}
 
 	return NULL;
@@ -1143,20 +1277,93 @@ static struct ntv2_hdmi_format_data* find_format_data(u32 h_sync_start,
 
 static struct ntv2_hdmi_clock_data* find_clock_data(u32 lineRate, u32 tmdsRate)
 {
-	int i = 0;
-	while (c_hdmi_clock_data[i].clock_type != ntv2_clock_type_unknown)
+	int i;
+	int j;
+
+	if (lineRate >= NTV2_HDMI_LINE_RATE_SIZE)
+		return NULL;
+
+	for (j = 0; j < NTV2_HDMI_LINE_RATE_DEPTH; j++)
 	{
-		if ((lineRate == c_hdmi_clock_data[i].line_rate) &&
-			compare_tmds_rate(tmdsRate, c_hdmi_clock_data[i].tmds_rate))
+		i = c_hdmi_clock_index[lineRate][j];
+		if (i == 0)
+			break;
+		if (compare_tmds_rate(tmdsRate, c_hdmi_clock_data[i - 1].tmds_rate))
 		{
-			return &c_hdmi_clock_data[i];
+			return &c_hdmi_clock_data[i - 1];
 		}
-		i++;
 	}
 
 	return NULL;
 }
 
+static u32 format_data_hash(struct ntv2_hdmi_format_data *data)
+{
+	u32 key[15];
+
+	key[0] = data->h_sync_start;
+	key[1] = data->h_sync_end;
+	key[2] = data->h_de_start;
+	key[3] = data->h_total;
+	key[4] = data->v_trans_f1;
+	key[5] = data->v_trans_f2;
+	key[6] = data->v_sync_start_f1;
+	key[7] = data->v_sync_end_f1;
+	key[8] = data->v_de_start_f1;
+	key[9] = data->v_de_start_f2;
+	key[10] = data->v_sync_start_f2;
+	key[11] = data->v_sync_end_f2;
+	key[12] = data->v_total_f1;
+	key[13] = data->v_total_f2;
+	key[14] = data->clock_type;
+
+	return jhash2(key, ARRAY_SIZE(key), 0) & (NTV2_HDMI_FORMAT_HASH_SIZE - 1);
+}
+
+static void build_data_index(void)
+{
+	u32 slot;
+	u32 rate;
+	int i;
+	int j;
+
+	/* the hash must keep empty slots to end each probe chain */
+	BUILD_BUG_ON(ARRAY_SIZE(c_hdmi_format_data) >= NTV2_HDMI_FORMAT_HASH_SIZE / 2);
+	BUILD_BUG_ON(ARRAY_SIZE(c_hdmi_clock_data) > 255);
+
+	memset(c_hdmi_format_hash, 0, sizeof(c_hdmi_format_hash));
+	memset(c_hdmi_clock_index, 0, sizeof(c_hdmi_clock_index));
+
+	i = 0;
+	while (c_hdmi_format_data[i].video_standard != ntv2_kona_video_standard_none)
+	{
+		slot = format_data_hash(&c_hdmi_format_data[i]);
+		while (c_hdmi_format_hash[slot] != 0)
+			slot = (slot + 1) & (NTV2_HDMI_FORMAT_HASH_SIZE - 1);
+		c_hdmi_format_hash[slot] = i + 1;
+		i++;
+	}
+
+	i = 0;
+	while (c_hdmi_clock_data[i].clock_type != ntv2_clock_type_unknown)
+	{
+		rate = c_hdmi_clock_data[i].line_rate;
+		j = NTV2_HDMI_LINE_RATE_DEPTH;
+		if (rate < NTV2_HDMI_LINE_RATE_SIZE) {
+			for (j = 0; j < NTV2_HDMI_LINE_RATE_DEPTH; j++) {
+				if (c_hdmi_clock_index[rate][j] == 0) {
+					c_hdmi_clock_index[rate][j] = i + 1;
+					break;
+				}
+			}
+		}
+		if (j == NTV2_HDMI_LINE_RATE_DEPTH)
+			NTV2_MSG_ERROR("%s: *error* hdmi clock data %d not indexed\n",
+						   NTV2_MODULE_NAME, i);
+		i++;
+	}
+}
+
 static bool compare_tmds_rate(u32 tmdsRate, u32 tmdsRef)
 {
 	u32 tol = 15000;
@@ -1175,7 +1382,13 @@ static bool edid_write(struct ntv2_hdmiin4 *ntv2_hin, struct ntv2_hdmiedid* ntv2
 	u32 count = ntv2_hdmi_get_edid_size(ntv2_edid);
 	u32 address = 0;
 	u8 value;
-	
+
+	/* skip programming when the receiver already holds this edid */
+	if (edid_match(ntv2_hin, data, count)) {
+		NTV2_MSG_HDMIIN_STATE("%s: edid already programmed\n", ntv2_hin->name);
+		return true;
+	}
+
 	for (address = 0; address < count; address++) {
 		if (!edid_write_data(ntv2_hin, (u8)address, data[address])) {
 			NTV2_MSG_HDMIIN_ERROR("%s: *error* write edid failed  address %02x\n",
@@ -1200,6 +1413,27 @@ static bool edid_write(struct ntv2_hdmiin4 *ntv2_hin, struct ntv2_hdmiedid* ntv2
 	return true;
 }
 
+static bool edid_match(struct ntv2_hdmiin4 *ntv2_hin, u8* data, u32 count)
+{
+	u32 address;
+	u8 value;
+
+	/* block checksums first so a different edid misses quickly */
+	for (address = 127; address < count; address += 128) {
+		if (!edid_read_data(ntv2_hin, (u8)address, &value) ||
+			(value != data[address]))
+			return false;
+	}
+
+	for (address = 0; address < count; address++) {
+		if (!edid_read_data(ntv2_hin, (u8)address, &value) ||
+			(value != data[address]))
+			return false;
+	}
+
+	return true;
+}
+
 static bool edid_write_data(struct ntv2_hdmiin4 *ntv2_hin, u8 address, u8 data)
 {
 	struct ntv2_register *vid_reg = ntv2_hin->vid_reg;
@@ -77,6 +77,9 @@ struct ntv2_hdmiin4 {
 
 	struct task_struct 				*monitor_task;
 	enum ntv2_task_state			monitor_state;
+	wait_queue_head_t				monitor_wait;
+	bool							irq_event;
+	bool							irq_detect;
 };
 
 struct ntv2_hdmiin4 *ntv2_hdmiin4_open(struct ntv2_object *ntv2_obj,
@@ -94,6 +97,9 @@ int ntv2_hdmiin4_disable(struct ntv2_hdmiin4 *ntv2_hin);
 int ntv2_hdmiin4_get_input_format(struct ntv2_hdmiin4 *ntv2_hin,
 								  struct ntv2_hdmiin4_format *format);
 
+int ntv2_hdmiin4_interrupt(struct ntv2_hdmiin4 *ntv2_hin,
+						   struct ntv2_interrupt_status* irq_status);
+
 int ntv2_hdmiin4_periodic_update(struct ntv2_hdmiin4 *ntv2_hin);
 
 #endif
@@ -53,9 +53,17 @@ static const u8 tmds_lock_detect_mask			= 0x40;
 static const u8 tmds_lock_clear_reg				= 0x6c;
 static const u8 tmds_lock_clear_mask			= 0x40;
 
+static const u8 lock_interrupt_status_reg		= 0x6b;
+static const u8 lock_interrupt_clear_reg		= 0x6c;
+static const u8 lock_interrupt_mask				= 0x03;		/* v locked, de regen lock */
+
 static const u8 cable_detect_reg				= 0x6f;
 static const u8 cable_detect_mask				= 0x01;
 
+static const u8 cable_interrupt_status_reg		= 0x70;
+static const u8 cable_interrupt_clear_reg		= 0x71;
+static const u8 cable_interrupt_mask			= 0x01;
+
 static const u8 tmds_frequency_detect_reg		= 0x83;
 static const u8 tmds_frequency_detect_mask		= 0x02;
 
@@ -383,7 +391,11 @@ static struct ntv2_reg_value init_io2_non4k[] =
 	{ 0x33, 0x40 },		/* LLC DLL MUX enable */
 	{ 0xdd, 0x00 },		/* Normal LLC frequency = 0x00 for non-4K modes */
 						/* LLC Half frequence = 0xA0 for 4K modes */
-	{ 0x6e, 0x40 },		/* %%%%% TMDSPLL_LCK_A_MB1 enable to catch PLL loss of lock (enables INT1) */
+	{ 0x40, 0xc0 },		/* INTRQ_DUR_SEL[1:0], Address 0x40[7:6] = 11, INT1 active until cleared */
+						/* INTRQ_OP_SEL[1:0], Address 0x40[1:0] = 00, open drain */
+	{ 0x6e, 0x43 },		/* %%%%% TMDSPLL_LCK_A_MB1 enable to catch PLL loss of lock (enables INT1) */
+						/* V_LOCKED_MB1, DE_REGEN_LCK_MB1 enable to catch format changes */
+	{ 0x73, 0x01 },		/* CABLE_DET_A_MB1 enable to catch +5V plug and unplug */
 	{ 0x86, 0x02 } 		/* %%%%% NEW_TMDS_FREQ_MB1 enable to catch frequency changes */
 };
 static int init_io2_non4k_size = sizeof(init_io2_non4k) / sizeof(struct ntv2_reg_value);
@@ -24,7 +24,7 @@
 #include "ntv2_hdmiin4.h"
 #include "ntv2_register.h"
 
-#define NTV2_INPUT_LOCK_COUNT			3
+#define NTV2_INPUT_LOCK_COUNT			2
 #define NTV2_INPUT_UNLOCK_COUNT			2
 #define NTV2_INPUT_MONITOR_INTERVAL		100000
 
@@ -33,6 +33,8 @@ static void ntv2_input_monitor(struct timer_list *timer);
 #else
 static void ntv2_input_monitor(unsigned long data);
 #endif
+static void ntv2_input_frame_dpc(unsigned long data);
+static void ntv2_input_sdi_update(struct ntv2_input *ntv2_inp, int index);
 static bool ntv2_compare_sdi_input_status(struct ntv2_sdi_input_status *status_a,
 										  struct ntv2_sdi_input_status *status_b);
 static int ntv2_sdi_single_stream_to_format(struct ntv2_sdi_input_status *status,
@@ -41,9 +43,9 @@ static int ntv2_sdi_dual_stream_to_format(struct ntv2_sdi_input_status *status,
 										  struct ntv2_input_format *format);
 static int ntv2_sdi_quad_stream_to_format(struct ntv2_sdi_input_status *status,
 										  struct ntv2_input_format *format);
-static int ntv2_hdmi_stream_to_sqd_format(struct ntv2_input_config *config,
+static int ntv2_hdmi_stream_to_sqd_format(const struct ntv2_input_config *config,
 										  struct ntv2_input_format *format);
-static int ntv2_hdmi_stream_to_tsi_format(struct ntv2_input_config *config,
+static int ntv2_hdmi_stream_to_tsi_format(const struct ntv2_input_config *config,
 										  struct ntv2_input_format *format);
 static bool ntv2_valid_input_pixel_rate(u32 config_flags, u32 format_flags);
 
@@ -52,7 +54,8 @@ struct ntv2_input *ntv2_input_open(struct ntv2_object *ntv2_obj,
 {
 	struct ntv2_input *ntv2_inp = NULL;
 
-	ntv2_inp = kzalloc(sizeof(struct ntv2_input), GFP_KERNEL);
+	ntv2_inp = kzalloc_node(sizeof(struct ntv2_input), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_inp == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_input instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
@@ -73,6 +76,9 @@ struct ntv2_input *ntv2_input_open(struct ntv2_object *ntv2_obj,
 				ntv2_input_monitor,
 				(unsigned long)ntv2_inp);
 #endif
+	tasklet_init(&ntv2_inp->frame_dpc,
+				 ntv2_input_frame_dpc,
+				 (unsigned long)ntv2_inp);
 	
 	spin_lock_init(&ntv2_inp->state_lock);
 
@@ -92,6 +98,8 @@ void ntv2_input_close(struct ntv2_input *ntv2_inp)
 
 	ntv2_input_disable(ntv2_inp);
 
+	tasklet_kill(&ntv2_inp->frame_dpc);
+
 	for (i = 0; i < NTV2_MAX_HDMI_INPUTS; i++) {
 		if (ntv2_inp->hdmi0_input[i] != NULL)
 			ntv2_hdmiin_close(ntv2_inp->hdmi0_input[i]);
@@ -109,7 +117,7 @@ int ntv2_input_configure(struct ntv2_input *ntv2_inp,
 						 struct ntv2_features *features,
 						 struct ntv2_register *vid_reg)
 {
-	struct ntv2_input_config *input_config;
+	const struct ntv2_input_config *input_config;
 	int in0;
 	int in4;
 	int i;
@@ -235,19 +243,70 @@ int ntv2_input_disable(struct ntv2_input *ntv2_inp)
 			ntv2_hdmiin4_disable(ntv2_inp->hdmi4_input[i]);
 	}
 
-	/* stop the device monitor */
+	/* stop the device monitor and frame updates */
+	spin_lock_irqsave(&ntv2_inp->state_lock, flags);
+	ntv2_inp->monitor_state = ntv2_task_state_disable;
+	spin_unlock_irqrestore(&ntv2_inp->state_lock, flags);
+
 	del_timer_sync(&ntv2_inp->monitor_timer);
+	tasklet_kill(&ntv2_inp->frame_dpc);
 
 	spin_lock_irqsave(&ntv2_inp->state_lock, flags);
-	ntv2_inp->monitor_state = ntv2_task_state_disable;
+	ntv2_inp->frame_pending = 0;
 	memset(&ntv2_inp->sdi_input_state, 0, NTV2_MAX_SDI_INPUTS*sizeof(struct ntv2_sdi_input_state));
 	spin_unlock_irqrestore(&ntv2_inp->state_lock, flags);
 
 	return 0;
 }
 
+int ntv2_input_interrupt(struct ntv2_input *ntv2_inp,
+						 struct ntv2_interrupt_status* irq_status)
+{
+	int result = IRQ_NONE;
+	unsigned long pending = 0;
+	int res;
+	int i;
+
+	if ((ntv2_inp == NULL) ||
+		(irq_status == NULL))
+		return IRQ_NONE;
+
+	/* sample sdi inputs on the vertical edge (the channel clears the interrupt) */
+	for (i = 0; i < ntv2_inp->num_sdi_inputs; i++) {
+		if (ntv2_video_input_interrupt_active(irq_status, i) &&
+			(ntv2_video_input_field_id(irq_status, i) == 0))
+			pending |= BIT(i);
+	}
+	if (pending != 0) {
+		spin_lock(&ntv2_inp->state_lock);
+		if (ntv2_inp->monitor_state == ntv2_task_state_enable) {
+			ntv2_inp->frame_pending |= pending;
+			tasklet_schedule(&ntv2_inp->frame_dpc);
+		}
+		spin_unlock(&ntv2_inp->state_lock);
+	}
+
+	/* wake the hdmi input monitors */
+	for (i = 0; i < NTV2_MAX_HDMI_INPUTS; i++) {
+		if (ntv2_inp->hdmi0_input[i] != NULL) {
+			res = ntv2_hdmiin_interrupt(ntv2_inp->hdmi0_input[i], irq_status);
+			if (res == IRQ_HANDLED)
+				result = IRQ_HANDLED;
+		}
+	}
+	for (i = 0; i < NTV2_MAX_HDMI_INPUTS; i++) {
+		if (ntv2_inp->hdmi4_input[i] != NULL) {
+			res = ntv2_hdmiin4_interrupt(ntv2_inp->hdmi4_input[i], irq_status);
+			if (res == IRQ_HANDLED)
+				result = IRQ_HANDLED;
+		}
+	}
+
+	return result;
+}
+
 int ntv2_input_set_timecode_dbb(struct ntv2_input *ntv2_inp,
-								struct ntv2_input_config *config,
+								const struct ntv2_input_config *config,
 								u32 dbb)
 {
 	u32 val;
@@ -268,7 +327,7 @@ int ntv2_input_set_timecode_dbb(struct ntv2_input *ntv2_inp,
 }
 
 int ntv2_input_get_input_format(struct ntv2_input *ntv2_inp,
-								struct ntv2_input_config *config,
+								const struct ntv2_input_config *config,
 								struct ntv2_input_format *format)
 {
 	struct ntv2_sdi_input_status status[4];
@@ -382,7 +441,7 @@ done:
 }
 
 int ntv2_input_get_source_format(struct ntv2_input *ntv2_inp,
-								 struct ntv2_source_config *config,
+								 const struct ntv2_source_config *config,
 								 struct ntv2_source_format *format)
 {
 	struct ntv2_sdi_input_status status[4];
@@ -510,81 +569,128 @@ static void ntv2_input_monitor(unsigned long data)
 	struct ntv2_input *ntv2_inp = (struct ntv2_input *)data;
 #endif	
 	struct ntv2_sdi_input_state *state;
-	struct ntv2_sdi_input_status input;
+	unsigned long interval;
 	unsigned long flags;
-	bool unlock;
-	bool lock;
+	bool framed;
 	int i;
 
 	if (ntv2_inp == NULL)
 		return;
 
+	interval = usecs_to_jiffies(NTV2_INPUT_MONITOR_INTERVAL);
+
 	for (i = 0; i < ntv2_inp->num_sdi_inputs; i++) {
 		state = &ntv2_inp->sdi_input_state[i];
-		unlock = false;
-		lock = false;
 
-		/* get sdi input status from hardware */
-		ntv2_read_sdi_input_status(ntv2_inp->vid_reg, i, &input);
-/*
-		NTV2_MSG_INPUT_STATE("%s: sdi input %d status  %d %d %d %d %d %08x %08x\n",
-							 ntv2_inp->name, i,
-							 input.frame_rate,
-							 input.input_geometry,
-							 (int)input.progressive,
-							 (int)input.is3g,
-							 (int)input.is3gb,
-							 input.vpid_ds1,
-							 input.vpid_ds2);
-*/
-		/* check for unlock */
-		if (!ntv2_compare_sdi_input_status(&input, &state->lock_status)) {
-			if (state->unlock_count < NTV2_INPUT_UNLOCK_COUNT) {
-				state->unlock_count++;
-				unlock = state->unlock_count >= NTV2_INPUT_UNLOCK_COUNT;
-			}
-		} else {
-			state->unlock_count = 0;
-		}
+		/* skip inputs sampled by vertical interrupts */
+		spin_lock_irqsave(&ntv2_inp->state_lock, flags);
+		framed = (state->frame_jiffies != 0) &&
+			time_before(jiffies, state->frame_jiffies + interval);
+		spin_unlock_irqrestore(&ntv2_inp->state_lock, flags);
+		if (framed)
+			continue;
 
-		/* check for new lock */
-		if (ntv2_compare_sdi_input_status(&input, &state->last_status)) {
-			if (state->lock_count < NTV2_INPUT_LOCK_COUNT) {
-				state->lock_count++;
-				lock = state->lock_count >= NTV2_INPUT_LOCK_COUNT;
-			}
-		} else {
-			state->lock_count = 0;
-		}
+		ntv2_input_sdi_update(ntv2_inp, i);
+	}
+	
+	/* restart timer */
+	mod_timer(&ntv2_inp->monitor_timer, jiffies + interval);
+}
+
+static void ntv2_input_frame_dpc(unsigned long data)
+{
+	struct ntv2_input *ntv2_inp = (struct ntv2_input *)data;
+	unsigned long pending;
+	unsigned long flags;
+	int i;
 
-		/* save for next time */
-		state->last_status = input;
+	if (ntv2_inp == NULL)
+		return;
 
-		/* update lock */
-		spin_lock_irqsave(&ntv2_inp->state_lock, flags);
+	spin_lock_irqsave(&ntv2_inp->state_lock, flags);
+	pending = ntv2_inp->frame_pending;
+	ntv2_inp->frame_pending = 0;
+	for (i = 0; i < ntv2_inp->num_sdi_inputs; i++) {
+		if ((pending & BIT(i)) != 0)
+			ntv2_inp->sdi_input_state[i].frame_jiffies = jiffies | 1;
+	}
+	spin_unlock_irqrestore(&ntv2_inp->state_lock, flags);
 
-		if (state->locked && unlock) {
+	for (i = 0; i < ntv2_inp->num_sdi_inputs; i++) {
+		if ((pending & BIT(i)) != 0)
+			ntv2_input_sdi_update(ntv2_inp, i);
+	}
+}
+
+static void ntv2_input_sdi_update(struct ntv2_input *ntv2_inp, int index)
+{
+	struct ntv2_sdi_input_state *state = &ntv2_inp->sdi_input_state[index];
+	struct ntv2_sdi_input_status input;
+	unsigned long flags;
+	bool relock;
+
+	/* sample and evaluate under the lock since the timer and frame dpc may race */
+	spin_lock_irqsave(&ntv2_inp->state_lock, flags);
+
+	if (ntv2_inp->monitor_state != ntv2_task_state_enable) {
+		spin_unlock_irqrestore(&ntv2_inp->state_lock, flags);
+		return;
+	}
+
+	/* get sdi input status from hardware */
+	ntv2_read_sdi_input_status(ntv2_inp->vid_reg, index, &input);
+/*
+	NTV2_MSG_INPUT_STATE("%s: sdi input %d status  %d %d %d %d %d %08x %08x\n",
+						 ntv2_inp->name, index,
+						 input.frame_rate,
+						 input.input_geometry,
+						 (int)input.progressive,
+						 (int)input.is3g,
+						 (int)input.is3gb,
+						 input.vpid_ds1,
+						 input.vpid_ds2);
+*/
+	/* count consecutive consistent samples */
+	if (ntv2_compare_sdi_input_status(&input, &state->last_status)) {
+		if (state->lock_count < NTV2_INPUT_LOCK_COUNT)
+			state->lock_count++;
+	} else {
+		state->lock_count = (input.frame_rate != ntv2_kona_frame_rate_none)? 1 : 0;
+	}
+
+	/* save for next time */
+	state->last_status = input;
+
+	/* publish a new format as soon as it is consistent */
+	if ((state->lock_count >= NTV2_INPUT_LOCK_COUNT) &&
+		(!state->locked || !ntv2_compare_sdi_input_status(&input, &state->lock_status))) {
+		relock = state->locked;
+		state->locked = true;
+		state->changed = true;
+		state->unlock_count = 0;
+		state->lock_status = input;
+		NTV2_MSG_INPUT_STATE("%s: sdi input %d %s  %s%s @ %s fps\n",
+							 ntv2_inp->name, index,
+							 relock? "changed" : "locked",
+							 ntv2_input_geometry_name(state->lock_status.input_geometry),
+							 ((state->lock_status.progressive != 0)?"p":"i"),
+							 ntv2_frame_rate_name(state->lock_status.frame_rate));
+	}
+
+	/* check for unlock */
+	if (!ntv2_compare_sdi_input_status(&input, &state->lock_status)) {
+		if (state->unlock_count < NTV2_INPUT_UNLOCK_COUNT)
+			state->unlock_count++;
+		if (state->locked && (state->unlock_count >= NTV2_INPUT_UNLOCK_COUNT)) {
 			state->locked = false;
 			state->changed = true;
-			NTV2_MSG_INPUT_STATE("%s: sdi input %d unlocked\n", ntv2_inp->name, i);
+			NTV2_MSG_INPUT_STATE("%s: sdi input %d unlocked\n", ntv2_inp->name, index);
 		}
-		if (!state->locked && lock) {
-			state->locked = true;
-			state->changed = true;
-			state->lock_status = input;
-			NTV2_MSG_INPUT_STATE("%s: sdi input %d locked  %s%s @ %s fps\n",
-								 ntv2_inp->name, i,
-								 ntv2_input_geometry_name(state->lock_status.input_geometry),
-								 ((state->lock_status.progressive != 0)?"p":"i"),
-								 ntv2_frame_rate_name(state->lock_status.frame_rate));
-		}
-
-		spin_unlock_irqrestore(&ntv2_inp->state_lock, flags);
+	} else {
+		state->unlock_count = 0;
 	}
-	
-	/* restart timer */
-	mod_timer(&ntv2_inp->monitor_timer, jiffies +
-			  usecs_to_jiffies(NTV2_INPUT_MONITOR_INTERVAL));
+
+	spin_unlock_irqrestore(&ntv2_inp->state_lock, flags);
 }
 
 static bool ntv2_compare_sdi_input_status(struct ntv2_sdi_input_status *status_a,
@@ -884,7 +990,7 @@ bad_status:
 	return -EINVAL;
 }
 
-static int ntv2_hdmi_stream_to_sqd_format(struct ntv2_input_config *config,
+static int ntv2_hdmi_stream_to_sqd_format(const struct ntv2_input_config *config,
 										  struct ntv2_input_format *format)
 {
 	/* test for valid pixel rate */
@@ -907,7 +1013,7 @@ static int ntv2_hdmi_stream_to_sqd_format(struct ntv2_input_config *config,
 	return 0;
 }
 
-static int ntv2_hdmi_stream_to_tsi_format(struct ntv2_input_config *config,
+static int ntv2_hdmi_stream_to_tsi_format(const struct ntv2_input_config *config,
 										  struct ntv2_input_format *format)
 {
 	/* test for valid pixel rate */
@@ -34,6 +34,7 @@ struct ntv2_sdi_input_state {
 	struct ntv2_sdi_input_status	last_status;
 	int								lock_count;
 	int								unlock_count;
+	unsigned long					frame_jiffies;
 	bool							locked;
 	bool							changed;
 };
@@ -47,6 +48,8 @@ struct ntv2_input {
 	struct ntv2_features			*features;
 	struct ntv2_register			*vid_reg;
 	struct timer_list 				monitor_timer;
+	struct tasklet_struct			frame_dpc;
+	unsigned long					frame_pending;
 	spinlock_t 						state_lock;
 	enum ntv2_task_state			monitor_state;
 
@@ -73,16 +76,19 @@ int ntv2_input_configure(struct ntv2_input *ntv2_inp,
 int ntv2_input_enable(struct ntv2_input *ntv2_inp);
 int ntv2_input_disable(struct ntv2_input *ntv2_inp);
 
+int ntv2_input_interrupt(struct ntv2_input *ntv2_inp,
+						 struct ntv2_interrupt_status* irq_status);
+
 int ntv2_input_set_timecode_dbb(struct ntv2_input *ntv2_inp,
-								struct ntv2_input_config *config,
+								const struct ntv2_input_config *config,
 								u32 dbb);
 
 int ntv2_input_get_input_format(struct ntv2_input *ntv2_inp,
-								struct ntv2_input_config *config,
+								const struct ntv2_input_config *config,
 								struct ntv2_input_format *format);
 
 int ntv2_input_get_source_format(struct ntv2_input *ntv2_inp,
-								 struct ntv2_source_config *config,
+								 const struct ntv2_source_config *config,
 								 struct ntv2_source_format *format);
 
 #endif	
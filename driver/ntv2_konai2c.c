@@ -30,20 +30,31 @@
 #define NTV2_READ_TIME_MAX		10000
 #define NTV2_RESET_TIME_MIN		1000
 #define NTV2_RESET_TIME_MAX		10000
+#define NTV2_BATCH_TIMEOUT		10000
+#define NTV2_BATCH_TIME_MIN		20
+#define NTV2_BATCH_TIME_MAX		50
 
 static const u8		ntv2_subaddress_all = 0xff;
 
 static int ntv2_konai2c_wait_for_busy(struct ntv2_konai2c *ntv2_i2c, u32 timeout);
 static int ntv2_konai2c_wait_for_write(struct ntv2_konai2c *ntv2_i2c, u32 timeout);
 static int ntv2_konai2c_wait_for_read(struct ntv2_konai2c *ntv2_i2c, u32 timeout);
+static int ntv2_konai2c_wait_for_idle(struct ntv2_konai2c *ntv2_i2c, u32 timeout);
 static void ntv2_konai2c_reset(struct ntv2_konai2c *ntv2_i2c);
+static void ntv2_konai2c_issue_write(struct ntv2_konai2c *ntv2_i2c, u8 device, u8 address, u8 data);
+static int ntv2_konai2c_issue_update(struct ntv2_konai2c *ntv2_i2c, u8 device);
+static u8 ntv2_konai2c_issue_read(struct ntv2_konai2c *ntv2_i2c, u8 device, u8 address);
+static void ntv2_konai2c_batch_task(struct work_struct *work);
+static void ntv2_konai2c_batch_run(struct ntv2_konai2c *ntv2_i2c,
+								   struct ntv2_konai2c_batch *batch);
 
 struct ntv2_konai2c *ntv2_konai2c_open(struct ntv2_object *ntv2_obj,
 									   const char *name, int index)
 {
 	struct ntv2_konai2c *ntv2_i2c = NULL;
 
-	ntv2_i2c = kzalloc(sizeof(struct ntv2_konai2c), GFP_KERNEL);
+	ntv2_i2c = kzalloc_node(sizeof(struct ntv2_konai2c), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_i2c == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_konai2c instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
@@ -54,14 +65,39 @@ struct ntv2_konai2c *ntv2_konai2c_open(struct ntv2_object *ntv2_obj,
 	INIT_LIST_HEAD(&ntv2_i2c->list);
 	ntv2_i2c->ntv2_dev = ntv2_obj->ntv2_dev;
 
+	mutex_init(&ntv2_i2c->io_mutex);
+	spin_lock_init(&ntv2_i2c->batch_lock);
+	INIT_LIST_HEAD(&ntv2_i2c->batch_list);
+	INIT_WORK(&ntv2_i2c->batch_work, ntv2_konai2c_batch_task);
+
 	return ntv2_i2c;
 }
 
 void ntv2_konai2c_close(struct ntv2_konai2c *ntv2_i2c)
 {
+	struct ntv2_konai2c_batch *batch;
+	unsigned long flags;
+
 	if (ntv2_i2c == NULL)
 		return;
 
+	/* stop the batch engine */
+	spin_lock_irqsave(&ntv2_i2c->batch_lock, flags);
+	ntv2_i2c->batch_enable = false;
+	spin_unlock_irqrestore(&ntv2_i2c->batch_lock, flags);
+
+	cancel_work_sync(&ntv2_i2c->batch_work);
+
+	/* fail batches that never ran */
+	spin_lock_irqsave(&ntv2_i2c->batch_lock, flags);
+	while (!list_empty(&ntv2_i2c->batch_list)) {
+		batch = list_first_entry(&ntv2_i2c->batch_list, struct ntv2_konai2c_batch, list);
+		list_del_init(&batch->list);
+		batch->result = -ECANCELED;
+		complete(&batch->done);
+	}
+	spin_unlock_irqrestore(&ntv2_i2c->batch_lock, flags);
+
 	memset(ntv2_i2c, 0, sizeof(struct ntv2_konai2c));
 	kfree(ntv2_i2c);
 }
@@ -84,6 +120,7 @@ int ntv2_konai2c_configure(struct ntv2_konai2c *ntv2_i2c,
 	ntv2_i2c->kona_reg = ntv2_reg;
 	ntv2_i2c->kona_control = control;
 	ntv2_i2c->kona_data = data;
+	ntv2_i2c->batch_enable = true;
 
 	return 0;
 }
@@ -95,11 +132,15 @@ void ntv2_konai2c_set_device(struct ntv2_konai2c *ntv2_i2c, u8 device)
 	if (ntv2_i2c == NULL)
 		return;
 
+	mutex_lock(&ntv2_i2c->io_mutex);
+
 	ntv2_i2c->i2c_device = device;
 
 	val = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_device_address, ntv2_i2c->i2c_device);
 	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmiin_read_disable, 1);
 	ntv2_register_write(ntv2_i2c->kona_reg, ntv2_i2c->kona_control, val);
+
+	mutex_unlock(&ntv2_i2c->io_mutex);
 }
 
 u8 ntv2_konai2c_get_device(struct ntv2_konai2c *ntv2_i2c)
@@ -112,7 +153,6 @@ u8 ntv2_konai2c_get_device(struct ntv2_konai2c *ntv2_i2c)
 
 int ntv2_konai2c_write(struct ntv2_konai2c *ntv2_i2c, u8 address, u8 data)
 {
-	u32 val;
 	int res;
 
 	if (ntv2_i2c == NULL)
@@ -121,28 +161,23 @@ int ntv2_konai2c_write(struct ntv2_konai2c *ntv2_i2c, u8 address, u8 data)
 	NTV2_MSG_KONAI2C_WRITE("%s: write dev %02x  add %02x  data %02x\n",
 						   ntv2_i2c->name, ntv2_i2c->i2c_device, address, data);
 
+	mutex_lock(&ntv2_i2c->io_mutex);
+
 	res = ntv2_konai2c_wait_for_busy(ntv2_i2c, NTV2_BUSY_TIMEOUT);
 	if (res < 0)
-		return res;
+		goto done;
 
-	val = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_device_address, ntv2_i2c->i2c_device);
-	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmiin_subaddress, address);
-	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmiin_read_disable, 1);
-	ntv2_register_write(ntv2_i2c->kona_reg, ntv2_i2c->kona_control, val);
-
-	val = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_data_out, data);
-	ntv2_register_write(ntv2_i2c->kona_reg, ntv2_i2c->kona_data, val);
+	ntv2_konai2c_issue_write(ntv2_i2c, ntv2_i2c->i2c_device, address, data);
 
 	res = ntv2_konai2c_wait_for_write(ntv2_i2c, NTV2_WRITE_TIMEOUT);
-	if (res < 0)
-		return res;
 
-	return 0;
+done:
+	mutex_unlock(&ntv2_i2c->io_mutex);
+	return (res < 0)? res : 0;
 }
 
 int ntv2_konai2c_cache_update(struct ntv2_konai2c *ntv2_i2c)
 {
-	u32 val;
 	int res;
 
 	if (ntv2_i2c == NULL)
@@ -151,12 +186,215 @@ int ntv2_konai2c_cache_update(struct ntv2_konai2c *ntv2_i2c)
 	NTV2_MSG_KONAI2C_READ("%s: update device %02x read cache\n",
 						  ntv2_i2c->name, ntv2_i2c->i2c_device);
 
+	mutex_lock(&ntv2_i2c->io_mutex);
+
 	res = ntv2_konai2c_wait_for_busy(ntv2_i2c, NTV2_BUSY_TIMEOUT);
-	if (res < 0)
+	if (res >= 0)
+		res = ntv2_konai2c_issue_update(ntv2_i2c, ntv2_i2c->i2c_device);
+
+	mutex_unlock(&ntv2_i2c->io_mutex);
+	return res;
+}
+
+u8 ntv2_konai2c_cache_read(struct ntv2_konai2c *ntv2_i2c, u8 address)
+{
+	u8 data;
+	int res;
+
+	if (ntv2_i2c == NULL)
+		return 0;
+
+	mutex_lock(&ntv2_i2c->io_mutex);
+
+	res = ntv2_konai2c_wait_for_busy(ntv2_i2c, NTV2_BUSY_TIMEOUT);
+	if (res < 0) {
+		mutex_unlock(&ntv2_i2c->io_mutex);
+		NTV2_MSG_KONAI2C_ERROR("%s: *error* read dev %02x  address %02x  failed\n",
+							   ntv2_i2c->name, ntv2_i2c->i2c_device, address);
 		return res;
+	}
+
+	data = ntv2_konai2c_issue_read(ntv2_i2c, ntv2_i2c->i2c_device, address);
+
+	mutex_unlock(&ntv2_i2c->io_mutex);
+	return data;
+}
+
+int ntv2_konai2c_rmw(struct ntv2_konai2c *ntv2_i2c, u8 address, u8 data, u8 mask)
+{
+	u8 val;
+
+	val = ntv2_konai2c_cache_read(ntv2_i2c, address);
+	val = (val & (~mask)) | (data & mask);
+	return ntv2_konai2c_write(ntv2_i2c, address, val);
+}
+
+void ntv2_konai2c_batch_init(struct ntv2_konai2c_batch *batch,
+							 struct ntv2_konai2c_op *ops,
+							 int num_ops)
+{
+	if (batch == NULL)
+		return;
+
+	INIT_LIST_HEAD(&batch->list);
+	batch->ops = ops;
+	batch->num_ops = num_ops;
+	batch->result = 0;
+	batch->error_index = -1;
+	init_completion(&batch->done);
+}
+
+int ntv2_konai2c_batch_submit(struct ntv2_konai2c *ntv2_i2c,
+							  struct ntv2_konai2c_batch *batch)
+{
+	unsigned long flags;
+
+	if ((ntv2_i2c == NULL) ||
+		(batch == NULL))
+		return -EPERM;
+
+	if ((batch->num_ops < 0) ||
+		((batch->num_ops > 0) && (batch->ops == NULL)))
+		return -EINVAL;
+
+	spin_lock_irqsave(&ntv2_i2c->batch_lock, flags);
+	if (!ntv2_i2c->batch_enable) {
+		spin_unlock_irqrestore(&ntv2_i2c->batch_lock, flags);
+		return -EPERM;
+	}
+	list_add_tail(&batch->list, &ntv2_i2c->batch_list);
+	spin_unlock_irqrestore(&ntv2_i2c->batch_lock, flags);
+
+	schedule_work(&ntv2_i2c->batch_work);
+
+	return 0;
+}
+
+int ntv2_konai2c_batch_wait(struct ntv2_konai2c *ntv2_i2c,
+							struct ntv2_konai2c_batch *batch,
+							u32 timeout)
+{
+	unsigned long flags;
+	bool queued;
+
+	if ((ntv2_i2c == NULL) ||
+		(batch == NULL))
+		return -EPERM;
+
+	if (wait_for_completion_timeout(&batch->done, msecs_to_jiffies(timeout)) != 0)
+		return batch->result;
+
+	/* pull the batch if it has not started */
+	spin_lock_irqsave(&ntv2_i2c->batch_lock, flags);
+	queued = !list_empty(&batch->list);
+	if (queued)
+		list_del_init(&batch->list);
+	spin_unlock_irqrestore(&ntv2_i2c->batch_lock, flags);
+
+	if (queued) {
+		NTV2_MSG_KONAI2C_ERROR("%s: *error* batch wait timeout\n", ntv2_i2c->name);
+		return -ETIME;
+	}
+
+	/* a running batch owns the ops until it completes */
+	wait_for_completion(&batch->done);
+	return batch->result;
+}
+
+static void ntv2_konai2c_batch_task(struct work_struct *work)
+{
+	struct ntv2_konai2c *ntv2_i2c = container_of(work, struct ntv2_konai2c, batch_work);
+	struct ntv2_konai2c_batch *batch;
+	unsigned long flags;
+
+	while (true) {
+		spin_lock_irqsave(&ntv2_i2c->batch_lock, flags);
+		if (list_empty(&ntv2_i2c->batch_list)) {
+			spin_unlock_irqrestore(&ntv2_i2c->batch_lock, flags);
+			break;
+		}
+		batch = list_first_entry(&ntv2_i2c->batch_list, struct ntv2_konai2c_batch, list);
+		list_del_init(&batch->list);
+		spin_unlock_irqrestore(&ntv2_i2c->batch_lock, flags);
+
+		ntv2_konai2c_batch_run(ntv2_i2c, batch);
+		complete(&batch->done);
+	}
+}
+
+static void ntv2_konai2c_batch_run(struct ntv2_konai2c *ntv2_i2c,
+								   struct ntv2_konai2c_batch *batch)
+{
+	struct ntv2_konai2c_op *op = NULL;
+	int res = 0;
+	int i;
+
+	mutex_lock(&ntv2_i2c->io_mutex);
+
+	/* each op only waits for the previous one to leave the bus */
+	for (i = 0; i < batch->num_ops; i++) {
+		op = &batch->ops[i];
+
+		res = ntv2_konai2c_wait_for_idle(ntv2_i2c, NTV2_BATCH_TIMEOUT);
+		if (res < 0)
+			break;
+
+		if (op->type == ntv2_konai2c_op_write) {
+			NTV2_MSG_KONAI2C_WRITE("%s: write dev %02x  add %02x  data %02x\n",
+								   ntv2_i2c->name, op->device, op->address, op->data);
+			ntv2_konai2c_issue_write(ntv2_i2c, op->device, op->address, op->data);
+		} else if (op->type == ntv2_konai2c_op_update) {
+			NTV2_MSG_KONAI2C_READ("%s: update device %02x read cache\n",
+								  ntv2_i2c->name, op->device);
+			res = ntv2_konai2c_issue_update(ntv2_i2c, op->device);
+			if (res < 0)
+				break;
+		} else if (op->type == ntv2_konai2c_op_read) {
+			op->data = ntv2_konai2c_issue_read(ntv2_i2c, op->device, op->address);
+		} else {
+			res = -EINVAL;
+			break;
+		}
+	}
+
+	/* wait for the last write */
+	if (res >= 0)
+		res = ntv2_konai2c_wait_for_idle(ntv2_i2c, NTV2_BATCH_TIMEOUT);
+
+	mutex_unlock(&ntv2_i2c->io_mutex);
+
+	if (res < 0) {
+		batch->error_index = i;
+		if (i < batch->num_ops) {
+			NTV2_MSG_KONAI2C_ERROR("%s: *error* batch op %d  dev %02x  add %02x  failed\n",
+								   ntv2_i2c->name, i, op->device, op->address);
+		} else {
+			NTV2_MSG_KONAI2C_ERROR("%s: *error* batch completion failed\n", ntv2_i2c->name);
+		}
+	}
+	batch->result = (res < 0)? res : 0;
+}
+
+static void ntv2_konai2c_issue_write(struct ntv2_konai2c *ntv2_i2c, u8 device, u8 address, u8 data)
+{
+	u32 val;
+
+	val = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_device_address, device);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmiin_subaddress, address);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmiin_read_disable, 1);
+	ntv2_register_write(ntv2_i2c->kona_reg, ntv2_i2c->kona_control, val);
+
+	val = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_data_out, data);
+	ntv2_register_write(ntv2_i2c->kona_reg, ntv2_i2c->kona_data, val);
+}
+
+static int ntv2_konai2c_issue_update(struct ntv2_konai2c *ntv2_i2c, u8 device)
+{
+	u32 val;
+	int res;
 
 	/* enable i2c reads */
-	val = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_device_address, ntv2_i2c->i2c_device);
+	val = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_device_address, device);
 	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmiin_subaddress, ntv2_subaddress_all);
 	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmiin_read_disable, 0);
 	ntv2_register_write(ntv2_i2c->kona_reg, ntv2_i2c->kona_control, val);
@@ -166,7 +404,7 @@ int ntv2_konai2c_cache_update(struct ntv2_konai2c *ntv2_i2c)
 		return res;
 
 	/* disable i2c reads */
-	val = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_device_address, ntv2_i2c->i2c_device);
+	val = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_device_address, device);
 	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmiin_subaddress, ntv2_subaddress_all);
 	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmiin_read_disable, 1);
 	ntv2_register_write(ntv2_i2c->kona_reg, ntv2_i2c->kona_control, val);
@@ -178,23 +416,12 @@ int ntv2_konai2c_cache_update(struct ntv2_konai2c *ntv2_i2c)
 	return 0;
 }
 
-u8 ntv2_konai2c_cache_read(struct ntv2_konai2c *ntv2_i2c, u8 address)
+static u8 ntv2_konai2c_issue_read(struct ntv2_konai2c *ntv2_i2c, u8 device, u8 address)
 {
 	u32 val;
 	u32 data;
-	int res;
-
-	if (ntv2_i2c == NULL)
-		return 0;
-
-	res = ntv2_konai2c_wait_for_busy(ntv2_i2c, NTV2_BUSY_TIMEOUT);
-	if (res < 0) {
-		NTV2_MSG_KONAI2C_ERROR("%s: *error* read dev %02x  address %02x  failed\n",
-							   ntv2_i2c->name, ntv2_i2c->i2c_device, address);
-		return res;
-	}
 
-	val = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_device_address, ntv2_i2c->i2c_device);
+	val = NTV2_FLD_SET(ntv2_kona_fld_hdmiin_device_address, device);
 	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmiin_subaddress, address);
 	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmiin_read_disable, 1);
 	ntv2_register_write(ntv2_i2c->kona_reg, ntv2_i2c->kona_control, val);
@@ -203,19 +430,10 @@ u8 ntv2_konai2c_cache_read(struct ntv2_konai2c *ntv2_i2c, u8 address)
 	data = NTV2_FLD_GET(ntv2_kona_fld_hdmiin_data_in, val);
 
 	NTV2_MSG_KONAI2C_READ("%s: read  dev %02x  add %02x  data %02x\n",
-						  ntv2_i2c->name, ntv2_i2c->i2c_device, address, data);
+						  ntv2_i2c->name, device, address, data);
 	return (u8)data;
 }
 
-int ntv2_konai2c_rmw(struct ntv2_konai2c *ntv2_i2c, u8 address, u8 data, u8 mask)
-{
-	u8 val;
-
-	val = ntv2_konai2c_cache_read(ntv2_i2c, address);
-	val = (val & (~mask)) | (data & mask);
-	return ntv2_konai2c_write(ntv2_i2c, address, val);
-}
-
 static int ntv2_konai2c_wait_for_busy(struct ntv2_konai2c *ntv2_i2c, u32 timeout)
 {
 	u32 val;
@@ -288,6 +506,27 @@ static int ntv2_konai2c_wait_for_read(struct ntv2_konai2c *ntv2_i2c, u32 timeout
 	return -ETIME;
 }
 
+static int ntv2_konai2c_wait_for_idle(struct ntv2_konai2c *ntv2_i2c, u32 timeout)
+{
+	u32 val;
+	u32 mask = NTV2_FLD_MASK(ntv2_kona_fld_hdmiin_i2c_busy) |
+		NTV2_FLD_MASK(ntv2_kona_fld_hdmiin_write_busy);
+	int count = timeout / NTV2_BATCH_TIME_MIN;
+	int i;
+
+	/* short polls since a single byte write is only tens of microseconds */
+	for (i = 0; i < count; i++) {
+		val = ntv2_register_read(ntv2_i2c->kona_reg, ntv2_i2c->kona_control);
+		if ((val & mask) == 0)
+			return 0;
+		usleep_range(NTV2_BATCH_TIME_MIN, NTV2_BATCH_TIME_MAX);
+	}
+	NTV2_MSG_KONAI2C_ERROR("%s: *error* wait for i2c idle failed - reset count %d\n",
+						   ntv2_i2c->name, ntv2_i2c->reset_count);
+	ntv2_konai2c_reset(ntv2_i2c);
+	return -ETIME;
+}
+
 static void ntv2_konai2c_reset(struct ntv2_konai2c *ntv2_i2c)
 {
 	u32 val;
@@ -24,6 +24,29 @@
 
 struct ntv2_regsiter;
 
+enum ntv2_konai2c_op_type {
+	ntv2_konai2c_op_write,
+	ntv2_konai2c_op_update,
+	ntv2_konai2c_op_read,
+	ntv2_konai2c_op_size
+};
+
+struct ntv2_konai2c_op {
+	u8						type;
+	u8						device;
+	u8						address;
+	u8						data;
+};
+
+struct ntv2_konai2c_batch {
+	struct list_head		list;
+	struct ntv2_konai2c_op	*ops;
+	int						num_ops;
+	int						result;
+	int						error_index;
+	struct completion		done;
+};
+
 struct ntv2_konai2c {
 	int						index;
 	char					name[NTV2_STRING_SIZE];
@@ -35,6 +58,12 @@ struct ntv2_konai2c {
 	u32						kona_data;
 	u8						i2c_device;
 	u32						reset_count;
+
+	struct mutex			io_mutex;
+	spinlock_t				batch_lock;
+	struct list_head		batch_list;
+	struct work_struct		batch_work;
+	bool					batch_enable;
 };
 
 struct ntv2_konai2c *ntv2_konai2c_open(struct ntv2_object *ntv2_obj,
@@ -54,4 +83,13 @@ int ntv2_konai2c_cache_update(struct ntv2_konai2c *ntv2_i2c);
 u8 ntv2_konai2c_cache_read(struct ntv2_konai2c *ntv2_i2c, u8 address);
 int ntv2_konai2c_rmw(struct ntv2_konai2c *ntv2_i2c, u8 address, u8 data, u8 mask);
 
+void ntv2_konai2c_batch_init(struct ntv2_konai2c_batch *batch,
+							 struct ntv2_konai2c_op *ops,
+							 int num_ops);
+int ntv2_konai2c_batch_submit(struct ntv2_konai2c *ntv2_i2c,
+							  struct ntv2_konai2c_batch *batch);
+int ntv2_konai2c_batch_wait(struct ntv2_konai2c *ntv2_i2c,
+							struct ntv2_konai2c_batch *batch,
+							u32 timeout);
+
 #endif
@@ -238,6 +238,7 @@ static struct sdi_input_status sdi_input_status[NTV2_MAX_CHANNELS];
 static struct video_field video_fs_route[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
 static struct video_field video_csc_route[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
 static struct video_field video_mux_route[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
+static struct video_field video_sdiout_route[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
 static u32 video_sdi_source[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
 static u32 video_dl_source[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
 static u32 video_csc_yuv_source[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
@@ -246,6 +247,8 @@ static u32 video_hdmi_yuv_source[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
 static u32 video_hdmi_rgb_source[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
 static u32 video_mux_yuv_source[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
 static u32 video_mux_rgb_source[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
+static u32 video_fs_yuv_source[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
+static u32 video_fs_rgb_source[NTV2_MAX_CHANNELS][NTV2_MAX_STREAMS];
 static u32 video_standard_to_hdmi[NTV2_MAX_VIDEO_STANDARDS];
 static u32 frame_rate_to_hdmi[NTV2_MAX_FRAME_RATES];
 static const char *video_standard_name[NTV2_MAX_VIDEO_STANDARDS];
@@ -255,13 +258,18 @@ static const char *frame_rate_name[NTV2_MAX_FRAME_RATES];
 static const char *color_space_name[NTV2_MAX_COLOR_SPACES];
 static const char *color_depth_name[NTV2_MAX_COLOR_DEPTHS];
 static bool register_data_init = false;
+static DEFINE_MUTEX(register_data_mutex);
 
 void ntv2_kona_register_initialize(void)
 {
 	int i;
 
-	if (register_data_init)
+	/* boards may probe in parallel */
+	mutex_lock(&register_data_mutex);
+	if (register_data_init) {
+		mutex_unlock(&register_data_mutex);
 		return;
+	}
 
 	/* organize hardware register functions by channel index */
 	memset(video_input_data, 0, sizeof(video_input_data));
@@ -667,6 +675,24 @@ void ntv2_kona_register_initialize(void)
 	video_mux_route[3][1].reg = NTV2_REG_NUM(ntv2_kona_reg_xpt_select33, 0);
 	video_mux_route[3][1].fld = ntv2_kona_fld_425mux4_ds2_source;
 
+	memset(video_sdiout_route, 0, sizeof(video_sdiout_route));
+	video_sdiout_route[0][0].reg = NTV2_REG_NUM(ntv2_kona_reg_xpt_select3, 0);
+	video_sdiout_route[0][0].fld = ntv2_kona_fld_sdiout1_ds1_source;
+	video_sdiout_route[1][0].reg = NTV2_REG_NUM(ntv2_kona_reg_xpt_select3, 0);
+	video_sdiout_route[1][0].fld = ntv2_kona_fld_sdiout2_ds1_source;
+	video_sdiout_route[2][0].reg = NTV2_REG_NUM(ntv2_kona_reg_xpt_select8, 0);
+	video_sdiout_route[2][0].fld = ntv2_kona_fld_sdiout3_ds1_source;
+	video_sdiout_route[3][0].reg = NTV2_REG_NUM(ntv2_kona_reg_xpt_select8, 0);
+	video_sdiout_route[3][0].fld = ntv2_kona_fld_sdiout4_ds1_source;
+	video_sdiout_route[4][0].reg = NTV2_REG_NUM(ntv2_kona_reg_xpt_select8, 0);
+	video_sdiout_route[4][0].fld = ntv2_kona_fld_sdiout5_ds1_source;
+	video_sdiout_route[5][0].reg = NTV2_REG_NUM(ntv2_kona_reg_xpt_select22, 0);
+	video_sdiout_route[5][0].fld = ntv2_kona_fld_sdiout6_ds1_source;
+	video_sdiout_route[6][0].reg = NTV2_REG_NUM(ntv2_kona_reg_xpt_select22, 0);
+	video_sdiout_route[6][0].fld = ntv2_kona_fld_sdiout7_ds1_source;
+	video_sdiout_route[7][0].reg = NTV2_REG_NUM(ntv2_kona_reg_xpt_select30, 0);
+	video_sdiout_route[7][0].fld = ntv2_kona_fld_sdiout8_ds1_source;
+
 	/* organize video routing sources by channel index */
 	memset(video_sdi_source, 0, sizeof(video_sdi_source));
 	video_sdi_source[0][0] = ntv2_kona_xpt_sdiin1_ds1;
@@ -768,6 +794,26 @@ void ntv2_kona_register_initialize(void)
 	video_mux_rgb_source[3][0] = ntv2_kona_xpt_425mux4_ds1_rgb;
 	video_mux_rgb_source[3][1] = ntv2_kona_xpt_425mux4_ds2_rgb;
 
+	memset(video_fs_yuv_source, 0, sizeof(video_fs_yuv_source));
+	video_fs_yuv_source[0][0] = ntv2_kona_xpt_fb1_ds1_yuv;
+	video_fs_yuv_source[1][0] = ntv2_kona_xpt_fb2_ds1_yuv;
+	video_fs_yuv_source[2][0] = ntv2_kona_xpt_fb3_ds1_yuv;
+	video_fs_yuv_source[3][0] = ntv2_kona_xpt_fb4_ds1_yuv;
+	video_fs_yuv_source[4][0] = ntv2_kona_xpt_fb5_yuv;
+	video_fs_yuv_source[5][0] = ntv2_kona_xpt_fb6_ds1_yuv;
+	video_fs_yuv_source[6][0] = ntv2_kona_xpt_fb7_ds1_yuv;
+	video_fs_yuv_source[7][0] = ntv2_kona_xpt_fb8_ds1_yuv;
+
+	memset(video_fs_rgb_source, 0, sizeof(video_fs_rgb_source));
+	video_fs_rgb_source[0][0] = ntv2_kona_xpt_fb1_ds1_rgb;
+	video_fs_rgb_source[1][0] = ntv2_kona_xpt_fb2_ds1_rgb;
+	video_fs_rgb_source[2][0] = ntv2_kona_xpt_fb3_ds1_rgb;
+	video_fs_rgb_source[3][0] = ntv2_kona_xpt_fb4_ds1_rgb;
+	video_fs_rgb_source[4][0] = ntv2_kona_xpt_fb5_ds1_rgb;
+	video_fs_rgb_source[5][0] = ntv2_kona_xpt_fb6_ds1_rgb;
+	video_fs_rgb_source[6][0] = ntv2_kona_xpt_fb7_ds1_rgb;
+	video_fs_rgb_source[7][0] = ntv2_kona_xpt_fb8_ds1_rgb;
+
 	/* ntv2 video standard to hdmi video standard */
 	for (i = 0; i < NTV2_MAX_VIDEO_STANDARDS; i++) {
 		video_standard_to_hdmi[i] = ntv2_kona_hdmiin_video_standard_none;
@@ -876,6 +922,7 @@ void ntv2_kona_register_initialize(void)
 	color_depth_name[ntv2_kona_color_depth_none] = "none";
 	
 	register_data_init = true;
+	mutex_unlock(&register_data_mutex);
 }
 
 const char* ntv2_video_standard_name(u32 standard)
@@ -1124,6 +1171,52 @@ u32 ntv2_video_output_field_id(struct ntv2_interrupt_status* irq_status, int ind
 	return 0;
 }
 
+void ntv2_hdmi_input_interrupt_enable(struct ntv2_register *ntv2_reg, bool enable)
+{
+	u32 val;
+	u32 mask;
+
+	if (ntv2_reg == NULL)
+		return;
+
+	/* receiver plug and chip interrupts */
+	val = NTV2_FLD_SET(ntv2_kona_fld_hdmi1_rx_plug_enable, enable? 1 : 0);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmi1_rx_chip_enable, enable? 1 : 0);
+	mask = NTV2_FLD_MASK(ntv2_kona_fld_hdmi1_rx_plug_enable);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_hdmi1_rx_chip_enable);
+	ntv2_reg_rmw(ntv2_reg, ntv2_kona_reg_interrupt_control2, 0, val, mask);
+}
+
+void ntv2_hdmi_input_interrupt_clear(struct ntv2_register *ntv2_reg)
+{
+	u32 val;
+	u32 mask;
+
+	if (ntv2_reg == NULL)
+		return;
+
+	val = NTV2_FLD_SET(ntv2_kona_fld_hdmi1_rx_plug_clear, 1);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_hdmi1_rx_chip_clear, 1);
+	mask = NTV2_FLD_MASK(ntv2_kona_fld_hdmi1_rx_plug_clear);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_hdmi1_rx_chip_clear);
+	ntv2_reg_rmw(ntv2_reg, ntv2_kona_reg_interrupt_control2, 0, val, mask);
+}
+
+bool ntv2_hdmi_input_interrupt_active(struct ntv2_interrupt_status* irq_status)
+{
+	u32 mask;
+
+	if (irq_status == NULL)
+		return false;
+
+	mask = NTV2_FLD_MASK(ntv2_kona_fld_hdmi1_plug_active);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_hdmi1_chip_active);
+	if ((irq_status->interrupt_status[1] & mask) != 0)
+		return true;
+
+	return false;
+}
+
 void ntv2_sdi_output_transmit_enable(struct ntv2_register* ntv2_reg, int index, bool enable)
 {
 	u32 val;
@@ -1499,3 +1592,27 @@ void ntv2_route_mux_to_fs(struct ntv2_register* ntv2_reg,
 //				  video_fs_route[fs_index][fs_stream].reg, val, mask);
 }
 
+void ntv2_route_fs_to_sdi(struct ntv2_register* ntv2_reg,
+						  int fs_index, int fs_stream, bool fs_rgb,
+						  int sdi_index, int sdi_stream)
+{
+	u32 val;
+	u32 mask;
+
+	if ((ntv2_reg == NULL) ||
+		(fs_index < 0) || (fs_index >= NTV2_MAX_CHANNELS) ||
+		(fs_stream < 0) || (fs_stream >= NTV2_MAX_STREAMS) ||
+		(sdi_index < 0) || (sdi_index >= NTV2_MAX_CHANNELS) ||
+		(sdi_stream < 0) || (sdi_stream >= NTV2_MAX_STREAMS) ||
+		(video_sdiout_route[sdi_index][sdi_stream].reg == 0))
+		return;
+
+	if (fs_rgb) {
+		val = NTV2_FLD_SET(video_sdiout_route[sdi_index][sdi_stream].fld, video_fs_rgb_source[fs_index][fs_stream]);
+	} else {
+		val = NTV2_FLD_SET(video_sdiout_route[sdi_index][sdi_stream].fld, video_fs_yuv_source[fs_index][fs_stream]);
+	}
+	mask = NTV2_FLD_MASK(video_sdiout_route[sdi_index][sdi_stream].fld);
+	ntv2_register_rmw(ntv2_reg, video_sdiout_route[sdi_index][sdi_stream].reg, val, mask);
+}
+
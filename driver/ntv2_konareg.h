@@ -186,6 +186,10 @@ NTV2_CON(ntv2_kona_fbf_10bit_argb,							21);
 NTV2_CON(ntv2_kona_fbf_16bit_argb,							22);
 NTV2_CON(ntv2_kona_fbf_10bit_raw_rgb,						24);
 NTV2_CON(ntv2_kona_fbf_10bit_raw_ycbcr,						25);
+NTV2_CON(ntv2_kona_fbf_10bit_ycbcr_420pl2,					28);
+NTV2_CON(ntv2_kona_fbf_10bit_ycbcr_422pl2,					29);
+NTV2_CON(ntv2_kona_fbf_8bit_ycbcr_420pl2,					30);
+NTV2_CON(ntv2_kona_fbf_8bit_ycbcr_422pl2,					31);
 
 /* frame buffer size */
 NTV2_CON(ntv2_kona_frame_size_2mb,							0);
@@ -839,6 +843,38 @@ NTV2_REG(ntv2_kona_reg_sdiin_timecode_ltc_high,				111, 253, 317, 319, 345, 420,
 NTV2_REG(ntv2_kona_reg_sdiin_timecode_vitc1_low,			202, 204, 206, 208, 210, 212, 214, 216);
 NTV2_REG(ntv2_kona_reg_sdiin_timecode_vitc1_high,			203, 205, 207, 209, 211, 213, 215, 217);
 
+/* ancillary extractor registers */
+NTV2_REG(ntv2_kona_reg_anc_ext_control,						4096, 4160, 4224, 4288, 4352, 4416, 4480, 4544);
+NTV2_FLD(ntv2_kona_fld_anc_ext_hanc_y_enable,				1,	0);
+NTV2_FLD(ntv2_kona_fld_anc_ext_hanc_c_enable,				1,	4);
+NTV2_FLD(ntv2_kona_fld_anc_ext_vanc_y_enable,				1,	8);
+NTV2_FLD(ntv2_kona_fld_anc_ext_vanc_c_enable,				1,	12);
+NTV2_FLD(ntv2_kona_fld_anc_ext_progressive,					1,	24);
+NTV2_FLD(ntv2_kona_fld_anc_ext_synchro,						1,	28);
+NTV2_FLD(ntv2_kona_fld_anc_ext_disable,						1,	29);
+NTV2_FLD(ntv2_kona_fld_anc_ext_sd_mux_enable,				1,	30);
+
+NTV2_REG(ntv2_kona_reg_anc_ext_field1_start_address,		4097, 4161, 4225, 4289, 4353, 4417, 4481, 4545);
+NTV2_REG(ntv2_kona_reg_anc_ext_field1_end_address,			4098, 4162, 4226, 4290, 4354, 4418, 4482, 4546);
+NTV2_REG(ntv2_kona_reg_anc_ext_field2_start_address,		4099, 4163, 4227, 4291, 4355, 4419, 4483, 4547);
+NTV2_REG(ntv2_kona_reg_anc_ext_field2_end_address,			4100, 4164, 4228, 4292, 4356, 4420, 4484, 4548);
+
+NTV2_REG(ntv2_kona_reg_anc_ext_field_cutoff_line,			4101, 4165, 4229, 4293, 4357, 4421, 4485, 4549);
+NTV2_FLD(ntv2_kona_fld_anc_ext_field1_cutoff_line,			11,	0);
+NTV2_FLD(ntv2_kona_fld_anc_ext_field2_cutoff_line,			11,	16);
+
+NTV2_REG(ntv2_kona_reg_anc_ext_field1_status,				4103, 4167, 4231, 4295, 4359, 4423, 4487, 4551);
+NTV2_REG(ntv2_kona_reg_anc_ext_field2_status,				4104, 4168, 4232, 4296, 4360, 4424, 4488, 4552);
+NTV2_FLD(ntv2_kona_fld_anc_ext_bytes_in,					24,	0);
+NTV2_FLD(ntv2_kona_fld_anc_ext_overrun,						1,	28);
+
+NTV2_REG(ntv2_kona_reg_anc_ext_field_vbl_start_line,		4105, 4169, 4233, 4297, 4361, 4425, 4489, 4553);
+NTV2_FLD(ntv2_kona_fld_anc_ext_field1_start_line,			11,	0);
+NTV2_FLD(ntv2_kona_fld_anc_ext_field2_start_line,			11,	16);
+
+NTV2_REG(ntv2_kona_reg_anc_ext_total_frame_lines,			4106, 4170, 4234, 4298, 4362, 4426, 4490, 4554);
+NTV2_FLD(ntv2_kona_fld_anc_ext_total_frame_lines,			11,	0);
+
 /* audio detection bits */
 NTV2_FLD(ntv2_kona_fld_audio_detect_gr1ch12,				1,	0);
 NTV2_FLD(ntv2_kona_fld_audio_detect_gr1ch34,				1,	1);
@@ -1633,6 +1669,10 @@ u32 ntv2_video_output_field_id(struct ntv2_interrupt_status* irq_status, int ind
 
 u32 ntv2_video_output_interrupt_rate(struct ntv2_register *ntv2_reg, int index);
 
+void ntv2_hdmi_input_interrupt_enable(struct ntv2_register *ntv2_reg, bool enable);
+void ntv2_hdmi_input_interrupt_clear(struct ntv2_register *ntv2_reg);
+bool ntv2_hdmi_input_interrupt_active(struct ntv2_interrupt_status* irq_status);
+
 void ntv2_sdi_output_transmit_enable(struct ntv2_register *ntv2_reg, int index, bool enable);
 void ntv2_sdi_input_convert_3g_enable(struct ntv2_register *ntv2_reg, int index, bool enable);
 void ntv2_qrc_4k_enable(struct ntv2_register *ntv2_reg, bool input, bool output);
@@ -1669,5 +1709,8 @@ void ntv2_route_csc_to_mux(struct ntv2_register* ntv2_reg,
 void ntv2_route_mux_to_fs(struct ntv2_register* ntv2_reg,
 						  int mux_index, int mux_stream, bool mux_rgb,
 						  int fs_index, int fs_stream);
+void ntv2_route_fs_to_sdi(struct ntv2_register* ntv2_reg,
+						  int fs_index, int fs_stream, bool fs_rgb,
+						  int sdi_index, int sdi_stream);
 
 #endif
@@ -28,7 +28,7 @@ static int ntv2_mixops_info_source_control(struct snd_kcontrol *kcontrol,
 {
 	struct ntv2_audio *ntv2_aud = (struct ntv2_audio *)snd_kcontrol_chip(kcontrol);
 	struct ntv2_features *features;
-	struct ntv2_source_config *config;
+	const struct ntv2_source_config *config;
 	u32 num_sources;
 
 	features = ntv2_aud->features;
@@ -77,7 +77,7 @@ static int ntv2_mixops_put_source_control(struct snd_kcontrol *kcontrol,
 										  struct snd_ctl_elem_value *elem)
 {
 	struct ntv2_audio *ntv2_aud = (struct ntv2_audio *)snd_kcontrol_chip(kcontrol);
-	struct ntv2_source_config *config;
+	const struct ntv2_source_config *config;
 
 	ntv2_aud->snd_input = elem->value.enumerated.item[0];
 
@@ -92,8 +92,9 @@ static int ntv2_mixops_put_source_control(struct snd_kcontrol *kcontrol,
 												 ntv2_aud->snd_input);
 	}
 
-	/* set source format */
+	/* keep the selection, the audio source resolves auto for the running stream */
 	ntv2_features_gen_source_format(config, &ntv2_aud->source_format);
+	ntv2_audio_set_source(ntv2_aud, config);
 
 	NTV2_MSG_AUDIO_STATE("%s: put audio input %d - %s\n",
 						 ntv2_aud->name, ntv2_aud->snd_input, config->name);
@@ -101,6 +102,31 @@ static int ntv2_mixops_put_source_control(struct snd_kcontrol *kcontrol,
 	return 0;
 }
 
+static int ntv2_mixops_info_rate_control(struct snd_kcontrol *kcontrol,
+										 struct snd_ctl_elem_info *info)
+{
+	/* measured capture rate in millihertz */
+	info->type = SNDRV_CTL_ELEM_TYPE_INTEGER;
+	info->count = 1;
+	info->value.integer.min = 0;
+	info->value.integer.max = 192000000;
+	info->value.integer.step = 1;
+
+	return 0;
+}
+
+static int ntv2_mixops_get_rate_control(struct snd_kcontrol *kcontrol,
+										struct snd_ctl_elem_value *elem)
+{
+	struct ntv2_audio *ntv2_aud = (struct ntv2_audio *)snd_kcontrol_chip(kcontrol);
+	u32 rate = 0;
+
+	ntv2_channel_get_audio_rate(ntv2_aud->capture->chn_str, &rate);
+	elem->value.integer.value[0] = rate;
+
+	return 0;
+}
+
 int ntv2_mixops_capture_configure(struct ntv2_audio *ntv2_aud)
 {
 	struct snd_kcontrol_new snd_control;
@@ -128,5 +154,25 @@ int ntv2_mixops_capture_configure(struct ntv2_audio *ntv2_aud)
 							 ntv2_aud->ntv2_dev->name, ret);
 	}
 
+	/* measured capture rate */
+	memset(&snd_control, 0, sizeof(snd_control));
+
+	snd_control.iface = SNDRV_CTL_ELEM_IFACE_PCM;
+	snd_control.access = SNDRV_CTL_ELEM_ACCESS_READ | SNDRV_CTL_ELEM_ACCESS_VOLATILE;
+	snd_control.name = control_name;
+	snd_control.device = ntv2_aud->index;
+	snd_control.count = 1;
+	snd_control.info = ntv2_mixops_info_rate_control;
+	snd_control.get = ntv2_mixops_get_rate_control;
+
+	snprintf(control_name, sizeof(control_name), "Channel %d Capture Rate",
+			 ntv2_aud->ntv2_chn->index + 1);
+
+	ret = snd_ctl_add(ntv2_aud->ntv2_dev->snd_card, snd_ctl_new1(&snd_control, ntv2_aud));
+	if (ret != 0) {
+		NTV2_MSG_AUDIO_ERROR("%s: *error* adding audio control %08x\n",
+							 ntv2_aud->ntv2_dev->name, ret);
+	}
+
 	return 0;
 }
@@ -50,7 +50,8 @@ struct ntv2_nwldma *ntv2_nwldma_open(struct ntv2_object *ntv2_obj,
 	if (ntv2_obj == NULL) 
 		return NULL;
 
-	ntv2_nwl = kzalloc(sizeof(struct ntv2_nwldma), GFP_KERNEL);
+	ntv2_nwl = kzalloc_node(sizeof(struct ntv2_nwldma), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_nwl == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_nwldma instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
@@ -276,6 +277,26 @@ int ntv2_nwldma_disable(struct ntv2_nwldma *ntv2_nwl)
 	return 0;
 }
 
+static void ntv2_nwldma_queue_task(struct ntv2_nwldma *ntv2_nwl,
+								   struct ntv2_nwldma_task *task)
+{
+	struct ntv2_nwldma_task *next;
+
+	/* priority tasks go ahead of waiting normal tasks but never
+	   ahead of the list head which the engine task may own */
+	if (task->priority && !list_empty(&ntv2_nwl->dmatask_ready_list)) {
+		next = list_first_entry(&ntv2_nwl->dmatask_ready_list, struct ntv2_nwldma_task, list);
+		list_for_each_entry_continue(next, &ntv2_nwl->dmatask_ready_list, list) {
+			if (!next->priority && !next->dma_start) {
+				list_add_tail(&task->list, &next->list);
+				return;
+			}
+		}
+	}
+
+	list_add_tail(&task->list, &ntv2_nwl->dmatask_ready_list);
+}
+
 int ntv2_nwldma_transfer(struct ntv2_nwldma *ntv2_nwl,
 						 struct ntv2_transfer *ntv2_trn)
 {
@@ -303,8 +324,12 @@ int ntv2_nwldma_transfer(struct ntv2_nwldma *ntv2_nwl,
 		task->card_address[1] = ntv2_trn->card_address[1];
 		task->card_size[0] = ntv2_trn->card_size[0];
 		task->card_size[1] = ntv2_trn->card_size[1];
+		task->card_pitch = ntv2_trn->card_pitch;
+		task->card_segment = ntv2_trn->card_segment;
+		task->system_pitch = ntv2_trn->system_pitch;
 		task->callback_func = ntv2_trn->callback_func;
 		task->callback_data = ntv2_trn->callback_data;
+		task->priority = ntv2_trn->priority;
 		task->dma_start = false;
 		task->dma_done = false;
 		task->dma_result = 0;
@@ -312,7 +337,7 @@ int ntv2_nwldma_transfer(struct ntv2_nwldma *ntv2_nwl,
 		task_index = task->index;
 	
 		list_del_init(&task->list);
-		list_add_tail(&task->list, &ntv2_nwl->dmatask_ready_list);
+		ntv2_nwldma_queue_task(ntv2_nwl, task);
 	}
 	spin_unlock_irqrestore(&ntv2_nwl->state_lock, flags);
 
@@ -418,6 +443,9 @@ static int ntv2_nwldma_dodma(struct ntv2_nwldma_task *ntv2_task)
 	u32		total_size;
 	u32		data_size;
 	u32		byte_count;
+	u32		count;
+	u32		segment_size;
+	u32		system_skip;
 	int		result;
 	int		i;
 
@@ -521,6 +549,8 @@ static int ntv2_nwldma_dodma(struct ntv2_nwldma_task *ntv2_task)
 	desc_next = ntv2_nwl->dma_descriptor + sizeof(struct ntv2_nwldma_descriptor);
 	desc_count = 0;
 	data_size = 0;
+	segment_size = 0;
+	system_skip = 0;
 	total_size = ntv2_task->card_size[0] + ntv2_task->card_size[1];
 	ntv2_nwl->descriptor_count = 0;
 	ntv2_nwl->descriptor_bytes = 0;
@@ -529,39 +559,31 @@ static int ntv2_nwldma_dodma(struct ntv2_nwldma_task *ntv2_task)
 		system_address = sg_dma_address(sgentry);
 		byte_count = sg_dma_len(sgentry);
 
-		/* limit transfer to total size */
-		if ((data_size + byte_count) > total_size)
-			byte_count = total_size - data_size;
-
-		/* handle split transfer */
-		if ((ntv2_task->card_size[1] != 0) &&
-			(data_size < ntv2_task->card_size[0]) &&
-			((data_size + byte_count) >= ntv2_task->card_size[0])) {
-			/* write descriptor for first fragment */
-			desc->control			= 0;
-			desc->byte_count		= ntv2_task->card_size[0] - data_size;
-			desc->system_address	= system_address;
-			desc->card_address		= card_address;
-			desc->next_address		= desc_next;
-			/* setup for next fragment */
-			system_address += desc->byte_count;
-			card_address = ntv2_task->card_address[1];
-			byte_count -= desc->byte_count;
-			data_size += desc->byte_count;
-			if (data_size >= total_size)
-				break;
-			/* setup for next descriptor */
-			desc++;
-			desc_next += sizeof(struct ntv2_nwldma_descriptor);
-			desc_count++;
-			if (desc_count >= ntv2_nwl->max_descriptors)
-			break;
-		}
+		while ((byte_count != 0) && (data_size < total_size)) {
+			/* step over the system line padding */
+			if (system_skip != 0) {
+				count = (byte_count < system_skip)? byte_count : system_skip;
+				system_address += count;
+				byte_count -= count;
+				system_skip -= count;
+				continue;
+			}
+			/* limit the descriptor to the total size and the card line segment */
+			count = byte_count;
+			if (count > (total_size - data_size))
+				count = total_size - data_size;
+			if ((ntv2_task->card_segment != 0) &&
+				(count > (ntv2_task->card_segment - segment_size)))
+				count = ntv2_task->card_segment - segment_size;
+			/* and to the end of the first card region of a split transfer */
+			if ((ntv2_task->card_size[1] != 0) &&
+				(data_size < ntv2_task->card_size[0]) &&
+				(count > (ntv2_task->card_size[0] - data_size)))
+				count = ntv2_task->card_size[0] - data_size;
 
-		if (byte_count != 0) {
 			/* write the descriptor */
 			desc->control			= 0;
-			desc->byte_count		= byte_count;
+			desc->byte_count		= count;
 			desc->system_address	= system_address;
 			desc->card_address		= card_address;
 			desc->next_address		= desc_next;
@@ -580,8 +602,26 @@ static int ntv2_nwldma_dodma(struct ntv2_nwldma_task *ntv2_task)
 										NTV2_U64_LOW(desc->next_address));
 			}
 			/* update card address and size */
-			card_address += byte_count;
-			data_size += byte_count;
+			system_address += count;
+			byte_count -= count;
+			card_address += count;
+			data_size += count;
+			/* skip to the next card and system line */
+			if (ntv2_task->card_segment != 0) {
+				segment_size += count;
+				if (segment_size >= ntv2_task->card_segment) {
+					card_address += ntv2_task->card_pitch - ntv2_task->card_segment;
+					if (ntv2_task->system_pitch > ntv2_task->card_segment)
+						system_skip = ntv2_task->system_pitch - ntv2_task->card_segment;
+					segment_size = 0;
+				}
+			}
+			/* start the second card region on a new line */
+			if ((ntv2_task->card_size[1] != 0) &&
+				(data_size == ntv2_task->card_size[0])) {
+				card_address = ntv2_task->card_address[1];
+				segment_size = 0;
+			}
 			if (data_size >= total_size)
 				break;
 			/* setup for next descriptor */
@@ -592,6 +632,10 @@ static int ntv2_nwldma_dodma(struct ntv2_nwldma_task *ntv2_task)
 				break;
 		}
 
+		if ((data_size >= total_size) ||
+			(desc_count >= ntv2_nwl->max_descriptors))
+			break;
+
 		sgentry = sg_next(sgentry);
 	}
 
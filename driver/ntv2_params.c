@@ -91,7 +91,8 @@ s64 ntv2_system_time(void)
 {
 #ifdef NTV2_USE_KTIME
 	struct timespec64 ts64;
-	ktime_get_real_ts64(&ts64);
+	/* monotonic so wall clock steps do not skew intervals */
+	ktime_get_ts64(&ts64);
 
 	return ((s64)ts64.tv_sec * 1000000) + (ts64.tv_nsec / 1000);
 #else	
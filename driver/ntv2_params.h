@@ -48,7 +48,8 @@
 #define NTV2_MAX_SDI_INPUTS			8
 #define NTV2_MAX_HDMI_INPUTS		4
 #define NTV2_MAX_VIDEO_FORMATS		32
-#define NTV2_MAX_PIXEL_FORMATS		8
+#define NTV2_MAX_PIXEL_FORMATS		12
+#define NTV2_MAX_PLANES				2
 #define NTV2_MAX_INPUT_CONFIGS		8
 #define NTV2_MAX_CSC_CONFIGS		4
 #define NTV2_MAX_SOURCE_CONFIGS		8
@@ -201,6 +202,14 @@ enum ntv2_stream_type {
 	ntv2_stream_type_size
 };
 
+enum ntv2_video_type {
+	ntv2_video_type_unknown,
+	ntv2_video_type_capture,
+	ntv2_video_type_output,
+	ntv2_video_type_anc,
+	ntv2_video_type_size
+};
+
 enum ntv2_input_type {
 	ntv2_input_type_unknown,
 	ntv2_input_type_auto,
@@ -266,6 +275,9 @@ struct ntv2_pixel_format {
 	u32							cadence_pixels;
 	u32							cadence_bytes;
 	u32							pitch_alignment;
+	u32							num_planes;
+	u32							plane_line_divisor;
+	u32							buffer_planes;
 };
 
 struct ntv2_input_format {
@@ -319,8 +331,12 @@ struct ntv2_transfer {
 	u32 						sg_offset;
 	u32 						card_address[2];
 	u32 						card_size[2];
+	u32 						card_pitch;
+	u32 						card_segment;
+	u32 						system_pitch;
 	ntv2_transfer_callback 		callback_func;
 	unsigned long 				callback_data;
+	bool						priority;
 };
 
 struct ntv2_device {
@@ -333,6 +349,7 @@ struct ntv2_device {
 	bool						init;
 
 	struct pci_dev				*pci_dev;
+	int							numa_node;
 	enum ntv2_pci_type			pci_type;
 	bool						pci_region;
 	bool						vid_region;
@@ -352,6 +369,7 @@ struct ntv2_device {
 	struct ntv2_input			*inp_mon;
 	struct ntv2_chrdev			*chr_dev;
 	struct snd_card 			*snd_card;
+	struct work_struct			async_work;
 
 	struct list_head 			video_list;
 	spinlock_t 					video_lock;
@@ -375,6 +393,11 @@ struct ntv2_module {
 	u32							debug_mask;
 	const char					*version;
 	bool						init;
+	bool						video_mplane;
+	u32							video_readers;
+	bool						video_outputs;
+	bool						video_anc;
+	bool						video_tai;
 
 	struct list_head			device_list;
 	spinlock_t 					device_lock;
@@ -388,6 +411,8 @@ struct ntv2_module {
 	u32							cdev_max;
 	const char					*cdev_name;
 	atomic_t					cdev_index;
+
+	struct dentry				*debugfs_root;
 };
 
 void ntv2_module_initialize(void);
@@ -35,7 +35,8 @@ struct ntv2_pci *ntv2_pci_open(struct ntv2_object *ntv2_obj,
 	if (ntv2_obj == NULL) 
 		return NULL;
 
-	ntv2_pci = kzalloc(sizeof(struct ntv2_pci), GFP_KERNEL);
+	ntv2_pci = kzalloc_node(sizeof(struct ntv2_pci), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_pci == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_pci instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
@@ -102,12 +103,16 @@ int ntv2_pci_configure(struct ntv2_pci *ntv2_pci,
 		ntv2_pci->nwl_engine[0] = ntv2_pci_nwl_config(ntv2_pci, 4);
 		if (ntv2_pci->nwl_engine[0] == NULL)
 			return -EPERM;
+		/* system to card engine for playback */
+		ntv2_pci->nwl_engine[1] = ntv2_pci_nwl_config(ntv2_pci, 0);
 		break;
 	case ntv2_pci_type_xlx:
 		ntv2_xlxdma_interrupt_disable(pci_reg);
 		ntv2_pci->xlx_engine[0] = ntv2_pci_xlx_config(ntv2_pci, 4);
 		if (ntv2_pci->xlx_engine[0] == NULL)
 			return -EPERM;
+		/* system to card engine for playback */
+		ntv2_pci->xlx_engine[1] = ntv2_pci_xlx_config(ntv2_pci, 0);
 	default:
 		break;
 	}
@@ -213,6 +218,7 @@ int ntv2_pci_transfer(struct ntv2_pci *ntv2_pci,
 {
 	unsigned long flags;
 	int result = -EPERM;
+	int i;
 
 	if (ntv2_pci == NULL)
 		return -EPERM;
@@ -224,16 +230,26 @@ int ntv2_pci_transfer(struct ntv2_pci *ntv2_pci,
 		return 0;
 	}
 
-	/* pass transfer to proper dma engine */
+	/* pass transfer to the dma engine for its direction */
 	switch (ntv2_pci->pci_type)
 	{
 	case ntv2_pci_type_nwl:
-		if (ntv2_pci->nwl_engine[0] != NULL)
-			result = ntv2_nwldma_transfer(ntv2_pci->nwl_engine[0], ntv2_trn);
+		for (i = 0; i < NTV2_MAX_DMA_ENGINES; i++) {
+			if ((ntv2_pci->nwl_engine[i] != NULL) &&
+				(ntv2_pci->nwl_engine[i]->mode == ntv2_trn->mode)) {
+				result = ntv2_nwldma_transfer(ntv2_pci->nwl_engine[i], ntv2_trn);
+				break;
+			}
+		}
 		break;
 	case ntv2_pci_type_xlx:
-		if (ntv2_pci->xlx_engine[0] != NULL)
-			result = ntv2_xlxdma_transfer(ntv2_pci->xlx_engine[0], ntv2_trn);
+		for (i = 0; i < NTV2_MAX_DMA_ENGINES; i++) {
+			if ((ntv2_pci->xlx_engine[i] != NULL) &&
+				(ntv2_pci->xlx_engine[i]->mode == ntv2_trn->mode)) {
+				result = ntv2_xlxdma_transfer(ntv2_pci->xlx_engine[i], ntv2_trn);
+				break;
+			}
+		}
 		break;
 	default:
 		break;
@@ -35,6 +35,9 @@ static struct snd_pcm_hardware ntv2_pcm_hardware = {
 	.info = (SNDRV_PCM_INFO_MMAP |
 			 SNDRV_PCM_INFO_INTERLEAVED |
 			 SNDRV_PCM_INFO_BLOCK_TRANSFER |
+#ifdef NTV2_USE_SND_AUDIO_TSTAMP
+			 SNDRV_PCM_INFO_HAS_LINK_ATIME |
+#endif
 			 SNDRV_PCM_INFO_MMAP_VALID),
 	.formats =          SNDRV_PCM_FMTBIT_S32_LE | SNDRV_PCM_FMTBIT_S16_LE,
 	.rates =            SNDRV_PCM_RATE_48000,
@@ -95,7 +98,7 @@ static int ntv2_pcmops_cap_hw_params(struct snd_pcm_substream *substream,
 			return 0;
 		vfree(runtime->dma_area);
 	}
-	runtime->dma_area = vmalloc(size);
+	runtime->dma_area = vmalloc_node(size, ntv2_aud->ntv2_dev->numa_node);
 	if (runtime->dma_area == NULL)
 		return -ENOMEM;
 	runtime->dma_bytes = size;
@@ -182,6 +185,7 @@ static int ntv2_pcmops_cap_prepare(struct snd_pcm_substream *substream)
 	stream->sample_ptr = 0;
 	stream->period_ptr = 0;
 	stream->sample_cycle = 0;
+	stream->tstamp_frames = 0;
 
 	return 0;
 }
@@ -220,6 +224,43 @@ static snd_pcm_uframes_t ntv2_pcmops_cap_pointer(struct snd_pcm_substream *subst
 	return current_ptr;
 }
 
+#ifdef NTV2_USE_SND_AUDIO_TSTAMP
+static int ntv2_pcmops_cap_get_time_info(struct snd_pcm_substream *substream,
+										 struct timespec64 *system_ts,
+										 struct timespec64 *audio_ts,
+										 struct snd_pcm_audio_tstamp_config *config,
+										 struct snd_pcm_audio_tstamp_report *report)
+{
+	struct ntv2_audio *ntv2_aud = (struct ntv2_audio *)snd_pcm_substream_chip(substream);
+	struct ntv2_pcm_stream *stream = ntv2_aud->capture;
+	struct snd_pcm_runtime *runtime = substream->runtime;
+	u64 time_ns;
+
+	if ((config->type_requested != SNDRV_PCM_AUDIO_TSTAMP_TYPE_LINK) ||
+		(stream->tstamp_frames == 0) ||
+		(runtime->rate == 0)) {
+		snd_pcm_gettime(runtime, system_ts);
+		report->actual_type = SNDRV_PCM_AUDIO_TSTAMP_TYPE_DEFAULT;
+		report->accuracy_report = 0;
+		return 0;
+	}
+
+	/* channel interrupt time (monotonic) of the last sample transferred */
+	time_ns = stream->tstamp_time;
+	if (runtime->tstamp_type == SNDRV_PCM_TSTAMP_TYPE_GETTIMEOFDAY)
+		time_ns += ktime_get_real_ns() - ktime_get_ns();
+
+	*system_ts = ns_to_timespec64(time_ns);
+	*audio_ts = ns_to_timespec64(div_u64(stream->tstamp_frames * NSEC_PER_SEC, runtime->rate));
+
+	report->actual_type = SNDRV_PCM_AUDIO_TSTAMP_TYPE_LINK;
+	report->accuracy_report = 1;
+	report->accuracy = NSEC_PER_SEC / runtime->rate;
+
+	return 0;
+}
+#endif
+
 static struct page *ntv2_pcmops_cap_page(struct snd_pcm_substream *substream,
 										 unsigned long offset)
 {
@@ -236,6 +277,9 @@ static struct snd_pcm_ops ntv2_pcmops_capture_ops = {
 	.prepare =		ntv2_pcmops_cap_prepare,
 	.trigger =		ntv2_pcmops_cap_trigger,
 	.pointer =		ntv2_pcmops_cap_pointer,
+#ifdef NTV2_USE_SND_AUDIO_TSTAMP
+	.get_time_info =	ntv2_pcmops_cap_get_time_info,
+#endif
 	.page =			ntv2_pcmops_cap_page,
 };
 
@@ -293,7 +337,7 @@ static int ntv2_pcmops_play_hw_params(struct snd_pcm_substream *substream,
 			return 0;
 		vfree(runtime->dma_area);
 	}
-	runtime->dma_area = vmalloc(size);
+	runtime->dma_area = vmalloc_node(size, ntv2_aud->ntv2_dev->numa_node);
 	if (runtime->dma_area == NULL)
 		return -ENOMEM;
 	runtime->dma_bytes = size;
@@ -425,11 +469,35 @@ void ntv2_pcmops_tstamp(struct ntv2_pcm_stream *stream)
 //	runtime->trigger_tstamp_latched = true;
 }
 
+u64 ntv2_pcmops_period_wait(struct ntv2_pcm_stream *stream)
+{
+	struct snd_pcm_runtime *runtime;
+	u32 frames;
+	u64 wait;
+
+	if ((stream == NULL) ||
+		(stream->substream == NULL))
+		return NTV2_PCM_PERIOD_WAIT_MIN;
+
+	runtime = stream->substream->runtime;
+	if ((runtime == NULL) || (runtime->rate == 0))
+		return NTV2_PCM_PERIOD_WAIT_MIN;
+
+	/* time until the hardware reaches the next period boundary */
+	frames = 0;
+	if (stream->period_ptr < runtime->period_size)
+		frames = runtime->period_size - stream->period_ptr;
+	wait = div_u64((u64)frames * NSEC_PER_SEC, runtime->rate) + NTV2_PCM_PERIOD_WAIT_LATENCY;
+
+	return max_t(u64, wait, NTV2_PCM_PERIOD_WAIT_MIN);
+}
+
 void ntv2_pcmops_copy_audio(struct ntv2_pcm_stream *stream,
 							u8 *address,
 							u32 size,
 							u32 num_channels,
-							u32 sample_size)
+							u32 sample_size,
+							v4l2_time_t timestamp)
 {
 	struct ntv2_audio *ntv2_aud = stream->ntv2_aud;
 	struct snd_pcm_substream *substream;
@@ -516,8 +584,10 @@ void ntv2_pcmops_copy_audio(struct ntv2_pcm_stream *stream,
 
 	snd_pcm_stream_lock(substream);
 	stream->sample_ptr = (stream->sample_ptr + buf_frames)%runtime->buffer_size;
+	stream->tstamp_frames += buf_frames;
+	stream->tstamp_time = timestamp;
 	stream->period_ptr += buf_frames;
-	if (stream->period_ptr > runtime->period_size) {
+	if (stream->period_ptr >= runtime->period_size) {
 		stream->period_ptr %= runtime->period_size;
 		new_period = true;
 	}
@@ -544,7 +614,7 @@ static int ntv2_allocate_dma_buffer(struct ntv2_pcm_stream *stream)
 
 	/* allocate the dma buffer */
 	num_bytes = PAGE_ALIGN(NTV2_PCM_DMA_BUFFER_SIZE);
-	stream->dma_buffer = vmalloc(num_bytes);
+	stream->dma_buffer = vmalloc_node(num_bytes, ntv2_aud->ntv2_dev->numa_node);
 	if (stream->dma_buffer == NULL) {
 		NTV2_MSG_AUDIO_ERROR("%s: *error* dma buffer allocation failed\n",
 							 ntv2_aud->name);
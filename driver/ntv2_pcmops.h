@@ -26,10 +26,13 @@ int ntv2_pcmops_configure(struct ntv2_pcm_stream *stream);
 
 void ntv2_pcmops_tstamp(struct ntv2_pcm_stream *stream);
 
+u64 ntv2_pcmops_period_wait(struct ntv2_pcm_stream *stream);
+
 void ntv2_pcmops_copy_audio(struct ntv2_pcm_stream *stream,
 							u8 *address,
 							u32 size,
 							u32 num_channels,
-							u32 sample_size);
+							u32 sample_size,
+							v4l2_time_t timestamp);
 
 #endif
@@ -25,7 +25,8 @@ struct ntv2_register *ntv2_register_open(struct ntv2_object *ntv2_obj,
 {
 	struct ntv2_register *ntv2_reg = NULL;
 
-	ntv2_reg = kzalloc(sizeof(struct ntv2_register), GFP_KERNEL);
+	ntv2_reg = kzalloc_node(sizeof(struct ntv2_register), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_reg == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_register instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
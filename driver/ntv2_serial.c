@@ -286,7 +286,8 @@ struct ntv2_serial *ntv2_serial_open(struct ntv2_object *ntv2_obj,
 	if (ntv2_obj == NULL)
 		return NULL;
 
-	ntv2_ser = kzalloc(sizeof(struct ntv2_serial), GFP_KERNEL);
+	ntv2_ser = kzalloc_node(sizeof(struct ntv2_serial), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_ser == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_serial instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
@@ -0,0 +1,247 @@
+/*
+ * NTV2 frame latency trace
+ *
+ * Copyright 2016 AJA Video Systems Inc. All rights reserved.
+ *
+ * This program is free software; you may redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ntv2_trace.h"
+
+#ifdef NTV2_USE_FRAME_TRACE
+
+struct ntv2_trace_snapshot {
+	u32						count;
+	struct ntv2_trace_entry	entry[NTV2_TRACE_SIZE];
+};
+
+static const struct file_operations ntv2_trace_text_fops;
+static const struct file_operations ntv2_trace_bin_fops;
+
+
+struct ntv2_trace *ntv2_trace_open(struct ntv2_object *ntv2_obj,
+								   const char *name, int index)
+{
+	struct ntv2_trace *ntv2_trc = NULL;
+
+	ntv2_trc = kzalloc_node(sizeof(struct ntv2_trace), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
+	if (ntv2_trc == NULL) {
+		NTV2_MSG_ERROR("%s: ntv2_trace instance memory allocation failed\n", ntv2_obj->name);
+		return NULL;
+	}
+
+	ntv2_trc->index = index;
+	snprintf(ntv2_trc->name, NTV2_STRING_SIZE, "%s-%s%d", ntv2_obj->name, name, index);
+	INIT_LIST_HEAD(&ntv2_trc->list);
+	ntv2_trc->ntv2_dev = ntv2_obj->ntv2_dev;
+
+	return ntv2_trc;
+}
+
+void ntv2_trace_close(struct ntv2_trace *ntv2_trc)
+{
+	if (ntv2_trc == NULL)
+		return;
+
+	debugfs_remove_recursive(ntv2_trc->debugfs_dir);
+
+	memset(ntv2_trc, 0, sizeof(struct ntv2_trace));
+	kfree(ntv2_trc);
+}
+
+int ntv2_trace_configure(struct ntv2_trace *ntv2_trc,
+						 struct dentry *parent,
+						 const char *dir_name)
+{
+	if ((ntv2_trc == NULL) || (dir_name == NULL))
+		return -EPERM;
+
+	/* debugfs is optional */
+	if (IS_ERR_OR_NULL(parent))
+		return 0;
+
+	ntv2_trc->debugfs_dir = debugfs_create_dir(dir_name, parent);
+	if (IS_ERR_OR_NULL(ntv2_trc->debugfs_dir)) {
+		NTV2_MSG_ERROR("%s: *error* debugfs trace directory create failed\n", ntv2_trc->name);
+		ntv2_trc->debugfs_dir = NULL;
+		return 0;
+	}
+
+	debugfs_create_file("trace", 0444, ntv2_trc->debugfs_dir, ntv2_trc, &ntv2_trace_text_fops);
+	debugfs_create_file("trace_bin", 0444, ntv2_trc->debugfs_dir, ntv2_trc, &ntv2_trace_bin_fops);
+
+	return 0;
+}
+
+void ntv2_trace_dma_start(struct ntv2_trace *ntv2_trc, u32 frame_number, s64 irq_time)
+{
+	struct ntv2_trace_entry *entry;
+
+	if (ntv2_trc == NULL)
+		return;
+
+	entry = &ntv2_trc->entry;
+	entry->frame_number = frame_number;
+	entry->irq_time = irq_time;
+	entry->dma_start_time = ktime_get_ns();
+	entry->dma_done_time = 0;
+}
+
+void ntv2_trace_dma_done(struct ntv2_trace *ntv2_trc)
+{
+	if (ntv2_trc == NULL)
+		return;
+
+	ntv2_trc->entry.dma_done_time = ktime_get_ns();
+}
+
+void ntv2_trace_buffer_done(struct ntv2_trace *ntv2_trc, u64 sequence)
+{
+	struct ntv2_trace_entry *entry;
+	u64 head;
+
+	if (ntv2_trc == NULL)
+		return;
+
+	ntv2_trc->entry.sequence = sequence;
+	ntv2_trc->entry.buffer_done_time = ktime_get_ns();
+
+	/* fill the slot before publishing the new head */
+	head = ntv2_trc->head;
+	entry = &ntv2_trc->ring[head & (NTV2_TRACE_SIZE - 1)];
+	*entry = ntv2_trc->entry;
+	smp_wmb();
+	WRITE_ONCE(ntv2_trc->head, head + 1);
+}
+
+/*
+ * Copy the ring without stopping the writer.  Entries the writer may have
+ * overwritten during the copy are dropped.
+ */
+static void ntv2_trace_snapshot(struct ntv2_trace *ntv2_trc,
+								struct ntv2_trace_snapshot *snap)
+{
+	u64 first;
+	u64 head;
+	u64 last;
+	u64 i;
+
+	head = READ_ONCE(ntv2_trc->head);
+	smp_rmb();
+	first = (head > NTV2_TRACE_SIZE)? head - NTV2_TRACE_SIZE : 0;
+	for (i = first; i < head; i++)
+		snap->entry[i - first] = ntv2_trc->ring[i & (NTV2_TRACE_SIZE - 1)];
+	smp_rmb();
+	last = READ_ONCE(ntv2_trc->head);
+
+	/* the slot for index last is being written */
+	if ((last + 1) > (first + NTV2_TRACE_SIZE)) {
+		i = last + 1 - NTV2_TRACE_SIZE - first;
+		if (i >= (head - first)) {
+			snap->count = 0;
+			return;
+		}
+		memmove(&snap->entry[0], &snap->entry[i],
+				(head - first - i) * sizeof(struct ntv2_trace_entry));
+		first += i;
+	}
+	snap->count = (u32)(head - first);
+}
+
+static int ntv2_trace_text_show(struct seq_file *s, void *v)
+{
+	struct ntv2_trace *ntv2_trc = (struct ntv2_trace *)s->private;
+	struct ntv2_trace_snapshot *snap;
+	struct ntv2_trace_entry *entry;
+	u32 i;
+
+	snap = vzalloc(sizeof(struct ntv2_trace_snapshot));
+	if (snap == NULL)
+		return -ENOMEM;
+
+	ntv2_trace_snapshot(ntv2_trc, snap);
+
+	/* latencies in ns relative to the frame interrupt */
+	seq_printf(s, "%10s %10s %14s %10s %10s %10s\n",
+			   "sequence", "frame", "irq_time", "dma_start", "dma_done", "buf_done");
+	for (i = 0; i < snap->count; i++) {
+		entry = &snap->entry[i];
+		seq_printf(s, "%10llu %10u %14lld %10lld %10lld %10lld\n",
+				   entry->sequence,
+				   entry->frame_number,
+				   entry->irq_time,
+				   entry->dma_start_time - entry->irq_time,
+				   entry->dma_done_time - entry->irq_time,
+				   entry->buffer_done_time - entry->irq_time);
+	}
+
+	vfree(snap);
+	return 0;
+}
+
+static int ntv2_trace_text_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, ntv2_trace_text_show, inode->i_private);
+}
+
+static const struct file_operations ntv2_trace_text_fops = {
+	.owner = THIS_MODULE,
+	.open = ntv2_trace_text_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int ntv2_trace_bin_open(struct inode *inode, struct file *file)
+{
+	struct ntv2_trace *ntv2_trc = (struct ntv2_trace *)inode->i_private;
+	struct ntv2_trace_snapshot *snap;
+
+	/* readers see the ring as it was at open */
+	snap = vzalloc(sizeof(struct ntv2_trace_snapshot));
+	if (snap == NULL)
+		return -ENOMEM;
+
+	ntv2_trace_snapshot(ntv2_trc, snap);
+	file->private_data = snap;
+
+	return 0;
+}
+
+static ssize_t ntv2_trace_bin_read(struct file *file, char __user *buf,
+								   size_t count, loff_t *ppos)
+{
+	struct ntv2_trace_snapshot *snap = (struct ntv2_trace_snapshot *)file->private_data;
+
+	/* array of struct ntv2_trace_entry */
+	return simple_read_from_buffer(buf, count, ppos, snap->entry,
+								   snap->count * sizeof(struct ntv2_trace_entry));
+}
+
+static int ntv2_trace_bin_release(struct inode *inode, struct file *file)
+{
+	vfree(file->private_data);
+	return 0;
+}
+
+static const struct file_operations ntv2_trace_bin_fops = {
+	.owner = THIS_MODULE,
+	.open = ntv2_trace_bin_open,
+	.read = ntv2_trace_bin_read,
+	.llseek = default_llseek,
+	.release = ntv2_trace_bin_release,
+};
+
+#endif
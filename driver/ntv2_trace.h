@@ -0,0 +1,64 @@
+/*
+ * NTV2 frame latency trace
+ *
+ * Copyright 2016 AJA Video Systems Inc. All rights reserved.
+ *
+ * This program is free software; you may redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef NTV2_TRACE_H
+#define NTV2_TRACE_H
+
+#include "ntv2_common.h"
+
+#define NTV2_TRACE_SIZE			256		/* power of 2 */
+
+/* times are monotonic ns */
+struct ntv2_trace_entry {
+	u64					sequence;
+	u32					frame_number;
+	u32					reserved;
+	s64					irq_time;
+	s64					dma_start_time;
+	s64					dma_done_time;
+	s64					buffer_done_time;
+};
+
+struct ntv2_trace {
+	int					index;
+	char				name[NTV2_STRING_SIZE];
+	struct list_head	list;
+	struct ntv2_device	*ntv2_dev;
+
+	struct dentry		*debugfs_dir;
+	struct ntv2_trace_entry	entry;
+	struct ntv2_trace_entry	ring[NTV2_TRACE_SIZE];
+	u64					head;
+};
+
+struct ntv2_trace *ntv2_trace_open(struct ntv2_object *ntv2_obj,
+								   const char *name, int index);
+void ntv2_trace_close(struct ntv2_trace *ntv2_trc);
+
+int ntv2_trace_configure(struct ntv2_trace *ntv2_trc,
+						 struct dentry *parent,
+						 const char *dir_name);
+
+/* single writer, called from the transfer task and dma callback */
+void ntv2_trace_dma_start(struct ntv2_trace *ntv2_trc, u32 frame_number, s64 irq_time);
+void ntv2_trace_dma_done(struct ntv2_trace *ntv2_trc);
+void ntv2_trace_buffer_done(struct ntv2_trace *ntv2_trc, u64 sequence);
+
+#endif
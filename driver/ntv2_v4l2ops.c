@@ -26,6 +26,23 @@
 #include "ntv2_input.h"
 #include "ntv2_register.h"
 
+u32 ntv2_v4l2ops_device_caps(struct ntv2_video *ntv2_vid)
+{
+#ifdef NTV2_USE_META_CAPTURE
+	if (ntv2_vid->anc)
+		return V4L2_CAP_META_CAPTURE | V4L2_CAP_STREAMING;
+#endif
+	if (ntv2_vid->output) {
+		if (ntv2_vid->mplane)
+			return V4L2_CAP_VIDEO_OUTPUT_MPLANE | V4L2_CAP_STREAMING;
+		return V4L2_CAP_VIDEO_OUTPUT | V4L2_CAP_READWRITE | V4L2_CAP_STREAMING;
+	}
+
+	if (ntv2_vid->mplane)
+		return V4L2_CAP_VIDEO_CAPTURE_MPLANE | V4L2_CAP_STREAMING;
+	return V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_READWRITE | V4L2_CAP_STREAMING;
+}
+
 static int ntv2_querycap(struct file *file,
 						 void *priv,
 						 struct v4l2_capability *cap)
@@ -38,21 +55,59 @@ static int ntv2_querycap(struct file *file,
 			 "%s Channel %d", ntv2_vid->features->device_name, ntv2_vid->index + 1);
 	snprintf(cap->bus_info, sizeof(cap->bus_info),
 			 "PCI:%s", pci_name(ntv2_vid->ntv2_dev->pci_dev));
-	cap->device_caps = V4L2_CAP_VIDEO_CAPTURE |
-		V4L2_CAP_READWRITE |
-		V4L2_CAP_STREAMING;
+	cap->device_caps = ntv2_v4l2ops_device_caps(ntv2_vid);
 	cap->capabilities = cap->device_caps |
 		V4L2_CAP_DEVICE_CAPS;
 
 	return 0;
 }
 
-static void ntv2_v4l2ops_fill_pix_format(struct ntv2_video_format *vidf,
-										 struct ntv2_pixel_format *pixf,
+static void ntv2_v4l2ops_crop_bounds(struct ntv2_video *ntv2_vid,
+									 struct v4l2_rect *rect)
+{
+	rect->left = 0;
+	rect->top = 0;
+	rect->width = ntv2_vid->video_format.v4l2_timings.bt.width;
+	rect->height = ntv2_vid->video_format.v4l2_timings.bt.height;
+}
+
+static void ntv2_v4l2ops_align_crop(struct ntv2_video *ntv2_vid,
+									const struct ntv2_pixel_format *pixf,
+									struct v4l2_rect *rect)
+{
+	struct v4l2_rect bounds;
+	u32 halign;
+	u32 valign = 1;
+
+	ntv2_v4l2ops_crop_bounds(ntv2_vid, &bounds);
+
+	/* contiguous planes can not be cropped */
+	if ((pixf->num_planes > 1) && (ntv2_features_buffer_planes(pixf) == 1)) {
+		*rect = bounds;
+		return;
+	}
+
+	/* crop on pixel cadence and chroma sample boundaries */
+	halign = max_t(u32, pixf->cadence_pixels, 2);
+	if (ntv2_vid->video_format.v4l2_timings.bt.interlaced ||
+		((pixf->pixel_flags & ntv2_kona_pixel_420) != 0))
+		valign = 2;
+
+	rect->width = clamp_t(u32, rounddown(rect->width, halign), halign, bounds.width);
+	rect->height = clamp_t(u32, rounddown(rect->height, valign), valign, bounds.height);
+	rect->left = clamp_t(s32, rounddown(max_t(s32, rect->left, 0), halign),
+						 0, bounds.width - rect->width);
+	rect->top = clamp_t(s32, rounddown(max_t(s32, rect->top, 0), valign),
+						0, bounds.height - rect->height);
+}
+
+static void ntv2_v4l2ops_fill_pix_format(const struct ntv2_video_format *vidf,
+										 const struct ntv2_pixel_format *pixf,
+										 struct v4l2_rect *crop,
 										 struct v4l2_pix_format *pix)
 {
-	pix->width = vidf->v4l2_timings.bt.width;
-	pix->height = vidf->v4l2_timings.bt.height;
+	pix->width = crop->width;
+	pix->height = crop->height;
 	if (vidf->v4l2_timings.bt.interlaced) {
 		pix->field = V4L2_FIELD_INTERLACED;
 	} else {
@@ -60,7 +115,7 @@ static void ntv2_v4l2ops_fill_pix_format(struct ntv2_video_format *vidf,
 	}
 	pix->pixelformat = pixf->v4l2_pixel_format;
 	pix->bytesperline = ntv2_features_line_pitch(pixf, pix->width);
-	pix->sizeimage = pix->bytesperline * pix->height;
+	pix->sizeimage = pix->bytesperline * ntv2_features_frame_lines(pixf, pix->height);
 	if ((pixf->pixel_flags & ntv2_kona_pixel_rgb) != 0) {
 		if ((pixf->pixel_flags & ntv2_kona_pixel_rec2020) != 0) {
 			pix->colorspace = 0; // V4L2_COLORSPACE_BT2020;
@@ -79,8 +134,132 @@ static void ntv2_v4l2ops_fill_pix_format(struct ntv2_video_format *vidf,
 	pix->priv = 0;
 }
 
+static void ntv2_v4l2ops_fill_pix_format_mp(const struct ntv2_video_format *vidf,
+											const struct ntv2_pixel_format *pixf,
+											struct v4l2_rect *crop,
+											struct v4l2_pix_format_mplane *pix_mp)
+{
+	struct v4l2_pix_format pix;
+	int i;
+
+	ntv2_v4l2ops_fill_pix_format(vidf, pixf, crop, &pix);
+
+	memset(pix_mp, 0, sizeof(struct v4l2_pix_format_mplane));
+	pix_mp->width = pix.width;
+	pix_mp->height = pix.height;
+	pix_mp->field = pix.field;
+	pix_mp->pixelformat = pix.pixelformat;
+	pix_mp->colorspace = pix.colorspace;
+	pix_mp->num_planes = ntv2_features_buffer_planes(pixf);
+	for (i = 0; i < pix_mp->num_planes; i++) {
+		pix_mp->plane_fmt[i].bytesperline = pix.bytesperline;
+		pix_mp->plane_fmt[i].sizeimage = pix.bytesperline *
+			ntv2_features_plane_lines(pixf, i, pix.height);
+	}
+}
+
+static void ntv2_v4l2ops_update_format(struct ntv2_video *ntv2_vid)
+{
+	ntv2_v4l2ops_align_crop(ntv2_vid, &ntv2_vid->pixel_format, &ntv2_vid->crop);
+	ntv2_v4l2ops_fill_pix_format(&ntv2_vid->video_format,
+								 &ntv2_vid->pixel_format,
+								 &ntv2_vid->crop,
+								 &ntv2_vid->v4l2_format);
+	ntv2_v4l2ops_fill_pix_format_mp(&ntv2_vid->video_format,
+									&ntv2_vid->pixel_format,
+									&ntv2_vid->crop,
+									&ntv2_vid->v4l2_format_mp);
+}
+
+struct ntv2_v4l2ops_state {
+	struct ntv2_input_format	input_format;
+	struct ntv2_video_format	video_format;
+	struct ntv2_pixel_format	pixel_format;
+	struct v4l2_dv_timings		v4l2_timings;
+	struct v4l2_rect			crop;
+	v4l2_std_id					tvnorms;
+	u32							v4l2_input;
+	bool						drop_frame;
+};
+
+static int ntv2_v4l2ops_change_begin(struct ntv2_video *ntv2_vid,
+									 struct ntv2_v4l2ops_state *state)
+{
+	/* allocated buffers that are not streaming can not be reprogrammed */
+	if (!vb2_is_streaming(&ntv2_vid->vb2_queue)) {
+		NTV2_MSG_VIDEO_ERROR("%s: *error* format change with buffers allocated\n",
+							 ntv2_vid->name);
+		return -EBUSY;
+	}
+
+	/* other readers own the channel format, the ancillary node follows it */
+	if (!ntv2_vid->anc &&
+		ntv2_channel_format_owner(ntv2_vid->vid_str, ntv2_vid->reader))
+		return -EBUSY;
+
+	state->input_format = ntv2_vid->input_format;
+	state->video_format = ntv2_vid->video_format;
+	state->pixel_format = ntv2_vid->pixel_format;
+	state->v4l2_timings = ntv2_vid->v4l2_timings;
+	state->crop = ntv2_vid->crop;
+	state->tvnorms = ntv2_vid->video_dev.tvnorms;
+	state->v4l2_input = ntv2_vid->v4l2_input;
+	state->drop_frame = ntv2_vid->drop_frame;
+
+	/* hold dma until the new format is in place */
+	return ntv2_video_pause(ntv2_vid);
+}
+
+static int ntv2_v4l2ops_change_commit(struct ntv2_video *ntv2_vid,
+									  struct ntv2_v4l2ops_state *state)
+{
+	int result = -EBUSY;
+
+	/* update v4l2 pixel format */
+	ntv2_v4l2ops_update_format(ntv2_vid);
+
+	if (state == NULL) {
+		/* update video state */
+		ntv2_video_update(ntv2_vid);
+		return 0;
+	}
+
+	/* keep the queue when the new format fits the buffers */
+	if (ntv2_vb2ops_format_fits(ntv2_vid)) {
+		result = ntv2_video_reconfigure(ntv2_vid);
+		if (result == 0) {
+			NTV2_MSG_VIDEO_STATE("%s: format change while streaming\n", ntv2_vid->name);
+			return 0;
+		}
+	} else {
+		NTV2_MSG_VIDEO_ERROR("%s: *error* format change does not fit the allocated buffers\n",
+							 ntv2_vid->name);
+	}
+
+	/* restore the old format */
+
+	ntv2_vid->input_format = state->input_format;
+	ntv2_vid->video_format = state->video_format;
+	ntv2_vid->pixel_format = state->pixel_format;
+	ntv2_vid->v4l2_timings = state->v4l2_timings;
+	ntv2_vid->crop = state->crop;
+	ntv2_vid->video_dev.tvnorms = state->tvnorms;
+	ntv2_vid->v4l2_input = state->v4l2_input;
+	ntv2_vid->drop_frame = state->drop_frame;
+	ntv2_v4l2ops_update_format(ntv2_vid);
+	ntv2_video_resume(ntv2_vid);
+
+	return result;
+}
+
+static bool ntv2_v4l2ops_capture_type(struct ntv2_video *ntv2_vid, u32 type)
+{
+	return (type == V4L2_BUF_TYPE_VIDEO_CAPTURE) ||
+		(type == ntv2_vid->vb2_queue.type);
+}
+
 bool ntv2_compatible_input_format(struct ntv2_input_format *inpf,
-								  struct ntv2_video_format *vidf)
+								  const struct ntv2_video_format *vidf)
 {
 	bool match;
 
@@ -104,18 +283,26 @@ bool ntv2_compatible_input_format(struct ntv2_input_format *inpf,
 	return match;
 }
 
-static struct ntv2_pixel_format
+static const struct ntv2_pixel_format
 *ntv2_find_pixel_format(struct ntv2_features *features,
 						u32 channel_index,
-						u32 v4l2_pixel_format)
+						u32 v4l2_pixel_format,
+						bool mplane,
+						bool output)
 {
-	struct ntv2_pixel_format *pixf;
+	const struct ntv2_pixel_format *pixf;
 	int i;
 
 	for (i = 0; i < NTV2_MAX_PIXEL_FORMATS; i++) {
 		pixf = ntv2_features_get_pixel_format(features, channel_index, i);
 		if (pixf == NULL)
 			return NULL;
+		/* separate buffer planes need the mplane api */
+		if (!mplane && (ntv2_features_buffer_planes(pixf) > 1))
+			continue;
+		/* playback has no color space converter */
+		if (output && ((pixf->pixel_flags & ntv2_kona_pixel_rgb) != 0))
+			continue;
 		if (pixf->v4l2_pixel_format == v4l2_pixel_format)
 			return pixf;
 	}
@@ -123,44 +310,57 @@ static struct ntv2_pixel_format
 	return NULL;
 }
 
-static struct ntv2_video_format
-*ntv2_find_video_format(struct ntv2_features *features,
+static const struct ntv2_pixel_format
+*ntv2_enum_pixel_format(struct ntv2_features *features,
 						u32 channel_index,
-						struct v4l2_dv_timings* v4l2_timings,
-						bool drop_frame)
+						u32 format_index,
+						bool mplane,
+						bool output)
 {
-	struct ntv2_video_format *vidf;
+	const struct ntv2_pixel_format *pixf;
 	int i;
 
-	for (i = 0; i < NTV2_MAX_VIDEO_FORMATS; i++) {
-		vidf = ntv2_features_get_video_format(features, channel_index, i);
-		if (vidf == NULL)
+	for (i = 0; i < NTV2_MAX_PIXEL_FORMATS; i++) {
+		pixf = ntv2_features_get_pixel_format(features, channel_index, i);
+		if (pixf == NULL)
 			return NULL;
-		if (ntv2_features_match_dv_timings(v4l2_timings, &vidf->v4l2_timings, 0) &&
-			(drop_frame == ntv2_frame_rate_drop(vidf->frame_rate)))
-			return vidf;
+		if (!mplane && (ntv2_features_buffer_planes(pixf) > 1))
+			continue;
+		if (output && ((pixf->pixel_flags & ntv2_kona_pixel_rgb) != 0))
+			continue;
+		if (format_index == 0)
+			return pixf;
+		format_index--;
 	}
 
 	return NULL;
 }
 
-static struct ntv2_video_format
+static const struct ntv2_video_format
+*ntv2_find_video_format(struct ntv2_features *features,
+						u32 channel_index,
+						struct v4l2_dv_timings* v4l2_timings,
+						bool drop_frame)
+{
+	return ntv2_features_find_timings_format(features, channel_index,
+											 v4l2_timings, drop_frame);
+}
+
+static const struct ntv2_video_format
 *ntv2_find_input_format(struct ntv2_features *features,
 						u32 channel_index,
 						struct ntv2_input_format *inpf)
 {
-	struct ntv2_video_format *vidf;
-	int i;
+	const struct ntv2_video_format *vidf;
 
-	for (i = 0; i < NTV2_MAX_VIDEO_FORMATS; i++) {
-		vidf = ntv2_features_get_video_format(features, channel_index, i);
-		if (vidf == NULL)
-			return NULL;
-		if (ntv2_compatible_input_format(inpf, vidf))
-			return vidf;
-	}
+	vidf = ntv2_features_find_video_format(features, channel_index,
+										   inpf->video_standard,
+										   inpf->frame_rate,
+										   inpf->frame_flags);
+	if (!ntv2_compatible_input_format(inpf, vidf))
+		return NULL;
 
-	return NULL;
+	return vidf;
 }
 
 static int ntv2_try_fmt_vid_cap(struct file *file,
@@ -169,15 +369,18 @@ static int ntv2_try_fmt_vid_cap(struct file *file,
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
 	struct v4l2_pix_format *pix = &format->fmt.pix;
-	struct ntv2_pixel_format *pixf;
+	const struct ntv2_pixel_format *pixf;
+	struct v4l2_rect crop;
 
-	if (format->type != V4L2_BUF_TYPE_VIDEO_CAPTURE)
+	if (format->type != ntv2_vid->vb2_queue.type)
 		return -EINVAL;
 
 	/* find ntv2 video format to match v4l2 pixel format */
 	pixf = ntv2_find_pixel_format(ntv2_vid->features,
 								  ntv2_vid->ntv2_chn->index,
-								  pix->pixelformat);
+								  pix->pixelformat,
+								  ntv2_vid->mplane,
+								  ntv2_vid->output);
 	if (pixf != NULL) {
 		NTV2_MSG_VIDEO_STATE("%s: try_fmt_vid_cap accept pixel format %c%c%c%c\n",
 							 ntv2_vid->name, NTV2_FOURCC_CHARS(&pix->pixelformat));
@@ -190,7 +393,9 @@ static int ntv2_try_fmt_vid_cap(struct file *file,
 	}
 
 	/* fill in v4l2 pixel info */
-	ntv2_v4l2ops_fill_pix_format(&ntv2_vid->video_format, pixf, pix);
+	crop = ntv2_vid->crop;
+	ntv2_v4l2ops_align_crop(ntv2_vid, pixf, &crop);
+	ntv2_v4l2ops_fill_pix_format(&ntv2_vid->video_format, pixf, &crop, pix);
 
 	return 0;
 }
@@ -201,7 +406,10 @@ static int ntv2_s_fmt_vid_cap(struct file *file,
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
 	struct v4l2_pix_format *pix = &format->fmt.pix;
-	struct ntv2_pixel_format *pixf;
+	const struct ntv2_pixel_format *pixf;
+	struct ntv2_v4l2ops_state state;
+	struct ntv2_v4l2ops_state *busy = NULL;
+	int result;
 
 	/* test and fill pixel format */
 	if (ntv2_try_fmt_vid_cap(file, fh, format) != 0)
@@ -211,17 +419,12 @@ static int ntv2_s_fmt_vid_cap(struct file *file,
 	if (pix->pixelformat == ntv2_vid->v4l2_format.pixelformat)
 		return 0;
 
-	/* no format changes while streaming */
-	if (vb2_is_busy(&ntv2_vid->vb2_queue)) {
-		NTV2_MSG_VIDEO_ERROR("%s: *error* format change while streaming\n",
-							 ntv2_vid->name);
-		return -EBUSY;
-	}
-
 	/* find ntv2 frame format to match the v4l2 pixel format */
 	pixf = ntv2_find_pixel_format(ntv2_vid->features,
 								  ntv2_vid->ntv2_chn->index,
-								  pix->pixelformat);
+								  pix->pixelformat,
+								  ntv2_vid->mplane,
+								  ntv2_vid->output);
 	if (pixf == NULL) {
 		NTV2_MSG_VIDEO_STATE("%s: s_fmt_vid_cap reject pixel format %c%c%c%c\n",
 							 ntv2_vid->name, NTV2_FOURCC_CHARS(&pix->pixelformat));
@@ -231,18 +434,18 @@ static int ntv2_s_fmt_vid_cap(struct file *file,
 	NTV2_MSG_VIDEO_STATE("%s: s_fmt_vid_cap accept pixel format %c%c%c%c\n",
 						 ntv2_vid->name, NTV2_FOURCC_CHARS(&pix->pixelformat));
 
+	/* pause the queue for format changes */
+	if (vb2_is_busy(&ntv2_vid->vb2_queue)) {
+		result = ntv2_v4l2ops_change_begin(ntv2_vid, &state);
+		if (result != 0)
+			return result;
+		busy = &state;
+	}
+
 	/* update ntv2 pixel format */
 	ntv2_vid->pixel_format = *pixf;
 
-	/* update v4l2 pixel format */
-	ntv2_v4l2ops_fill_pix_format(&ntv2_vid->video_format,
-								 &ntv2_vid->pixel_format,
-								 &ntv2_vid->v4l2_format);
-
-	/* update video state */
-	ntv2_video_update(ntv2_vid);
-
-	return 0;
+	return ntv2_v4l2ops_change_commit(ntv2_vid, busy);
 }
 
 static int ntv2_g_fmt_vid_cap(struct file *file,
@@ -251,6 +454,9 @@ static int ntv2_g_fmt_vid_cap(struct file *file,
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
 
+	if (format->type != ntv2_vid->vb2_queue.type)
+		return -EINVAL;
+
 	format->fmt.pix = ntv2_vid->v4l2_format;
 
 	NTV2_MSG_VIDEO_STATE("%s: g_fmt_vid_cap pixel format %c%c%c%c\n",
@@ -264,11 +470,16 @@ static int ntv2_enum_fmt_vid_cap(struct file *file,
 								 struct v4l2_fmtdesc *format)
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
-	struct ntv2_pixel_format *pixf;
+	const struct ntv2_pixel_format *pixf;
 
-	pixf = ntv2_features_get_pixel_format(ntv2_vid->features,
-										  ntv2_vid->ntv2_chn->index,
-										  format->index);
+	if (format->type != ntv2_vid->vb2_queue.type)
+		return -EINVAL;
+
+	pixf = ntv2_enum_pixel_format(ntv2_vid->features,
+								  ntv2_vid->ntv2_chn->index,
+								  format->index,
+								  ntv2_vid->mplane,
+								  ntv2_vid->output);
 	if (pixf == NULL) {
 		NTV2_MSG_VIDEO_STATE("%s: enum_fmt_vid_cap index %d  done\n",
 							 ntv2_vid->name, format->index);
@@ -276,7 +487,6 @@ static int ntv2_enum_fmt_vid_cap(struct file *file,
 	}
 
 	strscpy(format->description, pixf->name, sizeof(format->description));
-	format->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 	format->flags = 0;
 	format->pixelformat = pixf->v4l2_pixel_format;
 
@@ -285,6 +495,136 @@ static int ntv2_enum_fmt_vid_cap(struct file *file,
 	return 0;
 }
 
+static int ntv2_try_fmt_vid_cap_mplane(struct file *file,
+									   void *fh,
+									   struct v4l2_format *format)
+{
+	struct ntv2_video *ntv2_vid = video_drvdata(file);
+	struct v4l2_pix_format_mplane *pix_mp = &format->fmt.pix_mp;
+	const struct ntv2_pixel_format *pixf;
+	struct v4l2_rect crop;
+
+	if (format->type != ntv2_vid->vb2_queue.type)
+		return -EINVAL;
+
+	/* find ntv2 video format to match v4l2 pixel format */
+	pixf = ntv2_find_pixel_format(ntv2_vid->features,
+								  ntv2_vid->ntv2_chn->index,
+								  pix_mp->pixelformat,
+								  true,
+								  ntv2_vid->output);
+	if (pixf != NULL) {
+		NTV2_MSG_VIDEO_STATE("%s: try_fmt_vid_cap_mplane accept pixel format %c%c%c%c\n",
+							 ntv2_vid->name, NTV2_FOURCC_CHARS(&pix_mp->pixelformat));
+	} else {
+		NTV2_MSG_VIDEO_STATE("%s: try_fmt_vid_cap_mplane pixel format %c%c%c%c not supported\n",
+							 ntv2_vid->name, NTV2_FOURCC_CHARS(&pix_mp->pixelformat));
+		/* return default pixel format if not supported */
+		pixf = ntv2_features_get_default_pixel_format(ntv2_vid->features,
+													  ntv2_vid->ntv2_chn->index);
+	}
+
+	/* fill in v4l2 pixel info */
+	crop = ntv2_vid->crop;
+	ntv2_v4l2ops_align_crop(ntv2_vid, pixf, &crop);
+	ntv2_v4l2ops_fill_pix_format_mp(&ntv2_vid->video_format, pixf, &crop, pix_mp);
+
+	return 0;
+}
+
+static int ntv2_s_fmt_vid_cap_mplane(struct file *file,
+									 void *fh,
+									 struct v4l2_format *format)
+{
+	struct ntv2_video *ntv2_vid = video_drvdata(file);
+	struct v4l2_pix_format_mplane *pix_mp = &format->fmt.pix_mp;
+	const struct ntv2_pixel_format *pixf;
+	struct ntv2_v4l2ops_state state;
+	struct ntv2_v4l2ops_state *busy = NULL;
+	int result;
+
+	/* test and fill pixel format */
+	if (ntv2_try_fmt_vid_cap_mplane(file, fh, format) != 0)
+		return -EINVAL;
+
+	/* test for new pixel format */
+	if (pix_mp->pixelformat == ntv2_vid->v4l2_format_mp.pixelformat)
+		return 0;
+
+	/* find ntv2 frame format to match the v4l2 pixel format */
+	pixf = ntv2_find_pixel_format(ntv2_vid->features,
+								  ntv2_vid->ntv2_chn->index,
+								  pix_mp->pixelformat,
+								  true,
+								  ntv2_vid->output);
+	if (pixf == NULL) {
+		NTV2_MSG_VIDEO_STATE("%s: s_fmt_vid_cap_mplane reject pixel format %c%c%c%c\n",
+							 ntv2_vid->name, NTV2_FOURCC_CHARS(&pix_mp->pixelformat));
+		return -EINVAL;
+	}
+
+	NTV2_MSG_VIDEO_STATE("%s: s_fmt_vid_cap_mplane accept pixel format %c%c%c%c  planes %d\n",
+						 ntv2_vid->name, NTV2_FOURCC_CHARS(&pix_mp->pixelformat),
+						 pix_mp->num_planes);
+
+	/* pause the queue for format changes */
+	if (vb2_is_busy(&ntv2_vid->vb2_queue)) {
+		result = ntv2_v4l2ops_change_begin(ntv2_vid, &state);
+		if (result != 0)
+			return result;
+		busy = &state;
+	}
+
+	/* update ntv2 pixel format */
+	ntv2_vid->pixel_format = *pixf;
+
+	return ntv2_v4l2ops_change_commit(ntv2_vid, busy);
+}
+
+static int ntv2_g_fmt_vid_cap_mplane(struct file *file,
+									 void *fh,
+									 struct v4l2_format *format)
+{
+	struct ntv2_video *ntv2_vid = video_drvdata(file);
+
+	if (format->type != ntv2_vid->vb2_queue.type)
+		return -EINVAL;
+
+	format->fmt.pix_mp = ntv2_vid->v4l2_format_mp;
+
+	NTV2_MSG_VIDEO_STATE("%s: g_fmt_vid_cap_mplane pixel format %c%c%c%c  planes %d\n",
+						 ntv2_vid->name, NTV2_FOURCC_CHARS(&format->fmt.pix_mp.pixelformat),
+						 format->fmt.pix_mp.num_planes);
+
+	return 0;
+}
+
+#ifdef NTV2_USE_META_CAPTURE
+static int ntv2_g_fmt_meta_cap(struct file *file,
+							   void *priv,
+							   struct v4l2_format *f)
+{
+	/* fixed size buffer holds both fields */
+	f->fmt.meta.dataformat = NTV2_META_FMT_ANC;
+	f->fmt.meta.buffersize = 2 * NTV2_ANC_FIELD_SIZE;
+
+	return 0;
+}
+
+static int ntv2_enum_fmt_meta_cap(struct file *file,
+								  void *priv,
+								  struct v4l2_fmtdesc *f)
+{
+	if (f->index != 0)
+		return -EINVAL;
+
+	f->pixelformat = NTV2_META_FMT_ANC;
+	strscpy(f->description, "NTV2 ancillary data", sizeof(f->description));
+
+	return 0;
+}
+#endif
+
 static int ntv2_s_std(struct file *file, void *fh, v4l2_std_id std)
 {
 	/* no analog input */
@@ -315,7 +655,7 @@ static int ntv2_pixelaspect(struct file *file,
 	u32 standard = ntv2_vid->input_format.video_standard;
 	u32 flags = ntv2_vid->input_format.frame_flags;
 
-	if (type != V4L2_BUF_TYPE_VIDEO_CAPTURE)
+	if (!ntv2_v4l2ops_capture_type(ntv2_vid, type))
 		return -EINVAL;
 
 	/* aspect ratio x/y x:y doc says y/x but confuses vlc */
@@ -356,7 +696,7 @@ static int ntv2_cropcap(struct file *file,
 	u32 standard = ntv2_vid->input_format.video_standard;
 	u32 flags = ntv2_vid->input_format.frame_flags;
 
-	if ((cap->type != V4L2_BUF_TYPE_VIDEO_CAPTURE) ||
+	if (!ntv2_v4l2ops_capture_type(ntv2_vid, cap->type) ||
 		(standard == ntv2_kona_video_standard_none))
 		return -EINVAL;
 
@@ -399,13 +739,83 @@ static int ntv2_cropcap(struct file *file,
 }
 #endif
 
+static int ntv2_g_selection(struct file *file,
+							void *fh,
+							struct v4l2_selection *sel)
+{
+	struct ntv2_video *ntv2_vid = video_drvdata(file);
+
+	if (!ntv2_v4l2ops_capture_type(ntv2_vid, sel->type))
+		return -EINVAL;
+
+	switch (sel->target) {
+	case V4L2_SEL_TGT_CROP:
+		sel->r = ntv2_vid->crop;
+		break;
+	case V4L2_SEL_TGT_CROP_DEFAULT:
+	case V4L2_SEL_TGT_CROP_BOUNDS:
+		ntv2_v4l2ops_crop_bounds(ntv2_vid, &sel->r);
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int ntv2_s_selection(struct file *file,
+							void *fh,
+							struct v4l2_selection *sel)
+{
+	struct ntv2_video *ntv2_vid = video_drvdata(file);
+	struct v4l2_rect rect;
+
+	if (!ntv2_v4l2ops_capture_type(ntv2_vid, sel->type) ||
+		(sel->target != V4L2_SEL_TGT_CROP))
+		return -EINVAL;
+
+	rect = sel->r;
+	ntv2_v4l2ops_align_crop(ntv2_vid, &ntv2_vid->pixel_format, &rect);
+
+	/* test for new crop */
+	if ((rect.left == ntv2_vid->crop.left) &&
+		(rect.top == ntv2_vid->crop.top) &&
+		(rect.width == ntv2_vid->crop.width) &&
+		(rect.height == ntv2_vid->crop.height)) {
+		sel->r = rect;
+		return 0;
+	}
+
+	/* crop changes the image size */
+	if (vb2_is_busy(&ntv2_vid->vb2_queue)) {
+		NTV2_MSG_VIDEO_ERROR("%s: *error* crop change while streaming\n",
+							 ntv2_vid->name);
+		return -EBUSY;
+	}
+
+	NTV2_MSG_VIDEO_STATE("%s: s_selection crop left %d  top %d  width %d  height %d\n",
+						 ntv2_vid->name, rect.left, rect.top, rect.width, rect.height);
+
+	ntv2_vid->crop = rect;
+	sel->r = rect;
+
+	/* update v4l2 pixel format */
+	ntv2_v4l2ops_update_format(ntv2_vid);
+
+	return 0;
+}
+
 static int ntv2_s_dv_timings(struct file *file,
 							 void *fh,
 							 struct v4l2_dv_timings *v4l2_timings)
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
-	struct ntv2_input_config *config;
-	struct ntv2_video_format *vidf;
+	const struct ntv2_input_config *config;
+	const struct ntv2_video_format *vidf;
+	struct ntv2_input_format inpf;
+	struct ntv2_v4l2ops_state state;
+	struct ntv2_v4l2ops_state *busy = NULL;
+	int result;
 
 	NTV2_MSG_VIDEO_STATE("%s: s_dv_timings\n",
 						 ntv2_vid->name);
@@ -420,7 +830,7 @@ static int ntv2_s_dv_timings(struct file *file,
 	/* validate requested timings */
 	if (!ntv2_features_valid_dv_timings(ntv2_vid->features,
 										v4l2_timings,
-										&config->v4l2_timings_cap)) {
+										config->v4l2_timings_cap)) {
 		NTV2_MSG_VIDEO_ERROR("%s: *error* invalid dv timings\n",
 							 ntv2_vid->name);
 		return -EINVAL;
@@ -429,28 +839,26 @@ static int ntv2_s_dv_timings(struct file *file,
 	/* find CEA-861 timings */
 	if (!ntv2_features_find_dv_timings_cap(ntv2_vid->features,
 										   v4l2_timings,
-										   &config->v4l2_timings_cap, 0)) {
+										   config->v4l2_timings_cap, 0)) {
 		NTV2_MSG_VIDEO_ERROR("%s: *error* can not find dv timings\n",
 							 ntv2_vid->name);
 		return -EINVAL;
 	}
 
-	/* no timing changes while streaming */
-	if (vb2_is_busy(&ntv2_vid->vb2_queue)) {
-		/* test for new timings */
-		if (ntv2_features_match_dv_timings(v4l2_timings, &ntv2_vid->v4l2_timings, 0))
-			return 0;
-
-		NTV2_MSG_VIDEO_ERROR("%s: *error* timings change while streaming\n",
-							 ntv2_vid->name);
-		return -EBUSY;
-	}
+	/* test for new timings while streaming */
+	if (vb2_is_busy(&ntv2_vid->vb2_queue) &&
+		ntv2_features_match_dv_timings(v4l2_timings, &ntv2_vid->v4l2_timings, 0))
+		return 0;
 
 	/* find ntv2 video format to match v4l2 timings */
 	vidf = ntv2_find_video_format(ntv2_vid->features,
 								  ntv2_vid->ntv2_chn->index,
 								  v4l2_timings,
 								  ntv2_vid->drop_frame);
+	/* playback is single link */
+	if ((vidf != NULL) && ntv2_vid->output &&
+		(vidf->video_standard > ntv2_kona_video_standard_2048x1080i))
+		vidf = NULL;
 	if (vidf == NULL) {
 		NTV2_MSG_VIDEO_STATE("%s: s_dv_timings reject timing  width %d  height %d  interlaced %d\n",
 							 ntv2_vid->name,
@@ -466,22 +874,35 @@ static int ntv2_s_dv_timings(struct file *file,
 						 v4l2_timings->bt.height,
 						 v4l2_timings->bt.interlaced);
 
+	/* pause the queue for timing changes */
+	if (vb2_is_busy(&ntv2_vid->vb2_queue)) {
+		result = ntv2_v4l2ops_change_begin(ntv2_vid, &state);
+		if (result != 0)
+			return result;
+		busy = &state;
+	}
+
 	NTV2_MSG_VIDEO_STATE("%s: set video format %s\n",
 						 ntv2_vid->name, vidf->name);
 
 	/* update ntv2 video format and v4l2 timing */
 	ntv2_vid->video_format = *vidf;
 	ntv2_vid->v4l2_timings = vidf->v4l2_timings;
+	ntv2_v4l2ops_crop_bounds(ntv2_vid, &ntv2_vid->crop);
+
+	/* playback generates its format, capture follows the live input */
+	if (ntv2_vid->output) {
+		ntv2_features_gen_input_format(ntv2_features_get_default_input_config(ntv2_vid->features,
+																			   ntv2_vid->index),
+									   vidf,
+									   &ntv2_vid->pixel_format,
+									   &ntv2_vid->input_format);
+	} else if ((ntv2_input_get_input_format(ntv2_vid->ntv2_inp, config, &inpf) >= 0) &&
+			   ntv2_compatible_input_format(&inpf, vidf)) {
+		ntv2_vid->input_format = inpf;
+	}
 
-	/* update v4l2 pixel format */
-	ntv2_v4l2ops_fill_pix_format(&ntv2_vid->video_format,
-								 &ntv2_vid->pixel_format,
-								 &ntv2_vid->v4l2_format);
-
-	/* update video state */
-	ntv2_video_update(ntv2_vid);
-
-	return 0;
+	return ntv2_v4l2ops_change_commit(ntv2_vid, busy);
 }
 
 static int ntv2_g_dv_timings(struct file *file,
@@ -489,7 +910,7 @@ static int ntv2_g_dv_timings(struct file *file,
 							 struct v4l2_dv_timings *v4l2_timings)
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
-	struct ntv2_input_config *config;
+	const struct ntv2_input_config *config;
 
 	NTV2_MSG_VIDEO_STATE("%s: g_dv_timings\n",
 						 ntv2_vid->name);
@@ -511,7 +932,7 @@ static int ntv2_enum_dv_timings(struct file *file,
 								struct v4l2_enum_dv_timings *enum_timings)
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
-	struct ntv2_input_config *config;
+	const struct ntv2_input_config *config;
 
 	NTV2_MSG_VIDEO_STATE("%s: enum_dv_timings\n",
 						 ntv2_vid->name);
@@ -530,7 +951,7 @@ static int ntv2_enum_dv_timings(struct file *file,
 
 	return ntv2_features_enum_dv_timings_cap(ntv2_vid->features,
 											 enum_timings,
-											 &config->v4l2_timings_cap);
+											 config->v4l2_timings_cap);
 }
 
 /*
@@ -541,9 +962,9 @@ static int ntv2_query_dv_timings(struct file *file,
 								 struct v4l2_dv_timings *v4l2_timings)
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
-	struct ntv2_input_config *config;
+	const struct ntv2_input_config *config;
 	struct ntv2_input_format inpf;
-	struct ntv2_video_format *vidf;
+	const struct ntv2_video_format *vidf;
 	int res;
 
 	NTV2_MSG_VIDEO_STATE("%s: query_dv_timings\n",
@@ -590,7 +1011,7 @@ static int ntv2_dv_timings_cap(struct file *file,
 							   struct v4l2_dv_timings_cap *cap)
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
-	struct ntv2_input_config *config;
+	const struct ntv2_input_config *config;
 
 	NTV2_MSG_VIDEO_STATE("%s: dv_timings_cap\n",
 						 ntv2_vid->name);
@@ -602,7 +1023,7 @@ static int ntv2_dv_timings_cap(struct file *file,
 	if (config == NULL)
 		return -ENODATA;
 
-	*cap = config->v4l2_timings_cap;
+	*cap = *config->v4l2_timings_cap;
 
 	return 0;
 }
@@ -612,7 +1033,7 @@ static int ntv2_enum_input(struct file *file,
 						   struct v4l2_input *input)
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
-	struct ntv2_input_config *config;
+	const struct ntv2_input_config *config;
 //	struct ntv2_input_format format;
 
 	NTV2_MSG_VIDEO_STATE("%s: enum_input %d\n",
@@ -641,8 +1062,11 @@ static int ntv2_enum_input(struct file *file,
 static int ntv2_s_input(struct file *file, void *fh, unsigned int input)
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
-	struct ntv2_input_config *config;
-	struct ntv2_video_format *vidf;
+	const struct ntv2_input_config *config;
+	const struct ntv2_video_format *vidf;
+	struct ntv2_v4l2ops_state state;
+	struct ntv2_v4l2ops_state *busy = NULL;
+	int result;
 	int res;
 
 	NTV2_MSG_VIDEO_STATE("%s: s_input %d\n",
@@ -654,11 +1078,12 @@ static int ntv2_s_input(struct file *file, void *fh, unsigned int input)
 	if (config == NULL)
 		return -EINVAL;
 	
-	/* no input changes while streaming */
+	/* pause the queue for input changes */
 	if (vb2_is_busy(&ntv2_vid->vb2_queue)) {
-		NTV2_MSG_VIDEO_ERROR("%s: *error* input change while streaming\n",
-							 ntv2_vid->name);
-		return -EBUSY;
+		result = ntv2_v4l2ops_change_begin(ntv2_vid, &state);
+		if (result != 0)
+			return result;
+		busy = &state;
 	}
 
 	/* update input */
@@ -694,20 +1119,13 @@ static int ntv2_s_input(struct file *file, void *fh, unsigned int input)
 	/* update ntv2 video format and v4l2 timing */
 	ntv2_vid->video_format = *vidf;
 	ntv2_vid->v4l2_timings = vidf->v4l2_timings;
+	ntv2_v4l2ops_crop_bounds(ntv2_vid, &ntv2_vid->crop);
 
 	/* save the drop frame hint */
 	ntv2_vid->drop_frame = ntv2_frame_rate_drop(vidf->frame_rate);
 
 done:
-	/* update v4l2 pixel format */
-	ntv2_v4l2ops_fill_pix_format(&ntv2_vid->video_format,
-								 &ntv2_vid->pixel_format,
-								 &ntv2_vid->v4l2_format);
-
-	/* update video state */
-	ntv2_video_update(ntv2_vid);
-
-	return 0;
+	return ntv2_v4l2ops_change_commit(ntv2_vid, busy);
 }
 
 static int ntv2_g_input(struct file *file, void *fh, unsigned int *input)
@@ -722,15 +1140,57 @@ static int ntv2_g_input(struct file *file, void *fh, unsigned int *input)
 	return 0;
 }
 
+static int ntv2_enum_output(struct file *file,
+							void *fh,
+							struct v4l2_output *output)
+{
+	struct ntv2_video *ntv2_vid = video_drvdata(file);
+
+	NTV2_MSG_VIDEO_STATE("%s: enum_output %d\n",
+						 ntv2_vid->name, output->index);
+
+	/* one sdi output per channel */
+	if (output->index != 0)
+		return -EINVAL;
+
+	output->type = V4L2_OUTPUT_TYPE_ANALOG;
+	output->std = 0;
+	snprintf(output->name, sizeof(output->name), "SDI %d", ntv2_vid->index + 1);
+	output->capabilities = V4L2_OUT_CAP_DV_TIMINGS;
+
+	return 0;
+}
+
+static int ntv2_s_output(struct file *file, void *fh, unsigned int output)
+{
+	struct ntv2_video *ntv2_vid = video_drvdata(file);
+
+	NTV2_MSG_VIDEO_STATE("%s: s_output %d\n",
+						 ntv2_vid->name, output);
+
+	if (output != 0)
+		return -EINVAL;
+
+	return 0;
+}
+
+static int ntv2_g_output(struct file *file, void *fh, unsigned int *output)
+{
+	*output = 0;
+
+	return 0;
+}
+
 static int ntv2_g_parm(struct file *file, void *fh, struct v4l2_streamparm *sp)
 {
 	struct ntv2_video *ntv2_vid = video_drvdata(file);
 
-	if (sp->type != V4L2_BUF_TYPE_VIDEO_CAPTURE)
+	if (!ntv2_v4l2ops_capture_type(ntv2_vid, sp->type))
 		return -EINVAL;
 
+	sp->parm.capture.capability = V4L2_CAP_TIMEPERFRAME;
 	sp->parm.capture.timeperframe.numerator =
-		ntv2_frame_rate_duration(ntv2_vid->video_format.frame_rate);
+		ntv2_frame_rate_duration(ntv2_vid->video_format.frame_rate) * ntv2_vid->frame_interval;
 	sp->parm.capture.timeperframe.denominator = 
 		ntv2_frame_rate_scale(ntv2_vid->video_format.frame_rate);
 	sp->parm.capture.readbuffers = 8;
@@ -744,6 +1204,34 @@ static int ntv2_g_parm(struct file *file, void *fh, struct v4l2_streamparm *sp)
 	return 0;
 }
 
+static int ntv2_s_parm(struct file *file, void *fh, struct v4l2_streamparm *sp)
+{
+	struct ntv2_video *ntv2_vid = video_drvdata(file);
+	struct v4l2_fract *tpf = &sp->parm.capture.timeperframe;
+	u64 duration = ntv2_frame_rate_duration(ntv2_vid->video_format.frame_rate);
+	u64 scale = ntv2_frame_rate_scale(ntv2_vid->video_format.frame_rate);
+	u64 input_time;
+	u32 interval = 1;
+
+	if (!ntv2_v4l2ops_capture_type(ntv2_vid, sp->type))
+		return -EINVAL;
+
+	/* capture every nth input frame closest to the requested rate */
+	if ((tpf->numerator != 0) && (tpf->denominator != 0) && (duration != 0)) {
+		input_time = (u64)tpf->denominator * duration;
+		interval = (u32)div64_u64((u64)tpf->numerator * scale + input_time / 2, input_time);
+		interval = clamp_t(u32, interval, 1, NTV2_MAX_FRAME_INTERVAL);
+	}
+
+	NTV2_MSG_VIDEO_STATE("%s: s_parm  frame interval %d\n",
+						 ntv2_vid->name, interval);
+
+	ntv2_vid->frame_interval = interval;
+	ntv2_channel_set_reader_interval(ntv2_vid->vid_str, ntv2_vid->reader, interval);
+
+	return ntv2_g_parm(file, fh, sp);
+}
+
 #ifdef CONFIG_VIDEO_ADV_DEBUG
 static int ntv2_g_register (struct file *file, void *priv,
 							  struct v4l2_dbg_register *reg)
@@ -801,7 +1289,7 @@ static int ntv2_vdev_open(struct file *file)
 						 ntv2_vid->name);
 
 	/* update the input format on first open */
-	if (atomic_inc_and_test(&ntv2_vid->video_ref)) {
+	if (atomic_inc_and_test(&ntv2_vid->video_ref) && !ntv2_vid->output) {
 		ntv2_s_input(file, file->private_data, ntv2_vid->v4l2_input);
 	}
 
@@ -833,6 +1321,12 @@ static const struct v4l2_ioctl_ops ntv2_ioctl_ops = {
 	.vidioc_s_fmt_vid_cap = ntv2_s_fmt_vid_cap,
 	.vidioc_g_fmt_vid_cap = ntv2_g_fmt_vid_cap,
 	.vidioc_enum_fmt_vid_cap = ntv2_enum_fmt_vid_cap,
+	.vidioc_try_fmt_vid_cap_mplane = ntv2_try_fmt_vid_cap_mplane,
+	.vidioc_s_fmt_vid_cap_mplane = ntv2_s_fmt_vid_cap_mplane,
+	.vidioc_g_fmt_vid_cap_mplane = ntv2_g_fmt_vid_cap_mplane,
+#ifndef NTV2_USE_ENUM_FMT_MERGED
+	.vidioc_enum_fmt_vid_cap_mplane = ntv2_enum_fmt_vid_cap,
+#endif
 
 	.vidioc_g_std = ntv2_g_std,
 	.vidioc_s_std = ntv2_s_std,
@@ -843,6 +1337,9 @@ static const struct v4l2_ioctl_ops ntv2_ioctl_ops = {
 #else	
 	.vidioc_cropcap = ntv2_cropcap,
 #endif
+	.vidioc_g_selection = ntv2_g_selection,
+	.vidioc_s_selection = ntv2_s_selection,
+
 	.vidioc_s_dv_timings = ntv2_s_dv_timings,
 	.vidioc_g_dv_timings = ntv2_g_dv_timings,
 	.vidioc_enum_dv_timings = ntv2_enum_dv_timings,
@@ -854,6 +1351,51 @@ static const struct v4l2_ioctl_ops ntv2_ioctl_ops = {
 	.vidioc_s_input = ntv2_s_input,
 
 	.vidioc_g_parm = ntv2_g_parm,
+	.vidioc_s_parm = ntv2_s_parm,
+
+	.vidioc_reqbufs = vb2_ioctl_reqbufs,
+	.vidioc_create_bufs = vb2_ioctl_create_bufs,
+	.vidioc_querybuf = vb2_ioctl_querybuf,
+	.vidioc_qbuf = vb2_ioctl_qbuf,
+	.vidioc_dqbuf = vb2_ioctl_dqbuf,
+	.vidioc_expbuf = vb2_ioctl_expbuf,
+	.vidioc_streamon = vb2_ioctl_streamon,
+	.vidioc_streamoff = vb2_ioctl_streamoff,
+
+#ifdef CONFIG_VIDEO_ADV_DEBUG
+	.vidioc_g_register = ntv2_g_register,
+	.vidioc_s_register = ntv2_s_register,
+#endif
+
+	.vidioc_log_status = v4l2_ctrl_log_status,
+	.vidioc_subscribe_event = v4l2_ctrl_subscribe_event,
+	.vidioc_unsubscribe_event = v4l2_event_unsubscribe,
+};
+
+static const struct v4l2_ioctl_ops ntv2_output_ioctl_ops = {
+	.vidioc_querycap = ntv2_querycap,
+	.vidioc_try_fmt_vid_out = ntv2_try_fmt_vid_cap,
+	.vidioc_s_fmt_vid_out = ntv2_s_fmt_vid_cap,
+	.vidioc_g_fmt_vid_out = ntv2_g_fmt_vid_cap,
+	.vidioc_enum_fmt_vid_out = ntv2_enum_fmt_vid_cap,
+	.vidioc_try_fmt_vid_out_mplane = ntv2_try_fmt_vid_cap_mplane,
+	.vidioc_s_fmt_vid_out_mplane = ntv2_s_fmt_vid_cap_mplane,
+	.vidioc_g_fmt_vid_out_mplane = ntv2_g_fmt_vid_cap_mplane,
+#ifndef NTV2_USE_ENUM_FMT_MERGED
+	.vidioc_enum_fmt_vid_out_mplane = ntv2_enum_fmt_vid_cap,
+#endif
+
+	.vidioc_g_std = ntv2_g_std,
+	.vidioc_s_std = ntv2_s_std,
+
+	.vidioc_s_dv_timings = ntv2_s_dv_timings,
+	.vidioc_g_dv_timings = ntv2_g_dv_timings,
+	.vidioc_enum_dv_timings = ntv2_enum_dv_timings,
+	.vidioc_dv_timings_cap = ntv2_dv_timings_cap,
+
+	.vidioc_enum_output = ntv2_enum_output,
+	.vidioc_g_output = ntv2_g_output,
+	.vidioc_s_output = ntv2_s_output,
 
 	.vidioc_reqbufs = vb2_ioctl_reqbufs,
 	.vidioc_create_bufs = vb2_ioctl_create_bufs,
@@ -874,6 +1416,39 @@ static const struct v4l2_ioctl_ops ntv2_ioctl_ops = {
 	.vidioc_unsubscribe_event = v4l2_event_unsubscribe,
 };
 
+#ifdef NTV2_USE_META_CAPTURE
+static const struct v4l2_ioctl_ops ntv2_anc_ioctl_ops = {
+	.vidioc_querycap = ntv2_querycap,
+	.vidioc_try_fmt_meta_cap = ntv2_g_fmt_meta_cap,
+	.vidioc_s_fmt_meta_cap = ntv2_g_fmt_meta_cap,
+	.vidioc_g_fmt_meta_cap = ntv2_g_fmt_meta_cap,
+	.vidioc_enum_fmt_meta_cap = ntv2_enum_fmt_meta_cap,
+
+	.vidioc_g_dv_timings = ntv2_g_dv_timings,
+	.vidioc_query_dv_timings = ntv2_query_dv_timings,
+
+	.vidioc_enum_input = ntv2_enum_input,
+	.vidioc_g_input = ntv2_g_input,
+	.vidioc_s_input = ntv2_s_input,
+
+	.vidioc_g_parm = ntv2_g_parm,
+	.vidioc_s_parm = ntv2_s_parm,
+
+	.vidioc_reqbufs = vb2_ioctl_reqbufs,
+	.vidioc_create_bufs = vb2_ioctl_create_bufs,
+	.vidioc_querybuf = vb2_ioctl_querybuf,
+	.vidioc_qbuf = vb2_ioctl_qbuf,
+	.vidioc_dqbuf = vb2_ioctl_dqbuf,
+	.vidioc_expbuf = vb2_ioctl_expbuf,
+	.vidioc_streamon = vb2_ioctl_streamon,
+	.vidioc_streamoff = vb2_ioctl_streamoff,
+
+	.vidioc_log_status = v4l2_ctrl_log_status,
+	.vidioc_subscribe_event = v4l2_ctrl_subscribe_event,
+	.vidioc_unsubscribe_event = v4l2_event_unsubscribe,
+};
+#endif
+
 static const struct v4l2_file_operations ntv2_fops = {
 	.owner = THIS_MODULE,
 	.open = ntv2_vdev_open,
@@ -884,6 +1459,16 @@ static const struct v4l2_file_operations ntv2_fops = {
 	.poll = vb2_fop_poll,
 };
 
+static const struct v4l2_file_operations ntv2_output_fops = {
+	.owner = THIS_MODULE,
+	.open = ntv2_vdev_open,
+	.release = ntv2_vdev_release,
+	.unlocked_ioctl = video_ioctl2,
+	.write = vb2_fop_write,
+	.mmap = vb2_fop_mmap,
+	.poll = vb2_fop_poll,
+};
+
 int ntv2_v4l2ops_configure(struct ntv2_video *ntv2_vid)
 {
 	struct video_device *video_dev;
@@ -914,8 +1499,19 @@ int ntv2_v4l2ops_configure(struct ntv2_video *ntv2_vid)
 
 	/* assign video ops */
 	video_dev = &ntv2_vid->video_dev;
-	video_dev->fops = &ntv2_fops;
-	video_dev->ioctl_ops = &ntv2_ioctl_ops;
+#ifdef NTV2_USE_META_CAPTURE
+	if (ntv2_vid->anc) {
+		video_dev->fops = &ntv2_fops;
+		video_dev->ioctl_ops = &ntv2_anc_ioctl_ops;
+	} else
+#endif
+	if (ntv2_vid->output) {
+		video_dev->fops = &ntv2_output_fops;
+		video_dev->ioctl_ops = &ntv2_output_ioctl_ops;
+	} else {
+		video_dev->fops = &ntv2_fops;
+		video_dev->ioctl_ops = &ntv2_ioctl_ops;
+	}
 
 	/* no analog standards */
 	video_dev->tvnorms = 0;
@@ -924,9 +1520,8 @@ int ntv2_v4l2ops_configure(struct ntv2_video *ntv2_vid)
 
 	/* fill in the initial format/timing */
 	ntv2_vid->v4l2_timings = ntv2_vid->video_format.v4l2_timings;
-	ntv2_v4l2ops_fill_pix_format(&ntv2_vid->video_format,
-								 &ntv2_vid->pixel_format,
-								 &ntv2_vid->v4l2_format);
+	ntv2_v4l2ops_crop_bounds(ntv2_vid, &ntv2_vid->crop);
+	ntv2_v4l2ops_update_format(ntv2_vid);
 
 	return 0;
 }
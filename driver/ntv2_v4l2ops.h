@@ -23,5 +23,6 @@
 #include "ntv2_common.h"
 
 int ntv2_v4l2ops_configure(struct ntv2_video *ntv2_vid);
+u32 ntv2_v4l2ops_device_caps(struct ntv2_video *ntv2_vid);
 
 #endif
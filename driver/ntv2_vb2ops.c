@@ -20,6 +20,7 @@
 #include "ntv2_video.h"
 #include "ntv2_vb2ops.h"
 #include "ntv2_v4l2ops.h"
+#include "ntv2_channel.h"
 #include <linux/version.h>
 #ifdef NTV2_USE_VB2_DMA_SG
 #include <media/videobuf2-dma-sg.h>
@@ -35,6 +36,47 @@
 	container_of(vb, struct ntv2_vb2buf, vb2_buffer)
 #endif
 
+static u32 ntv2_vb2ops_num_planes(struct ntv2_video *ntv2_vid)
+{
+	if (ntv2_vid->mplane)
+		return ntv2_vid->v4l2_format_mp.num_planes;
+
+	return 1;
+}
+
+static u32 ntv2_vb2ops_plane_size(struct ntv2_video *ntv2_vid, u32 plane)
+{
+	if (ntv2_vid->anc)
+		return 2 * NTV2_ANC_FIELD_SIZE;
+	if (ntv2_vid->mplane)
+		return ntv2_vid->v4l2_format_mp.plane_fmt[plane].sizeimage;
+
+	return ntv2_vid->v4l2_format.sizeimage;
+}
+
+static enum dma_data_direction ntv2_vb2ops_dma_dir(struct ntv2_video *ntv2_vid)
+{
+	return ntv2_vid->output? DMA_TO_DEVICE : DMA_FROM_DEVICE;
+}
+
+static void ntv2_vb2ops_record_sizes(struct ntv2_video *ntv2_vid,
+									 struct vb2_queue *vq,
+									 u32 num_planes,
+									 unsigned int sizes[])
+{
+	int i;
+
+	/* track the smallest buffer for format changes */
+	if (vq->num_buffers == 0) {
+		ntv2_vid->vb2_num_planes = num_planes;
+		for (i = 0; i < num_planes; i++)
+			ntv2_vid->vb2_plane_size[i] = sizes[i];
+	} else {
+		for (i = 0; i < num_planes; i++)
+			ntv2_vid->vb2_plane_size[i] = min_t(u32, ntv2_vid->vb2_plane_size[i], sizes[i]);
+	}
+}
+
 /*
  * Setup the constraints of the queue
  */
@@ -67,6 +109,11 @@ static int ntv2_queue_setup(struct vb2_queue *vq, const struct v4l2_format *fmt,
 #endif
 #endif
 	unsigned long flags;
+	u32 num_planes;
+#ifndef NTV2_USE_QUEUE_SETUP_NO_FORMAT
+	u32 size;
+#endif
+	int i;
 
 	if (ntv2_vid == NULL)
 		return -EPERM;
@@ -77,28 +124,49 @@ static int ntv2_queue_setup(struct vb2_queue *vq, const struct v4l2_format *fmt,
 	if (vq->num_buffers + *nbuffers < 3)
 		*nbuffers = 3 - vq->num_buffers;
 
+	num_planes = ntv2_vb2ops_num_planes(ntv2_vid);
+
 #ifdef NTV2_USE_QUEUE_SETUP_NO_FORMAT
 	/* check image size */
-	if (*nplanes)
-		return sizes[0] < ntv2_vid->v4l2_format.sizeimage ? -EINVAL : 0;
+	if (*nplanes) {
+		if (*nplanes != num_planes)
+			return -EINVAL;
+		for (i = 0; i < num_planes; i++) {
+			if (sizes[i] < ntv2_vb2ops_plane_size(ntv2_vid, i))
+				return -EINVAL;
+		}
+		ntv2_vb2ops_record_sizes(ntv2_vid, vq, num_planes, sizes);
+		return 0;
+	}
 
 	/* configure returned parameters */
-	*nplanes = 1;
-	sizes[0] = ntv2_vid->v4l2_format.sizeimage;
+	*nplanes = num_planes;
+	for (i = 0; i < num_planes; i++)
+		sizes[i] = ntv2_vb2ops_plane_size(ntv2_vid, i);
 #else
-	/* check image size */
-	if (fmt && fmt->fmt.pix.sizeimage < ntv2_vid->v4l2_format.sizeimage) {
-		NTV2_MSG_VIDEO_ERROR("%s: *error* vb2 queue setup format image size too small (%d < %d)\n",
-							 ntv2_vid->name,
-							 (int)fmt->fmt.pix.sizeimage,
-							 (int)ntv2_vid->v4l2_format.sizeimage);
-		return -EINVAL;
+	for (i = 0; i < num_planes; i++) {
+		size = ntv2_vb2ops_plane_size(ntv2_vid, i);
+		if (fmt != NULL) {
+			if (ntv2_vid->mplane)
+				size = fmt->fmt.pix_mp.plane_fmt[i].sizeimage;
+			else
+				size = fmt->fmt.pix.sizeimage;
+		}
+
+		/* check image size */
+		if (size < ntv2_vb2ops_plane_size(ntv2_vid, i)) {
+			NTV2_MSG_VIDEO_ERROR("%s: *error* vb2 queue setup format plane %d size too small (%d < %d)\n",
+								 ntv2_vid->name, i, (int)size,
+								 (int)ntv2_vb2ops_plane_size(ntv2_vid, i));
+			return -EINVAL;
+		}
+
+		/* configure returned parameters */
+		sizes[i] = size;
 	}
-
-	/* configure returned parameters */
-	*nplanes = 1;
-	sizes[0] = fmt ? fmt->fmt.pix.sizeimage : ntv2_vid->v4l2_format.sizeimage;
+	*nplanes = num_planes;
 #endif
+	ntv2_vb2ops_record_sizes(ntv2_vid, vq, num_planes, sizes);
 
 	/* reset the queue */
 	spin_lock_irqsave(&ntv2_vid->vb2_lock, flags);
@@ -118,6 +186,7 @@ static int ntv2_vb2buf_init(struct vb2_buffer *vb)
 	struct ntv2_video *ntv2_vid = vb2_get_drv_priv(vb->vb2_queue);
 	struct ntv2_vb2buf *ntv2_buf = to_ntv2_vb2buf(vb);
 	unsigned long flags;
+	int i;
 
 	NTV2_MSG_VIDEO_STREAM("%s: vb2 buffer init %d\n",
 						  ntv2_vid->name, ntv2_vid->vb2buf_index);
@@ -126,47 +195,37 @@ static int ntv2_vb2buf_init(struct vb2_buffer *vb)
 	ntv2_buf->index = ntv2_vid->vb2buf_index++;
 	spin_unlock_irqrestore(&ntv2_vid->vb2_lock, flags);
 	ntv2_buf->ntv2_vid = ntv2_vid;
-	ntv2_buf->num_pages = 0;
-	ntv2_buf->sgtable = NULL;
+	ntv2_buf->num_planes = 0;
+	for (i = 0; i < NTV2_MAX_PLANES; i++) {
+		ntv2_buf->num_pages[i] = 0;
+		ntv2_buf->sgtable[i] = NULL;
+	}
 	ntv2_buf->init = true;
 
 	return 0;
 }
 
 /*
- * Allocate buffer resources and prepare for queue
+ * Map a buffer plane for dma
  */
-static int ntv2_vb2buf_prepare(struct vb2_buffer *vb)
+static int ntv2_vb2buf_map_plane(struct ntv2_video *ntv2_vid,
+								 struct ntv2_vb2buf *ntv2_buf,
+								 struct vb2_buffer *vb,
+								 int plane,
+								 unsigned long size)
 {
-	struct ntv2_video *ntv2_vid = vb2_get_drv_priv(vb->vb2_queue);
-	struct ntv2_vb2buf *ntv2_buf = to_ntv2_vb2buf(vb);
 	struct sg_table *sgtable;
-	unsigned long size = ntv2_vid->v4l2_format.sizeimage;
+#ifndef NTV2_USE_VB2_DMA_SG
 	int ret;
-
-	NTV2_MSG_VIDEO_STREAM("%s: vb2 buffer prepare %d\n",
-						  ntv2_vid->name, ntv2_buf->index);
-
-	/* check the buffer size */
-	if (vb2_plane_size(vb, 0) < size) {
-		NTV2_MSG_VIDEO_ERROR("%s: *error* vb2 prepare buffer too small (%d < %d)\n",
-							 ntv2_vid->name, (int)vb2_plane_size(vb, 0), (int)size);
-		return -EINVAL;
-	}
-
-	vb2_set_plane_payload(vb, 0, size);
+#endif
 
 #ifdef NTV2_USE_VB2_DMA_SG
-	sgtable = vb2_dma_sg_plane_desc(&ntv2_buf->vb2_buffer, 0);
-#else
-#ifdef NTV2_USE_VB2_V4L2_BUFFER
-	ret = ntv2_alloc_scatterlist(&ntv2_buf->vmalloc_table, vb2_plane_vaddr(&ntv2_buf->vb2_v4l2_buffer.vb2_buf, 0), size);
+	sgtable = vb2_dma_sg_plane_desc(vb, plane);
 #else
-	ret = ntv2_alloc_scatterlist(&ntv2_buf->vmalloc_table, vb2_plane_vaddr(&ntv2_buf->vb2_buffer, 0), size);
-#endif
+	ret = ntv2_alloc_scatterlist(&ntv2_buf->vmalloc_table[plane], vb2_plane_vaddr(vb, plane), size);
 	if (ret < 0)
 		return -EINVAL;
-	sgtable = &ntv2_buf->vmalloc_table;
+	sgtable = &ntv2_buf->vmalloc_table[plane];
 #endif
 
 	/* check scatter data */
@@ -177,18 +236,92 @@ static int ntv2_vb2buf_prepare(struct vb2_buffer *vb)
 	}
 
 	/* map pages */
-	ntv2_buf->num_pages = dma_map_sg(&ntv2_vid->ntv2_dev->pci_dev->dev,
-									 sgtable->sgl,
-									 sgtable->nents,
-									 DMA_FROM_DEVICE);
-	if (ntv2_buf->num_pages == 0) {
+	ntv2_buf->num_pages[plane] = dma_map_sg(&ntv2_vid->ntv2_dev->pci_dev->dev,
+											sgtable->sgl,
+											sgtable->nents,
+											ntv2_vb2ops_dma_dir(ntv2_vid));
+	if (ntv2_buf->num_pages[plane] == 0) {
 		NTV2_MSG_VIDEO_ERROR("%s: *error* map sg failed\n", ntv2_vid->name);
 #ifndef NTV2_USE_VB2_DMA_SG
-		ntv2_free_scatterlist(&ntv2_buf->vmalloc_table);
+		ntv2_free_scatterlist(&ntv2_buf->vmalloc_table[plane]);
 #endif
 		return -EINVAL;
 	}
-	ntv2_buf->sgtable = sgtable;
+	ntv2_buf->sgtable[plane] = sgtable;
+
+	return 0;
+}
+
+/*
+ * Unmap a buffer plane
+ */
+static void ntv2_vb2buf_unmap_plane(struct ntv2_video *ntv2_vid,
+									struct ntv2_vb2buf *ntv2_buf,
+									int plane)
+{
+	struct sg_table *sgtable = ntv2_buf->sgtable[plane];
+
+	/* check scatter data */
+	if ((sgtable == NULL) ||
+		(sgtable->sgl == NULL) ||
+		(sgtable->nents == 0) ||
+		(ntv2_buf->num_pages[plane] == 0)) {
+		NTV2_MSG_VIDEO_ERROR("%s: *error* vb2 finish no scatter list\n", ntv2_vid->name);
+		return;
+	}
+
+	/* unmap the pages */
+	dma_unmap_sg(&ntv2_vid->ntv2_dev->pci_dev->dev,
+				 sgtable->sgl,
+				 sgtable->nents,
+				 ntv2_vb2ops_dma_dir(ntv2_vid));
+
+	ntv2_buf->num_pages[plane] = 0;
+#ifndef NTV2_USE_VB2_DMA_SG
+	ntv2_free_scatterlist(&ntv2_buf->vmalloc_table[plane]);
+#endif
+	ntv2_buf->sgtable[plane] = NULL;
+}
+
+/*
+ * Allocate buffer resources and prepare for queue
+ */
+static int ntv2_vb2buf_prepare(struct vb2_buffer *vb)
+{
+	struct ntv2_video *ntv2_vid = vb2_get_drv_priv(vb->vb2_queue);
+	struct ntv2_vb2buf *ntv2_buf = to_ntv2_vb2buf(vb);
+	u32 num_planes = ntv2_vb2ops_num_planes(ntv2_vid);
+	unsigned long size;
+	int ret;
+	int i;
+
+	NTV2_MSG_VIDEO_STREAM("%s: vb2 buffer prepare %d\n",
+						  ntv2_vid->name, ntv2_buf->index);
+
+	/* check the plane sizes */
+	for (i = 0; i < num_planes; i++) {
+		size = ntv2_vb2ops_plane_size(ntv2_vid, i);
+		if (vb2_plane_size(vb, i) < size) {
+			NTV2_MSG_VIDEO_ERROR("%s: *error* vb2 prepare plane %d too small (%d < %d)\n",
+								 ntv2_vid->name, i, (int)vb2_plane_size(vb, i), (int)size);
+			return -EINVAL;
+		}
+		/* output payload is set by the application */
+		if (!ntv2_vid->output)
+			vb2_set_plane_payload(vb, i, size);
+	}
+
+	/* map each whole plane so the buffer can take a larger format */
+	for (i = 0; i < num_planes; i++) {
+		ret = ntv2_vb2buf_map_plane(ntv2_vid, ntv2_buf, vb, i,
+									vb2_plane_size(vb, i));
+		if (ret < 0) {
+			while (--i >= 0)
+				ntv2_vb2buf_unmap_plane(ntv2_vid, ntv2_buf, i);
+			return ret;
+		}
+	}
+	ntv2_buf->num_planes = num_planes;
 
 	return 0;
 }
@@ -224,32 +357,15 @@ static int ntv2_vb2buf_finish(struct vb2_buffer *vb)
 {
 	struct ntv2_video *ntv2_vid = vb2_get_drv_priv(vb->vb2_queue);
 	struct ntv2_vb2buf *ntv2_buf = to_ntv2_vb2buf(vb);
-	struct sg_table *sgtable = ntv2_buf->sgtable;
+	int i;
 
 	NTV2_MSG_VIDEO_STREAM("%s: vb2 buffer finish %d\n",
 						  ntv2_vid->name, ntv2_buf->index);
 
-	/* check scatter data */
-	if ((sgtable->sgl == NULL) ||
-		(sgtable->nents == 0) ||
-		(ntv2_buf->num_pages == 0)) {
-		NTV2_MSG_VIDEO_ERROR("%s: *error* vb2 finish no scatter list\n", ntv2_vid->name);
-		goto done;
-	}
+	for (i = 0; i < ntv2_buf->num_planes; i++)
+		ntv2_vb2buf_unmap_plane(ntv2_vid, ntv2_buf, i);
+	ntv2_buf->num_planes = 0;
 
-	/* unmap the pages */
-	dma_unmap_sg(&ntv2_vid->ntv2_dev->pci_dev->dev,
-				 sgtable->sgl,
-				 sgtable->nents,
-				 DMA_FROM_DEVICE);
-
-	ntv2_buf->num_pages = 0;
-#ifndef NTV2_USE_VB2_DMA_SG
-	ntv2_free_scatterlist(&ntv2_buf->vmalloc_table);
-#endif
-	ntv2_buf->sgtable = NULL;
-
-done:
 #ifdef NTV2_USE_VB2_VOID_FINISH
 	return;
 #else
@@ -390,8 +506,28 @@ int ntv2_vb2ops_configure(struct ntv2_video *ntv2_vid)
 
 	/* configure the vb2 queue */
 	que = &ntv2_vid->vb2_queue;
-	que->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-	que->io_modes = VB2_MMAP | VB2_USERPTR | VB2_READ;
+#ifdef NTV2_USE_META_CAPTURE
+	if (ntv2_vid->anc) {
+		que->type = V4L2_BUF_TYPE_META_CAPTURE;
+		que->io_modes = VB2_MMAP | VB2_USERPTR;
+	} else
+#endif
+	if (ntv2_vid->output) {
+		if (ntv2_vid->mplane) {
+			que->type = V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE;
+			que->io_modes = VB2_MMAP | VB2_USERPTR;
+		} else {
+			que->type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+			que->io_modes = VB2_MMAP | VB2_USERPTR | VB2_WRITE;
+		}
+	} else if (ntv2_vid->mplane) {
+		/* read() does not support multiple planes */
+		que->type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+		que->io_modes = VB2_MMAP | VB2_USERPTR;
+	} else {
+		que->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		que->io_modes = VB2_MMAP | VB2_USERPTR | VB2_READ;
+	}
 	que->drv_priv = ntv2_vid;
 	que->buf_struct_size = sizeof(struct ntv2_vb2buf);
 	que->ops = &ntv2_vb2ops;
@@ -401,7 +537,11 @@ int ntv2_vb2ops_configure(struct ntv2_video *ntv2_vid)
 	que->mem_ops = &vb2_vmalloc_memops;
 #endif
 #ifdef NTV2_USE_VB2_TIMESTAMP_FLAGS
-	que->timestamp_flags = V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC;
+	/* tai has no v4l2 timestamp type */
+	if (ntv2_module_info()->video_tai)
+		que->timestamp_flags = V4L2_BUF_FLAG_TIMESTAMP_UNKNOWN;
+	else
+		que->timestamp_flags = V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC;
 	#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 6, 0)
 	que->min_buffers_needed = 2;
 	#endif
@@ -448,7 +588,9 @@ void ntv2_vb2ops_vb2buf_done(struct ntv2_vb2buf *ntv2_buf)
 {
 	struct ntv2_video *ntv2_vid;
 	struct v4l2_timecode *timecode;
+	struct vb2_buffer *vb;
 	unsigned long flags;
+	int i;
 
 	if (ntv2_buf == NULL)
 		return;
@@ -488,12 +630,36 @@ void ntv2_vb2ops_vb2buf_done(struct ntv2_vb2buf *ntv2_buf)
 
 		/* mark as done */
 #ifdef NTV2_USE_VB2_V4L2_BUFFER
-		vb2_set_plane_payload(&ntv2_buf->vb2_v4l2_buffer.vb2_buf, 0, ntv2_vid->v4l2_format.sizeimage);
-		vb2_buffer_done(&ntv2_buf->vb2_v4l2_buffer.vb2_buf, VB2_BUF_STATE_DONE);
+		vb = &ntv2_buf->vb2_v4l2_buffer.vb2_buf;
 #else
-		vb2_set_plane_payload(&ntv2_buf->vb2_buffer, 0, ntv2_vid->v4l2_format.sizeimage);
-		vb2_buffer_done(&ntv2_buf->vb2_buffer, VB2_BUF_STATE_DONE);
+		vb = &ntv2_buf->vb2_buffer;
 #endif
+		if (!ntv2_vid->output && !ntv2_vid->anc) {
+			for (i = 0; i < ntv2_vb2ops_num_planes(ntv2_vid); i++)
+				vb2_set_plane_payload(vb, i, ntv2_vb2ops_plane_size(ntv2_vid, i));
+		}
+		vb2_buffer_done(vb, VB2_BUF_STATE_DONE);
 	}
 	spin_unlock_irqrestore(&ntv2_vid->vb2_lock, flags);
 }
+
+bool ntv2_vb2ops_format_fits(struct ntv2_video *ntv2_vid)
+{
+	u32 num_planes;
+	int i;
+
+	if (ntv2_vid == NULL)
+		return false;
+
+	/* the current format must fit every allocated buffer */
+	num_planes = ntv2_vb2ops_num_planes(ntv2_vid);
+	if (num_planes != ntv2_vid->vb2_num_planes)
+		return false;
+
+	for (i = 0; i < num_planes; i++) {
+		if (ntv2_vb2ops_plane_size(ntv2_vid, i) > ntv2_vid->vb2_plane_size[i])
+			return false;
+	}
+
+	return true;
+}
@@ -27,4 +27,6 @@ int ntv2_vb2ops_configure(struct ntv2_video *ntv2_vid);
 struct ntv2_vb2buf *ntv2_vb2ops_vb2buf_ready(struct ntv2_video *ntv2_vid);
 void ntv2_vb2ops_vb2buf_done(struct ntv2_vb2buf *ntv2_buf);
 
+bool ntv2_vb2ops_format_fits(struct ntv2_video *ntv2_vid);
+
 #endif
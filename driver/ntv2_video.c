@@ -26,6 +26,7 @@
 #include "ntv2_input.h"
 #include "ntv2_konareg.h"
 #include "ntv2_timecode.h"
+#include "ntv2_trace.h"
 
 
 #define NTV2_VIDEO_TRANSFER_TIMEOUT		(100000)
@@ -33,6 +34,11 @@
 static bool ntv2_video_compare_input_format(struct ntv2_input_format *format_a,
 											struct ntv2_input_format *format_b);
 static void ntv2_video_transfer_task(unsigned long data);
+static void ntv2_video_plane_transfer(struct ntv2_video *ntv2_vid,
+									  int plane,
+									  struct ntv2_transfer *trn);
+static void ntv2_video_anc_transfer(struct ntv2_video *ntv2_vid,
+									struct ntv2_transfer *trn);
 static void ntv2_video_dma_callback(unsigned long data, int result);
 static void ntv2_video_channel_callback(unsigned long data);
 static void ntv2_video_stream_to_buffer(struct ntv2_video *ntv2_vid,
@@ -40,21 +46,29 @@ static void ntv2_video_stream_to_buffer(struct ntv2_video *ntv2_vid,
 										struct ntv2_vb2buf *buffer);
 
 struct ntv2_video *ntv2_video_open(struct ntv2_object *ntv2_obj,
-								   const char *name, int index)
+								   const char *name, int index, int reader,
+								   enum ntv2_video_type type)
 {
 	struct ntv2_video *ntv2_vid = NULL;
 
 	if (ntv2_obj == NULL)
 		return NULL;
 
-	ntv2_vid = kzalloc(sizeof(struct ntv2_video), GFP_KERNEL);
+	ntv2_vid = kzalloc_node(sizeof(struct ntv2_video), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_vid == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_video instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
 	}
 
 	ntv2_vid->index = index;
-	snprintf(ntv2_vid->name, NTV2_STRING_SIZE, "%s-%s%d", ntv2_obj->name, name, index);
+	ntv2_vid->reader = reader;
+	ntv2_vid->output = (type == ntv2_video_type_output);
+	ntv2_vid->anc = (type == ntv2_video_type_anc);
+	if (reader == 0)
+		snprintf(ntv2_vid->name, NTV2_STRING_SIZE, "%s-%s%d", ntv2_obj->name, name, index);
+	else
+		snprintf(ntv2_vid->name, NTV2_STRING_SIZE, "%s-%s%d.%d", ntv2_obj->name, name, index, reader);
 	INIT_LIST_HEAD(&ntv2_vid->list);
 	ntv2_vid->ntv2_dev = ntv2_obj->ntv2_dev;
 
@@ -110,6 +124,10 @@ void ntv2_video_close(struct ntv2_video *ntv2_vid)
 		ntv2_vid->vb2_init = false;
 	}
 
+#ifdef NTV2_USE_FRAME_TRACE
+	ntv2_trace_close(ntv2_vid->ntv2_trc);
+#endif
+
 	memset(ntv2_vid, 0, sizeof(struct ntv2_video));
 	kfree(ntv2_vid);
 }
@@ -137,8 +155,13 @@ int ntv2_video_configure(struct ntv2_video *ntv2_vid,
 	ntv2_vid->ntv2_inp = ntv2_inp;
 	ntv2_vid->ntv2_pci = ntv2_pci;
 
-	ntv2_vid->vid_str = ntv2_channel_stream(ntv2_chn, ntv2_stream_type_vidin);
+	if (ntv2_vid->output)
+		ntv2_vid->vid_str = ntv2_channel_stream(ntv2_chn, ntv2_stream_type_vidout);
+	else
+		ntv2_vid->vid_str = ntv2_channel_stream(ntv2_chn, ntv2_stream_type_vidin);
 	ntv2_vid->aud_str = ntv2_channel_stream(ntv2_chn, ntv2_stream_type_audin);
+	/* metadata buffers have a single plane */
+	ntv2_vid->mplane = ntv2_module_info()->video_mplane && !ntv2_vid->anc;
 
 	/* initialize state */
 	ntv2_vid->video_format = *ntv2_features_get_default_video_format(features, ntv2_chn->index);
@@ -148,6 +171,7 @@ int ntv2_video_configure(struct ntv2_video *ntv2_vid,
 								   &ntv2_vid->pixel_format,
 								   &ntv2_vid->input_format);
 	ntv2_vid->drop_frame = ntv2_frame_rate_drop(ntv2_vid->video_format.frame_rate);
+	ntv2_vid->frame_interval = 1;
 	
 	/* register the v4l2 device */
 	result = v4l2_device_register(&ntv2_vid->ntv2_dev->pci_dev->dev, &ntv2_vid->v4l2_dev);
@@ -171,6 +195,21 @@ int ntv2_video_configure(struct ntv2_video *ntv2_vid,
 	if (result != 0) 
 		return result;
 
+#ifdef NTV2_USE_FRAME_TRACE
+	/* capture latency trace */
+	if (!ntv2_vid->output) {
+		ntv2_vid->ntv2_trc = ntv2_trace_open((struct ntv2_object*)ntv2_vid->ntv2_dev,
+											 "trc", ntv2_vid->index);
+		if (ntv2_vid->ntv2_trc == NULL)
+			return -ENOMEM;
+		result = ntv2_trace_configure(ntv2_vid->ntv2_trc,
+									  ntv2_module_info()->debugfs_root,
+									  ntv2_vid->name);
+		if (result != 0)
+			return result;
+	}
+#endif
+
 	/* initialize the video_device */
 	video_dev = &ntv2_vid->video_dev;
 	strscpy(video_dev->name, NTV2_MODULE_NAME, sizeof(video_dev->name));
@@ -183,10 +222,11 @@ int ntv2_video_configure(struct ntv2_video *ntv2_vid,
 	/* null release function for now */
 	video_dev->release = video_device_release_empty;
 #ifdef NTV2_VIDEO_DEVICE_CAPABILITES	
-	video_dev->device_caps = V4L2_CAP_VIDEO_CAPTURE |
-		V4L2_CAP_READWRITE |
-		V4L2_CAP_STREAMING;
+	video_dev->device_caps = ntv2_v4l2ops_device_caps(ntv2_vid);
 #endif
+	/* output devices transmit */
+	if (ntv2_vid->output)
+		video_dev->vfl_dir = VFL_DIR_TX;
 	/* assign queue and v4l2 device */
 	video_dev->queue = &ntv2_vid->vb2_queue;
 	video_dev->v4l2_dev = &ntv2_vid->v4l2_dev;
@@ -223,13 +263,22 @@ void ntv2_video_update(struct ntv2_video *ntv2_vid)
 {
 	if (ntv2_vid == NULL)
 		return;
+
+	/* output streams have a single writer */
+	if (ntv2_vid->output) {
+		ntv2_channel_set_input_format(ntv2_vid->vid_str,
+									  &ntv2_vid->input_format);
+		ntv2_channel_set_video_format(ntv2_vid->vid_str,
+									  &ntv2_vid->video_format);
+		ntv2_channel_set_pixel_format(ntv2_vid->vid_str,
+									  &ntv2_vid->pixel_format);
+		return;
+	}
 	
-	ntv2_channel_set_input_format(ntv2_vid->vid_str,
-								  &ntv2_vid->input_format);
-	ntv2_channel_set_video_format(ntv2_vid->vid_str,
-								  &ntv2_vid->video_format);
-	ntv2_channel_set_pixel_format(ntv2_vid->vid_str,
-								  &ntv2_vid->pixel_format);
+	/* the first reader sets the channel format when it is enabled */
+	ntv2_channel_set_reader_interval(ntv2_vid->vid_str,
+									 ntv2_vid->reader,
+									 ntv2_vid->frame_interval);
 }
 
 int ntv2_video_enable(struct ntv2_video *ntv2_vid)
@@ -254,20 +303,31 @@ int ntv2_video_enable(struct ntv2_video *ntv2_vid)
 	ntv2_vid->dma_done = false;
 	ntv2_vid->dma_result = 0;
 	ntv2_vid->input_changed = false;
+	ntv2_vid->transfer_pause = false;
 	ntv2_vid->transfer_state = ntv2_task_state_enable;
 	spin_unlock_irqrestore(&ntv2_vid->state_lock, flags);
 
-	ntv2_channel_set_input_format(ntv2_vid->vid_str,
-								  &ntv2_vid->input_format);
-	ntv2_channel_set_video_format(ntv2_vid->vid_str,
-								  &ntv2_vid->video_format);
-	ntv2_channel_set_pixel_format(ntv2_vid->vid_str,
-								  &ntv2_vid->pixel_format);
-	ntv2_channel_set_frame_callback(ntv2_vid->vid_str,
-									ntv2_video_channel_callback,
-									(unsigned long)ntv2_vid);
-
-	result = ntv2_channel_enable(ntv2_vid->vid_str);
+	ntv2_video_update(ntv2_vid);
+	if (ntv2_vid->output) {
+		ntv2_channel_set_frame_callback(ntv2_vid->vid_str,
+										ntv2_video_channel_callback,
+										(unsigned long)ntv2_vid);
+		result = ntv2_channel_enable(ntv2_vid->vid_str);
+	} else {
+		ntv2_channel_set_reader_callback(ntv2_vid->vid_str,
+										 ntv2_vid->reader,
+										 ntv2_video_channel_callback,
+										 (unsigned long)ntv2_vid);
+		/* readers share the channel format, ancillary data takes any */
+		if (ntv2_vid->anc)
+			result = ntv2_channel_enable_reader(ntv2_vid->vid_str, ntv2_vid->reader,
+												NULL, NULL, NULL);
+		else
+			result = ntv2_channel_enable_reader(ntv2_vid->vid_str, ntv2_vid->reader,
+												&ntv2_vid->input_format,
+												&ntv2_vid->video_format,
+												&ntv2_vid->pixel_format);
+	}
 	if (result != 0) {
 		spin_lock_irqsave(&ntv2_vid->state_lock, flags);
 		ntv2_vid->transfer_state = ntv2_task_state_disable;
@@ -275,6 +335,12 @@ int ntv2_video_enable(struct ntv2_video *ntv2_vid)
 		return result;
 	}
 
+	/* the ancillary node follows the channel video format */
+	if (ntv2_vid->anc) {
+		ntv2_channel_get_input_format(ntv2_vid->vid_str, &ntv2_vid->input_format);
+		ntv2_channel_get_video_format(ntv2_vid->vid_str, &ntv2_vid->video_format);
+	}
+
 	/* schedule the transfer task */
 	tasklet_schedule(&ntv2_vid->transfer_task);
 
@@ -294,8 +360,12 @@ int ntv2_video_disable(struct ntv2_video *ntv2_vid)
 
 	NTV2_MSG_VIDEO_STATE("%s: video transfer task disable\n", ntv2_vid->name);
 
-	ntv2_channel_set_frame_callback(ntv2_vid->vid_str,
-									NULL, 0);
+	if (ntv2_vid->output)
+		ntv2_channel_set_frame_callback(ntv2_vid->vid_str, NULL, 0);
+	else
+		ntv2_channel_set_reader_callback(ntv2_vid->vid_str,
+										 ntv2_vid->reader,
+										 NULL, 0);
 
 	spin_lock_irqsave(&ntv2_vid->state_lock, flags);
 	ntv2_vid->transfer_state = ntv2_task_state_disable;
@@ -314,8 +384,10 @@ int ntv2_video_disable(struct ntv2_video *ntv2_vid)
 		return result;
 	}
 
-	ntv2_channel_flush(ntv2_vid->vid_str);
-	ntv2_channel_disable(ntv2_vid->vid_str);
+	if (ntv2_vid->output)
+		ntv2_channel_disable(ntv2_vid->vid_str);
+	else
+		ntv2_channel_disable_reader(ntv2_vid->vid_str, ntv2_vid->reader);
 
 	return 0;
 }
@@ -327,7 +399,10 @@ int ntv2_video_start(struct ntv2_video *ntv2_vid)
 	if ((ntv2_vid == NULL) || (ntv2_vid->ntv2_chn == NULL))
 		return -EPERM;
 	
-	result = ntv2_channel_start(ntv2_vid->vid_str);
+	if (ntv2_vid->output)
+		result = ntv2_channel_start(ntv2_vid->vid_str);
+	else
+		result = ntv2_channel_start_reader(ntv2_vid->vid_str, ntv2_vid->reader);
 	if (result != 0) {
 		return result;
 	}
@@ -342,7 +417,10 @@ int ntv2_video_stop(struct ntv2_video *ntv2_vid)
 	if ((ntv2_vid == NULL) || (ntv2_vid->ntv2_chn == NULL))
 		return -EPERM;
 	
-	result = ntv2_channel_stop(ntv2_vid->vid_str);
+	if (ntv2_vid->output)
+		result = ntv2_channel_stop(ntv2_vid->vid_str);
+	else
+		result = ntv2_channel_stop_reader(ntv2_vid->vid_str, ntv2_vid->reader);
 	if (result != 0) {
 		return result;
 	}
@@ -357,14 +435,104 @@ int ntv2_video_flush(struct ntv2_video *ntv2_vid)
 	if ((ntv2_vid == NULL) || (ntv2_vid->ntv2_chn == NULL))
 		return -EPERM;
 	
-	result = ntv2_channel_flush(ntv2_vid->vid_str);
+	if (ntv2_vid->output)
+		result = ntv2_channel_flush(ntv2_vid->vid_str);
+	else
+		result = ntv2_channel_flush_reader(ntv2_vid->vid_str, ntv2_vid->reader);
+	if (result != 0) {
+		return result;
+	}
+
+	return 0;
+}
+
+int ntv2_video_pause(struct ntv2_video *ntv2_vid)
+{
+	unsigned long flags;
+	int result;
+
+	if ((ntv2_vid == NULL) || (ntv2_vid->ntv2_chn == NULL))
+		return -EPERM;
+
+	/* only a running transfer task can be paused */
+	if (ntv2_vid->transfer_state != ntv2_task_state_enable)
+		return -EBUSY;
+
+	NTV2_MSG_VIDEO_STATE("%s: video transfer task pause\n", ntv2_vid->name);
+
+	spin_lock_irqsave(&ntv2_vid->state_lock, flags);
+	ntv2_vid->transfer_pause = true;
+	spin_unlock_irqrestore(&ntv2_vid->state_lock, flags);
+
+	/* schedule the transfer task */
+	tasklet_schedule(&ntv2_vid->transfer_task);
+
+	/* wait for the current dma to complete */
+	result = ntv2_wait((int*)&ntv2_vid->task_state,
+					   (int)ntv2_task_state_disable,
+					   NTV2_VIDEO_TRANSFER_TIMEOUT);
 	if (result != 0) {
+		NTV2_MSG_VIDEO_ERROR("%s: *error* timeout waiting for transfer task pause\n",
+							 ntv2_vid->name);
+		ntv2_video_resume(ntv2_vid);
 		return result;
 	}
 
 	return 0;
 }
 
+int ntv2_video_resume(struct ntv2_video *ntv2_vid)
+{
+	unsigned long flags;
+
+	if ((ntv2_vid == NULL) || (ntv2_vid->ntv2_chn == NULL))
+		return -EPERM;
+
+	if (!ntv2_vid->transfer_pause)
+		return 0;
+
+	NTV2_MSG_VIDEO_STATE("%s: video transfer task resume\n", ntv2_vid->name);
+
+	spin_lock_irqsave(&ntv2_vid->state_lock, flags);
+	ntv2_vid->transfer_pause = false;
+	ntv2_vid->input_changed = false;
+	spin_unlock_irqrestore(&ntv2_vid->state_lock, flags);
+
+	/* schedule the transfer task */
+	tasklet_schedule(&ntv2_vid->transfer_task);
+
+	return 0;
+}
+
+int ntv2_video_reconfigure(struct ntv2_video *ntv2_vid)
+{
+	int result;
+
+	if ((ntv2_vid == NULL) || (ntv2_vid->ntv2_chn == NULL))
+		return -EPERM;
+
+	ntv2_channel_set_reader_interval(ntv2_vid->vid_str,
+									 ntv2_vid->reader,
+									 ntv2_vid->frame_interval);
+
+	/* the ancillary node never sets the channel format */
+	if (ntv2_vid->anc)
+		return ntv2_video_resume(ntv2_vid);
+
+	/* reprogram the running channel with the new format */
+	result = ntv2_channel_reconfigure(ntv2_vid->vid_str,
+									  &ntv2_vid->input_format,
+									  &ntv2_vid->video_format,
+									  &ntv2_vid->pixel_format);
+	if (result != 0) {
+		NTV2_MSG_VIDEO_ERROR("%s: *error* can not reconfigure channel code %d\n",
+							 ntv2_vid->name, result);
+		return result;
+	}
+
+	return ntv2_video_resume(ntv2_vid);
+}
+
 static bool ntv2_video_compare_input_format(struct ntv2_input_format *format_a,
 											struct ntv2_input_format *format_b)
 {
@@ -386,7 +554,7 @@ static bool ntv2_video_compare_input_format(struct ntv2_input_format *format_a,
 static void ntv2_video_transfer_task(unsigned long data)
 {
 	struct ntv2_video *ntv2_vid = (struct ntv2_video*)data;
-	struct ntv2_input_config *config;
+	const struct ntv2_input_config *config;
 	struct ntv2_input_format inpf;
 	struct ntv2_transfer trn;
 #ifdef NTV2_USE_V4L2_EVENT
@@ -397,11 +565,14 @@ static void ntv2_video_transfer_task(unsigned long data)
 #endif
 	unsigned long flags;
 	bool dodma = false;
+	int num_planes = 0;
 	int result = 0;
+	int i;
 
 	spin_lock_irqsave(&ntv2_vid->state_lock, flags);
 	if (!ntv2_vid->dma_start)
-		ntv2_vid->task_state = ntv2_vid->transfer_state;
+		ntv2_vid->task_state = ntv2_vid->transfer_pause?
+			ntv2_task_state_disable : ntv2_vid->transfer_state;
 	if (ntv2_vid->task_state != ntv2_task_state_enable) {
 		spin_unlock_irqrestore(&ntv2_vid->state_lock, flags);
 		return;
@@ -412,12 +583,24 @@ static void ntv2_video_transfer_task(unsigned long data)
 		(ntv2_vid->dma_vidbuf != NULL) &&
 		(ntv2_vid->dma_vb2buf != NULL)) {
 
-		/* copy stream data to vb2 buffer */
-		ntv2_video_stream_to_buffer(ntv2_vid, ntv2_vid->dma_vidbuf, ntv2_vid->dma_vb2buf);
+		if (ntv2_vid->output) {
+			/* play the frame unless the dma failed */
+			if (ntv2_vid->dma_result == 0)
+				ntv2_channel_data_queue(ntv2_vid->dma_vidbuf);
+			else
+				ntv2_channel_data_done(ntv2_vid->dma_vidbuf);
+		} else {
+			/* copy stream data to vb2 buffer */
+			ntv2_video_stream_to_buffer(ntv2_vid, ntv2_vid->dma_vidbuf, ntv2_vid->dma_vb2buf);
+			ntv2_channel_data_done_reader(ntv2_vid->dma_vidbuf, ntv2_vid->reader);
+		}
 
-		/* mark buffers as done */
-		ntv2_channel_data_done(ntv2_vid->dma_vidbuf);
+		/* mark vb2 buffer as done */
 		ntv2_vb2ops_vb2buf_done(ntv2_vid->dma_vb2buf);
+#ifdef NTV2_USE_FRAME_TRACE
+		if (!ntv2_vid->output)
+			ntv2_trace_buffer_done(ntv2_vid->ntv2_trc, ntv2_vid->vb2buf_sequence - 1);
+#endif
 
 		/* clear current dma buffers */
 		ntv2_vid->dma_vb2buf = NULL;
@@ -428,11 +611,19 @@ static void ntv2_video_transfer_task(unsigned long data)
 	}
 
 	/* look for dma work */
-	if (!ntv2_vid->dma_start) {
+	if (!ntv2_vid->dma_start &&
+		!ntv2_vid->transfer_pause &&
+		(ntv2_vid->transfer_state == ntv2_task_state_enable)) {
 		ntv2_vid->dma_vb2buf = ntv2_vb2ops_vb2buf_ready(ntv2_vid);
 		if (ntv2_vid->dma_vb2buf != NULL) {
-			ntv2_vid->dma_vidbuf = ntv2_channel_data_ready(ntv2_vid->vid_str);
+			if (ntv2_vid->output)
+				ntv2_vid->dma_vidbuf = ntv2_channel_data_free(ntv2_vid->vid_str);
+			else
+				ntv2_vid->dma_vidbuf = ntv2_channel_data_ready_reader(ntv2_vid->vid_str,
+																	  ntv2_vid->reader);
 			if (ntv2_vid->dma_vidbuf != NULL) {
+				num_planes = ntv2_vid->dma_vb2buf->num_planes;
+				ntv2_vid->dma_pending = num_planes;
 				ntv2_vid->dma_start = true;
 				dodma = true;
 			}
@@ -441,36 +632,40 @@ static void ntv2_video_transfer_task(unsigned long data)
 
 	spin_unlock_irqrestore(&ntv2_vid->state_lock, flags);
 
-	/* queue work to dma engine */
-	if (dodma) {
-		trn.mode = ntv2_transfer_mode_c2s;
-		trn.sg_offset = 0;
-		if ((ntv2_vid->video_format.v4l2_timings.bt.height == 480) &&
-			(ntv2_frame_geometry_height(ntv2_vid->video_format.frame_geometry) == 486)) {
-			trn.sg_offset = 3 * ntv2_features_line_pitch(&ntv2_vid->pixel_format,
-														 ntv2_frame_geometry_width(ntv2_vid->video_format.frame_geometry));
-		}
-		trn.sg_list = ntv2_vid->dma_vb2buf->sgtable->sgl;
-		trn.sg_pages = ntv2_vid->dma_vb2buf->num_pages;
-		trn.card_address[0] = ntv2_vid->dma_vidbuf->video.address + trn.sg_offset;
-#ifdef NTV2_USE_VB2_V4L2_BUFFER
-		trn.card_size[0] = vb2_plane_size(&ntv2_vid->dma_vb2buf->vb2_v4l2_buffer.vb2_buf, 0);
-#else
-		trn.card_size[0] = vb2_plane_size(&ntv2_vid->dma_vb2buf->vb2_buffer, 0);
+#ifdef NTV2_USE_FRAME_TRACE
+	if (dodma && !ntv2_vid->output)
+		ntv2_trace_dma_start(ntv2_vid->ntv2_trc,
+							 ntv2_vid->dma_vidbuf->video.frame_number,
+							 (s64)ntv2_vid->dma_vidbuf->irq_time);
 #endif
-		trn.card_address[1] = 0;
-		trn.card_size[1] = 0;
-		trn.callback_func = ntv2_video_dma_callback;
-		trn.callback_data = (unsigned long)ntv2_vid;
-		result = ntv2_pci_transfer(ntv2_vid->ntv2_pci, &trn);
-		if (result != 0) {
-			ntv2_vid->dma_done = true;
-			ntv2_vid->dma_result = result;
+
+	/* both ancillary fields go in one transfer */
+	if (dodma && ntv2_vid->anc) {
+		ntv2_video_anc_transfer(ntv2_vid, &trn);
+		/* nothing to move when no packets were extracted */
+		if (trn.card_size[0] != 0)
+			result = ntv2_pci_transfer(ntv2_vid->ntv2_pci, &trn);
+		if ((trn.card_size[0] == 0) || (result != 0))
+			ntv2_video_dma_callback((unsigned long)ntv2_vid, result);
+		dodma = false;
+	}
+
+	/* queue work to dma engine, one transfer per buffer plane */
+	if (dodma) {
+		for (i = 0; i < num_planes; i++) {
+			ntv2_video_plane_transfer(ntv2_vid, i, &trn);
+			result = ntv2_pci_transfer(ntv2_vid->ntv2_pci, &trn);
+			if (result != 0) {
+				/* complete the planes that were not queued */
+				for (; i < num_planes; i++)
+					ntv2_video_dma_callback((unsigned long)ntv2_vid, result);
+				break;
+			}
 		}
 	}
 
 	/* check for input changes */
-	if (!ntv2_vid->input_changed) {
+	if (!ntv2_vid->output && !ntv2_vid->input_changed) {
 		config = ntv2_features_get_input_config(ntv2_vid->features,
 												ntv2_vid->index,
 												ntv2_vid->v4l2_input);
@@ -488,6 +683,109 @@ static void ntv2_video_transfer_task(unsigned long data)
 	}
 }
 
+static void ntv2_video_plane_transfer(struct ntv2_video *ntv2_vid,
+									  int plane,
+									  struct ntv2_transfer *trn)
+{
+	const struct ntv2_pixel_format *pixf = &ntv2_vid->pixel_format;
+	struct v4l2_rect *crop = &ntv2_vid->crop;
+	u32 geometry = ntv2_vid->video_format.frame_geometry;
+	u32 height = ntv2_frame_geometry_height(geometry);
+	u32 pitch = ntv2_features_line_pitch(pixf, ntv2_frame_geometry_width(geometry));
+	u32 line_bytes = ntv2_features_line_bytes(pixf, crop->width);
+	u32 system_pitch;
+	u32 left_bytes = 0;
+	u32 offset = 0;
+	u32 top = crop->top;
+
+	/* 480 line capture skips the top of the 486 line frame */
+	if ((ntv2_vid->video_format.v4l2_timings.bt.height == 480) && (height == 486))
+		top += 3;
+
+	/* card planes are stored back to back */
+	if (plane > 0) {
+		offset = pitch * ntv2_features_plane_lines(pixf, 0, height);
+		top = ntv2_features_plane_lines(pixf, plane, top);
+	}
+
+	/* horizontal crop reads a segment of each card line */
+	if (pixf->cadence_pixels != 0)
+		left_bytes = (crop->left / pixf->cadence_pixels) * pixf->cadence_bytes;
+
+	trn->mode = ntv2_vid->output? ntv2_transfer_mode_s2c : ntv2_transfer_mode_c2s;
+	trn->sg_offset = pitch * top + left_bytes;
+	trn->sg_list = ntv2_vid->dma_vb2buf->sgtable[plane]->sgl;
+	trn->sg_pages = ntv2_vid->dma_vb2buf->num_pages[plane];
+	trn->card_address[0] = ntv2_vid->dma_vidbuf->video.address + offset + trn->sg_offset;
+	/* buffers may be larger than the current format */
+	if (ntv2_vid->mplane) {
+		trn->card_size[0] = ntv2_vid->v4l2_format_mp.plane_fmt[plane].sizeimage;
+		system_pitch = ntv2_vid->v4l2_format_mp.plane_fmt[plane].bytesperline;
+	} else {
+		trn->card_size[0] = ntv2_vid->v4l2_format.sizeimage;
+		system_pitch = ntv2_vid->v4l2_format.bytesperline;
+	}
+	trn->card_address[1] = 0;
+	trn->card_size[1] = 0;
+
+	/* contiguous planes split the buffer between the card luma and chroma planes */
+	if ((pixf->num_planes > 1) && (ntv2_features_buffer_planes(pixf) == 1) &&
+		(pixf->plane_line_divisor != 0)) {
+		trn->card_size[0] = line_bytes * crop->height;
+		trn->card_address[1] = ntv2_vid->dma_vidbuf->video.address +
+			pitch * (height + top / pixf->plane_line_divisor) + left_bytes;
+		trn->card_size[1] = line_bytes * (crop->height / pixf->plane_line_divisor);
+	}
+
+	trn->card_pitch = pitch;
+	trn->card_segment = (line_bytes < pitch)? line_bytes : 0;
+	trn->system_pitch = 0;
+
+	/* lines move the crop cadence bytes, the buffer keeps the aligned pitch */
+	if ((trn->card_segment != 0) && (line_bytes < system_pitch)) {
+		trn->system_pitch = system_pitch;
+		if (trn->card_size[1] == 0)
+			trn->card_size[0] = trn->card_size[0] / system_pitch * line_bytes;
+	}
+
+	trn->callback_func = ntv2_video_dma_callback;
+	trn->callback_data = (unsigned long)ntv2_vid;
+	trn->priority = false;
+}
+
+static void ntv2_video_anc_transfer(struct ntv2_video *ntv2_vid,
+									struct ntv2_transfer *trn)
+{
+	struct ntv2_video_data *video = &ntv2_vid->dma_vidbuf->video;
+	int field = 0;
+	int i;
+
+	trn->mode = ntv2_transfer_mode_c2s;
+	trn->sg_offset = 0;
+	trn->sg_list = ntv2_vid->dma_vb2buf->sgtable[0]->sgl;
+	trn->sg_pages = ntv2_vid->dma_vb2buf->num_pages[0];
+	trn->card_address[0] = 0;
+	trn->card_size[0] = 0;
+	trn->card_address[1] = 0;
+	trn->card_size[1] = 0;
+
+	/* pack the fields with data back to back */
+	for (i = 0; i < 2; i++) {
+		if (video->anc_size[i] == 0)
+			continue;
+		trn->card_address[field] = video->anc_address[i];
+		trn->card_size[field] = video->anc_size[i];
+		field++;
+	}
+
+	trn->card_pitch = 0;
+	trn->card_segment = 0;
+	trn->system_pitch = 0;
+	trn->callback_func = ntv2_video_dma_callback;
+	trn->callback_data = (unsigned long)ntv2_vid;
+	trn->priority = false;
+}
+
 static void ntv2_video_dma_callback(unsigned long data, int result)
 {
 	struct ntv2_video *ntv2_vid = (struct ntv2_video *)data;
@@ -496,10 +794,18 @@ static void ntv2_video_dma_callback(unsigned long data, int result)
 	if (ntv2_vid == NULL)
 		return;
 
-	/* record dma complete */
+	/* record dma complete when all planes are done */
 	spin_lock_irqsave(&ntv2_vid->state_lock, flags);
-	ntv2_vid->dma_done = true;
-	ntv2_vid->dma_result = result;
+	if (result != 0)
+		ntv2_vid->dma_result = result;
+	if (ntv2_vid->dma_pending > 0)
+		ntv2_vid->dma_pending--;
+	if (ntv2_vid->dma_pending == 0) {
+		ntv2_vid->dma_done = true;
+#ifdef NTV2_USE_FRAME_TRACE
+		ntv2_trace_dma_done(ntv2_vid->ntv2_trc);
+#endif
+	}
 	spin_unlock_irqrestore(&ntv2_vid->state_lock, flags);
 
 	/* schedule the dma task */
@@ -531,6 +837,12 @@ static void ntv2_video_stream_to_buffer(struct ntv2_video *ntv2_vid,
 #ifdef NTV2_USE_VB2_V4L2_BUFFER
 #ifdef NTV2_USE_VB2_BUFFER_TIMESTAMP
 	buffer->vb2_v4l2_buffer.vb2_buf.timestamp = data->timestamp;
+	if (ntv2_module_info()->video_tai)
+#ifdef NTV2_USE_KTIME_CLOCKTAI
+		buffer->vb2_v4l2_buffer.vb2_buf.timestamp += ktime_get_clocktai_ns() - ktime_get_ns();
+#else
+		buffer->vb2_v4l2_buffer.vb2_buf.timestamp += ktime_get_tai_ns() - ktime_get_ns();
+#endif
 #else
 	buffer->vb2_v4l2_buffer.timestamp = data->timestamp;
 #endif
@@ -543,6 +855,19 @@ static void ntv2_video_stream_to_buffer(struct ntv2_video *ntv2_vid,
 	buffer->vb2_buffer.v4l2_buf.field = ntv2_vid->v4l2_format.field;
 #endif	
 
+	/* metadata carries only the extracted bytes */
+	if (ntv2_vid->anc) {
+#ifdef NTV2_USE_VB2_V4L2_BUFFER
+		buffer->vb2_v4l2_buffer.field = V4L2_FIELD_NONE;
+		vb2_set_plane_payload(&buffer->vb2_v4l2_buffer.vb2_buf, 0,
+							  data->video.anc_size[0] + data->video.anc_size[1]);
+#else
+		buffer->vb2_buffer.v4l2_buf.field = V4L2_FIELD_NONE;
+		vb2_set_plane_payload(&buffer->vb2_buffer, 0,
+							  data->video.anc_size[0] + data->video.anc_size[1]);
+#endif
+	}
+
 	/* copy timecode if present */
 	if (data->video.timecode_present) {
 
@@ -24,6 +24,7 @@
 
 struct ntv2_features;
 struct ntv2_pci;
+struct ntv2_trace;
 
 struct ntv2_vb2buf {
 #ifdef NTV2_USE_VB2_V4L2_BUFFER
@@ -36,13 +37,17 @@ struct ntv2_vb2buf {
 	struct ntv2_video			*ntv2_vid;
 
 	bool						init;
-	struct sg_table				*sgtable;
-	struct sg_table				vmalloc_table;
-	int							num_pages;
+	int							num_planes;
+	struct sg_table				*sgtable[NTV2_MAX_PLANES];
+	struct sg_table				vmalloc_table[NTV2_MAX_PLANES];
+	int							num_pages[NTV2_MAX_PLANES];
 };
 
 struct ntv2_video {
 	int							index;
+	int							reader;
+	bool						output;
+	bool						anc;
 	char						name[NTV2_STRING_SIZE];
 	struct list_head			list;
 	struct ntv2_device			*ntv2_dev;
@@ -65,24 +70,31 @@ struct ntv2_video {
 	spinlock_t 					state_lock;
 	struct tasklet_struct		transfer_task;
 	enum ntv2_task_state		transfer_state;
+	bool						transfer_pause;
 	enum ntv2_task_state		task_state;
 	atomic_t					video_ref;
 
 	v4l2_std_id					v4l2_std;
 	struct v4l2_dv_timings		v4l2_timings;
 	struct v4l2_pix_format		v4l2_format;
+	struct v4l2_pix_format_mplane	v4l2_format_mp;
+	struct v4l2_rect			crop;
 	u32							v4l2_input;
+	bool						mplane;
 
 	struct ntv2_pixel_format	pixel_format;
 	struct ntv2_video_format	video_format;
 	struct ntv2_input_format	input_format;
 	bool						drop_frame;
+	u32							frame_interval;
 
 	struct vb2_queue			vb2_queue;
 	struct mutex				vb2_mutex;
 	spinlock_t 					vb2_lock;
 	bool						vb2_init;
 	bool						vb2_start;
+	u32							vb2_num_planes;
+	u32							vb2_plane_size[NTV2_MAX_PLANES];
 
 	struct list_head 			vb2buf_list;
 	int							vb2buf_index;
@@ -93,11 +105,14 @@ struct ntv2_video {
 	bool						dma_start;
 	bool						dma_done;
 	int							dma_result;
+	int							dma_pending;
 	bool						input_changed;
+	struct ntv2_trace			*ntv2_trc;
 };
 
 struct ntv2_video *ntv2_video_open(struct ntv2_object *ntv2_obj,
-								   const char *name, int index);
+								   const char *name, int index, int reader,
+								   enum ntv2_video_type type);
 void ntv2_video_close(struct ntv2_video *ntv2_vid);
 
 int ntv2_video_configure(struct ntv2_video *ntv2_vid,
@@ -115,7 +130,11 @@ int ntv2_video_start(struct ntv2_video *ntv2_vid);
 int ntv2_video_stop(struct ntv2_video *ntv2_vid);
 int ntv2_video_flush(struct ntv2_video *ntv2_vid);
 
+int ntv2_video_pause(struct ntv2_video *ntv2_vid);
+int ntv2_video_resume(struct ntv2_video *ntv2_vid);
+int ntv2_video_reconfigure(struct ntv2_video *ntv2_vid);
+
 bool ntv2_video_compatible_input_format(struct ntv2_input_format *inpf,
-										struct ntv2_video_format *vidf);
+										const struct ntv2_video_format *vidf);
 
 #endif
@@ -24,6 +24,33 @@
 #include "ntv2_features.h"
 
 int ntv2_videoops_acquire_hardware(struct ntv2_channel_stream *stream);
+int ntv2_videoops_acquire_playback(struct ntv2_channel_stream *stream);
+static void ntv2_videoops_statistics(struct ntv2_channel_stream *stream);
+static void ntv2_videoops_update_anc(struct ntv2_channel_stream *stream);
+static void ntv2_videoops_anc_frame(struct ntv2_channel_stream *stream,
+									struct ntv2_stream_data *data);
+static void ntv2_videoops_anc_status(struct ntv2_channel_stream *stream,
+									 struct ntv2_stream_data *data);
+
+/* vertical blanking lines searched by the ancillary extractor */
+struct ntv2_videoops_anc_lines {
+	u32		total_lines;
+	u32		field1_start;
+	u32		field1_cutoff;
+	u32		field2_start;
+	u32		field2_cutoff;
+};
+
+static const struct ntv2_videoops_anc_lines ntv2_videoops_anc_table[] = {
+	{ 1125,	1124,	20,		561,	583 },		/* 1080i */
+	{ 750,	746,	25,		0,		0 },		/* 720p */
+	{ 525,	4,		20,		266,	283 },		/* 525i */
+	{ 625,	1,		22,		313,	335 },		/* 625i */
+	{ 1125,	1122,	41,		0,		0 },		/* 1080p */
+	{ 0,	0,		0,		0,		0 },		/* 2048x1556 */
+	{ 1125,	1122,	41,		0,		0 },		/* 2048x1080p */
+	{ 1125,	1124,	20,		561,	583 },		/* 2048x1080i */
+};
 
 
 int ntv2_videoops_setup_capture(struct ntv2_channel_stream *stream)
@@ -74,6 +101,15 @@ int ntv2_videoops_setup_capture(struct ntv2_channel_stream *stream)
 		stream->data_array[buf_index].video.frame_number = i;
 		stream->data_array[buf_index].video.address = i * stream->video.frame_size;
 		stream->data_array[buf_index].video.data_size = 0;
+		/* ancillary data fills the end of the frame */
+		stream->data_array[buf_index].video.anc_address[0] =
+			(i + 1) * stream->video.frame_size - 2 * NTV2_ANC_FIELD_SIZE;
+		stream->data_array[buf_index].video.anc_address[1] =
+			(i + 1) * stream->video.frame_size - NTV2_ANC_FIELD_SIZE;
+		stream->data_array[buf_index].video.anc_size[0] = 0;
+		stream->data_array[buf_index].video.anc_size[1] = 0;
+		stream->data_array[buf_index].reader_pending = 0;
+		stream->data_array[buf_index].reader_taken = 0;
 		list_add_tail(&stream->data_array[buf_index].list, &stream->data_done_list);
 		buf_index++;
 	}
@@ -96,6 +132,114 @@ int ntv2_videoops_release_capture(struct ntv2_channel_stream *stream)
 	return 0;
 }
 
+int ntv2_videoops_reconfigure_capture(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	struct ntv2_features *features = ntv2_chn->features;
+	u32 first;
+	u32 last;
+	u32 size;
+
+	/* frame store layout must not move under queued frames */
+	ntv2_features_get_frame_range(features,
+								  &stream->video.video_format,
+								  &stream->video.pixel_format,
+								  ntv2_chn->index,
+								  &first,
+								  &last,
+								  &size);
+	if ((first != stream->video.frame_first) ||
+		(last != stream->video.frame_last) ||
+		(size != stream->video.frame_size))
+		return -EBUSY;
+
+	/* reacquire video hardware for the new input */
+	ntv2_features_release_video_components(features, (unsigned long)stream);
+	return ntv2_videoops_acquire_hardware(stream);
+}
+
+int ntv2_videoops_setup_playback(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	struct ntv2_features *features = ntv2_chn->features;
+	int index = ntv2_chn->index;
+	int buf_index;
+	int result;
+	int i;
+
+	/* acquire video hardware resources */
+	result = ntv2_videoops_acquire_playback(stream);
+	if (result != 0)
+		return result;
+
+	/* get the video frame buffer frame range and size */
+	ntv2_features_get_frame_range(features,
+								  &stream->video.video_format,
+								  &stream->video.pixel_format,
+								  index,
+								  &stream->video.frame_first,
+								  &stream->video.frame_last,
+								  &stream->video.frame_size);
+
+	/* initialize video output stream data */
+	INIT_LIST_HEAD(&stream->data_ready_list);
+	INIT_LIST_HEAD(&stream->data_done_list);
+	stream->queue_run = false;
+	stream->queue_last = false;
+	stream->video.frame_active	= NULL;
+	stream->video.frame_next	= NULL;
+	stream->video.total_frame_count = 0;
+	stream->video.total_drop_count = 0;
+	stream->video.stat_frame_count = 0;
+	stream->video.stat_drop_count = 0;
+	stream->video.last_display_time = 0;
+	for (i = 0; i < NTV2_MAX_CHANNELS; i++)
+		stream->video.hardware_enable[i] = false;
+
+	/* the done list holds the free frames */
+	buf_index = 0;
+	for (i = stream->video.frame_first; i <= stream->video.frame_last; i++) {
+		stream->data_array[buf_index].index = buf_index;
+		stream->data_array[buf_index].type = stream->type;
+		INIT_LIST_HEAD(&stream->data_array[buf_index].list);
+		stream->data_array[buf_index].ntv2_str = stream;
+		stream->data_array[buf_index].video.frame_number = i;
+		stream->data_array[buf_index].video.address = i * stream->video.frame_size;
+		stream->data_array[buf_index].video.data_size = stream->video.frame_size;
+		stream->data_array[buf_index].reader_pending = 0;
+		stream->data_array[buf_index].reader_taken = 0;
+		list_add_tail(&stream->data_array[buf_index].list, &stream->data_done_list);
+		buf_index++;
+	}
+
+	/* the frame store plays the first frame until data is queued */
+	stream->video.frame_active = list_first_entry(&stream->data_done_list, struct ntv2_stream_data, list);
+	list_del_init(&stream->video.frame_active->list);
+	stream->video.frame_next = stream->video.frame_active;
+
+	ntv2_reg_write(ntv2_chn->vid_reg,
+				   ntv2_kona_reg_frame_output, index,
+				   stream->video.frame_next->video.frame_number);
+
+	return 0;
+}
+
+int ntv2_videoops_release_playback(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	struct ntv2_features *features = ntv2_chn->features;
+	int i;
+
+	/* return sdi to input mode */
+	for (i = 0; i < stream->num_channels; i++)
+		ntv2_sdi_output_transmit_enable(ntv2_chn->vid_reg, stream->channel_index + i, false);
+
+	/* release hardware resources */
+	ntv2_features_release_video_components(features, (unsigned long)stream);
+
+	return 0;
+}
+
 int ntv2_videoops_update_mode(struct ntv2_channel_stream *stream)
 {
 	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
@@ -116,6 +260,23 @@ int ntv2_videoops_update_mode(struct ntv2_channel_stream *stream)
 		}
 	}
 
+	/* ancillary extraction follows capture */
+	ntv2_videoops_update_anc(stream);
+
+	return 0;
+}
+
+int ntv2_videoops_update_mode_playback(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	u32 mask = NTV2_FLD_MASK(ntv2_kona_fld_frame_capture_enable);
+	int i;
+
+	/* frame store plays out when not capturing */
+	for (i = stream->channel_index; i < (stream->channel_index + stream->num_channels); i++) {
+		ntv2_reg_rmw(ntv2_chn->vid_reg, ntv2_kona_reg_frame_control, i, 0, mask);
+	}
+
 	return 0;
 }
 
@@ -128,6 +289,8 @@ int ntv2_videoops_update_format(struct ntv2_channel_stream *stream)
 
 	val = NTV2_FLD_SET(ntv2_kona_fld_frame_buffer_format_b0123, stream->video.pixel_format.ntv2_pixel_format);
 	mask = NTV2_FLD_MASK(ntv2_kona_fld_frame_buffer_format_b0123);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_frame_buffer_format_b4, stream->video.pixel_format.ntv2_pixel_format >> 4);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_frame_buffer_format_b4);
 
 	/* set frame store pixel format */
 	for (i = stream->channel_index; i < (stream->channel_index + stream->num_channels); i++) {
@@ -146,17 +309,22 @@ int ntv2_videoops_update_timing(struct ntv2_channel_stream *stream)
 {
 	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
 	struct ntv2_input_format *input_format = &stream->video.input_format;
-	struct ntv2_video_format *video_format = &stream->video.video_format;
+	const struct ntv2_video_format *video_format = &stream->video.video_format;
 	int index = stream->channel_index;
 	int mode_372 = 0;
 	int mode_sync = ntv2_kona_reg_sync_field;
 	bool mode_tsi = false;
 	bool mode_quad = false;
+	u32 ref_source = ntv2_kona_ref_source_sdiin1;
 	u32 standard;
 	u32 rate;
 	u32 val;
 	u32 msk;
 
+	/* playback has no input to lock to */
+	if (!stream->capture)
+		ref_source = ntv2_kona_ref_source_freerun;
+
 	/* sync to frame for interlaced video */
 	if ((video_format->frame_flags & ntv2_kona_frame_picture_interlaced) != 0)
 		mode_sync = ntv2_kona_reg_sync_frame;
@@ -195,7 +363,7 @@ int ntv2_videoops_update_timing(struct ntv2_channel_stream *stream)
 	val |= NTV2_FLD_SET(ntv2_kona_fld_global_frame_rate_b3, rate >> 3);
 	val |= NTV2_FLD_SET(ntv2_kona_fld_global_frame_geometry, video_format->frame_geometry);
 	val |= NTV2_FLD_SET(ntv2_kona_fld_global_video_standard, standard);
-	val |= NTV2_FLD_SET(ntv2_kona_fld_reference_source_b012, ntv2_kona_ref_source_sdiin1 & 0x7);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_reference_source_b012, ref_source & 0x7);
 	val |= NTV2_FLD_SET(ntv2_kona_fld_linkb_p60_mode_ch2, mode_372);
 	val |= NTV2_FLD_SET(ntv2_kona_fld_global_reg_sync, mode_sync);
 	ntv2_reg_write(ntv2_chn->vid_reg, ntv2_kona_reg_global_control, index, val);
@@ -272,8 +440,11 @@ int ntv2_videoops_update_timing(struct ntv2_channel_stream *stream)
 	msk |= NTV2_FLD_MASK(ntv2_kona_fld_independent_channel_enable);
 
 	/* need to figure out how to handle reference source */
-	val |= NTV2_FLD_SET(ntv2_kona_fld_reference_source_b3, ntv2_kona_ref_source_sdiin1 >> 3);
-	msk |= NTV2_FLD_MASK(ntv2_kona_fld_reference_source_b3);
+	/* the b3 bit is board wide so playback leaves the capture reference alone */
+	if (stream->capture) {
+		val |= NTV2_FLD_SET(ntv2_kona_fld_reference_source_b3, ref_source >> 3);
+		msk |= NTV2_FLD_MASK(ntv2_kona_fld_reference_source_b3);
+	}
 	
 	ntv2_reg_rmw(ntv2_chn->vid_reg, ntv2_kona_reg_global_control2, 0, val, msk);
 //	NTV2_MSG_INFO("%s: write global control2 %08x/%08x\n", ntv2_chn->name, val, msk);
@@ -286,7 +457,7 @@ int ntv2_videoops_update_route(struct ntv2_channel_stream *stream)
 	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
 	struct ntv2_register *vid_reg = ntv2_chn->vid_reg;
 	struct ntv2_input_format *input_format = &stream->video.input_format;
-	struct ntv2_pixel_format *pixel_format = &stream->video.pixel_format;
+	const struct ntv2_pixel_format *pixel_format = &stream->video.pixel_format;
 	int chn_index = 0;
 	int inp_index = 0;
 	int csc_index = 0;
@@ -468,6 +639,57 @@ int ntv2_videoops_update_route(struct ntv2_channel_stream *stream)
 	return 0;
 }
 
+int ntv2_videoops_update_route_playback(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	struct ntv2_register *vid_reg = ntv2_chn->vid_reg;
+	const struct ntv2_video_format *video_format = &stream->video.video_format;
+	const struct ntv2_pixel_format *pixel_format = &stream->video.pixel_format;
+	u32 standard = video_format->video_standard;
+	u32 mode_2k = 0;
+	u32 mode_3g = 0;
+	bool fs_rgb;
+	u32 val;
+	u32 mask;
+	int i;
+
+	fs_rgb = (pixel_format->pixel_flags & ntv2_kona_pixel_rgb) != 0;
+
+	/* 2k is signalled as hd with the 2k flag */
+	if (standard == ntv2_kona_video_standard_2048x1080p) {
+		standard = ntv2_kona_video_standard_1080p;
+		mode_2k = 1;
+	} else if (standard == ntv2_kona_video_standard_2048x1080i) {
+		standard = ntv2_kona_video_standard_1080i;
+		mode_2k = 1;
+	}
+
+	/* high frame rate hd is 3g level a */
+	if ((video_format->frame_flags & ntv2_kona_frame_3g) != 0)
+		mode_3g = 1;
+
+	val = NTV2_FLD_SET(ntv2_kona_fld_sdiout_video_standard, standard);
+	mask = NTV2_FLD_MASK(ntv2_kona_fld_sdiout_video_standard);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_sdiout_2Kx1080_mode, mode_2k);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_sdiout_2Kx1080_mode);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_sdiout_3g_mode, mode_3g);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_sdiout_3g_mode);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_sdiout_3gb_mode, 0);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_sdiout_3gb_mode);
+
+	for (i = 0; i < stream->num_channels; i++) {
+		/* route frame store to the sdi output of the same index */
+		ntv2_route_fs_to_sdi(vid_reg,
+							 stream->channel_index + i, 0, fs_rgb,
+							 stream->channel_index + i, 0);
+		/* configure and enable the sdi transmitter */
+		ntv2_reg_rmw(vid_reg, ntv2_kona_reg_sdiout_control, stream->channel_index + i, val, mask);
+		ntv2_sdi_output_transmit_enable(vid_reg, stream->channel_index + i, true);
+	}
+
+	return 0;
+}
+
 int ntv2_videoops_update_frame(struct ntv2_channel_stream *stream)
 {
 	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
@@ -485,11 +707,15 @@ int ntv2_videoops_interrupt_capture(struct ntv2_channel_stream *stream)
 {
 	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
 	struct ntv2_stream_data *data_ready;
+	struct ntv2_stream_data *data;
 	s64 stat_time = ntv2_chn->dpc_status.stat_time;
-	s64 time_us;
 	u32 val;
+	u32 readers = 0;
+	int num_readers = 0;
 	int chn_index = ntv2_chn->index;
 	int reg_index = 0;
+	bool reclaimed = false;
+	int i;
 	
 	if (!stream->queue_enable)
 		return 0;
@@ -506,8 +732,11 @@ int ntv2_videoops_interrupt_capture(struct ntv2_channel_stream *stream)
 
 	/* this is now the active frame */
 	stream->video.frame_active = stream->video.frame_next;
-	if (stream->video.frame_active != NULL)
+	if (stream->video.frame_active != NULL) {
 		stream->video.frame_active->timestamp = stream->timestamp;
+		/* unfiltered for latency trace */
+		stream->video.frame_active->irq_time = ntv2_chn->dpc_status.irq_time;
+	}
 
 	if (stream->queue_run) {
 		if (stream->queue_last) {
@@ -519,6 +748,17 @@ int ntv2_videoops_interrupt_capture(struct ntv2_channel_stream *stream)
 			stream->video.stat_frame_count = 0;
 			stream->video.stat_drop_count = 0;
 			stream->video.last_display_time = stat_time;
+			stream->video.frame_skip = 0;
+		}
+
+		/* get the running readers */
+		readers = 0;
+		num_readers = 0;
+		for (i = 0; i < NTV2_MAX_STREAM_READERS; i++) {
+			if (stream->readers[i].run) {
+				readers |= (1 << i);
+				num_readers++;
+			}
 		}
 
 		/* get the next data object */
@@ -527,8 +767,34 @@ int ntv2_videoops_interrupt_capture(struct ntv2_channel_stream *stream)
 														struct ntv2_stream_data, list);
 			list_del_init(&stream->video.frame_next->list);
 		} else {
-			stream->video.total_drop_count++;
-			stream->video.stat_drop_count++;
+			/* with several readers reclaim the oldest frame not in transfer */
+			if (num_readers > 1) {
+				list_for_each_entry(data, &stream->data_ready_list, list) {
+					if (data->reader_taken == 0) {
+						list_del_init(&data->list);
+						stream->video.frame_next = data;
+						reclaimed = true;
+						break;
+					}
+				}
+			}
+			/* a reclaimed frame was recycled on purpose */
+			if (!reclaimed) {
+				stream->video.total_drop_count++;
+				stream->video.stat_drop_count++;
+			}
+		}
+
+		/* decimate by recycling frames before transfer, the cadence counts every frame */
+		if ((stream->video.total_frame_count != 0) &&
+			(stream->video.frame_interval > 1)) {
+			if ((stream->video.frame_skip != 0) &&
+				(data_ready != NULL) &&
+				(data_ready->video.frame_number != stream->video.frame_active->video.frame_number)) {
+				list_add_tail(&data_ready->list, &stream->data_done_list);
+				data_ready = NULL;
+			}
+			stream->video.frame_skip = (stream->video.frame_skip + 1) % stream->video.frame_interval;
 		}
 
 		/* add ready frame to queue */
@@ -557,8 +823,16 @@ int ntv2_videoops_interrupt_capture(struct ntv2_channel_stream *stream)
 				}
 			}
 
-			/* add frame to ready list */
-			list_add_tail(&data_ready->list, &stream->data_ready_list);
+			/* get frame ancillary data size */
+			ntv2_videoops_anc_status(stream, data_ready);
+
+			/* add frame to ready list for the running readers */
+			data_ready->reader_pending = readers;
+			data_ready->reader_taken = 0;
+			if (readers != 0)
+				list_add_tail(&data_ready->list, &stream->data_ready_list);
+			else
+				list_add_tail(&data_ready->list, &stream->data_done_list);
 			NTV2_MSG_CHANNEL_STREAM("%s: video capture data queue %d  buffer %d\n",
 									ntv2_chn->name,
 									data_ready->index,
@@ -570,29 +844,88 @@ int ntv2_videoops_interrupt_capture(struct ntv2_channel_stream *stream)
 	ntv2_reg_write(ntv2_chn->vid_reg,
 				   ntv2_kona_reg_frame_input, chn_index,
 				   stream->video.frame_next->video.frame_number);
+	ntv2_videoops_anc_frame(stream, stream->video.frame_next);
 
 	/* cache last enable state */
 	stream->queue_last = stream->queue_run;
 
 	/* print statistics */
-	if (stream->queue_run && (stream->video.stat_frame_count != 0)) {
-		time_us = stat_time - stream->video.last_display_time;
-		if (time_us > NTV2_CHANNEL_STATISTIC_INTERVAL)
-		{
-			NTV2_MSG_CHANNEL_STATISTICS("%s: video frames %4d  drops %4d  time %6d (us)   total frames %lld  drops %lld\n",
-										ntv2_chn->name,
-										(u32)(stream->video.stat_frame_count),
-										(u32)(stream->video.stat_drop_count),
-										(u32)(time_us / stream->video.stat_frame_count),
-										stream->video.total_frame_count,
-										stream->video.total_drop_count);
-			
+	ntv2_videoops_statistics(stream);
+
+	return 0;
+}
+
+int ntv2_videoops_interrupt_playback(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	struct ntv2_stream_data *data_done;
+	s64 stat_time = ntv2_chn->dpc_status.stat_time;
+	int chn_index = ntv2_chn->index;
+
+	if (!stream->queue_enable)
+		return 0;
+
+	/* need an output interrupt */
+	if (!ntv2_chn->dpc_status.interrupt_output)
+		return 0;
+
+	/* update time stamp */
+	stream->timestamp = ntv2_chn->dpc_status.interrupt_time;
+
+	/* this frame has been played */
+	data_done = stream->video.frame_active;
+
+	/* this is now the active frame */
+	stream->video.frame_active = stream->video.frame_next;
+	if (stream->video.frame_active != NULL)
+		stream->video.frame_active->timestamp = stream->timestamp;
+
+	/* repeat the active frame unless new data is queued */
+	stream->video.frame_next = stream->video.frame_active;
+
+	if (stream->queue_run) {
+		if (stream->queue_last) {
+			stream->video.total_frame_count++;
+			stream->video.stat_frame_count++;
+		} else {
+			stream->video.total_frame_count = 0;
+			stream->video.total_drop_count = 0;
 			stream->video.stat_frame_count = 0;
 			stream->video.stat_drop_count = 0;
 			stream->video.last_display_time = stat_time;
 		}
+
+		/* get the next data object */
+		if (!list_empty(&stream->data_ready_list)) {
+			stream->video.frame_next = list_first_entry(&stream->data_ready_list,
+														struct ntv2_stream_data, list);
+			list_del_init(&stream->video.frame_next->list);
+			NTV2_MSG_CHANNEL_STREAM("%s: video playback data queue %d  buffer %d\n",
+									ntv2_chn->name,
+									stream->video.frame_next->index,
+									stream->video.frame_next->video.frame_number);
+		} else if (stream->queue_last) {
+			stream->video.total_drop_count++;
+			stream->video.stat_drop_count++;
+		}
 	}
 
+	/* return the played frame to be filled again */
+	if ((data_done != NULL) &&
+		(data_done != stream->video.frame_active))
+		list_add_tail(&data_done->list, &stream->data_done_list);
+
+	/* frame store plays frame next */
+	ntv2_reg_write(ntv2_chn->vid_reg,
+				   ntv2_kona_reg_frame_output, chn_index,
+				   stream->video.frame_next->video.frame_number);
+
+	/* cache last enable state */
+	stream->queue_last = stream->queue_run;
+
+	/* print statistics */
+	ntv2_videoops_statistics(stream);
+
 	return 0;
 }
 
@@ -601,8 +934,8 @@ int ntv2_videoops_acquire_hardware(struct ntv2_channel_stream *stream)
 	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
 	struct ntv2_features *features = ntv2_chn->features;
 	struct ntv2_input_format *input_format = &stream->video.input_format;
-	struct ntv2_pixel_format *pixel_format = &stream->video.pixel_format;
-	struct ntv2_widget_config *csc_config = NULL;
+	const struct ntv2_pixel_format *pixel_format = &stream->video.pixel_format;
+	const struct ntv2_widget_config *csc_config = NULL;
 	int index = ntv2_chn->index;
 	int num_channels = 1;
 	int num_cscs = 1;
@@ -696,3 +1029,201 @@ release:
 	ntv2_features_release_video_components(features, (unsigned long)stream);
 	return result;
 }
+
+int ntv2_videoops_acquire_playback(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	struct ntv2_features *features = ntv2_chn->features;
+	const struct ntv2_video_format *video_format = &stream->video.video_format;
+	const struct ntv2_pixel_format *pixel_format = &stream->video.pixel_format;
+	int index = ntv2_chn->index;
+	int result;
+
+	/* single link yuv output only */
+	if ((video_format->video_standard > ntv2_kona_video_standard_2048x1080i) ||
+		((pixel_format->pixel_flags & ntv2_kona_pixel_rgb) != 0))
+		return -EINVAL;
+
+	/* the sdi connector must be able to transmit */
+	if (index >= features->num_sdi_inputs)
+		return -EPERM;
+
+	/* acquire output */
+	result = ntv2_features_acquire_components(features,
+											  ntv2_component_sdi,
+											  index,
+											  1,
+											  (unsigned long)stream);
+	if (result != 0)
+		goto release;
+
+	/* acquire frame store */
+	result = ntv2_features_acquire_components(features,
+											  ntv2_component_video,
+											  index,
+											  1,
+											  (unsigned long)stream);
+	if (result != 0)
+		goto release;
+
+	stream->channel_index = index;
+	stream->num_channels = 1;
+
+	return 0;
+
+release:
+	ntv2_features_release_video_components(features, (unsigned long)stream);
+	return result;
+}
+
+static void ntv2_videoops_statistics(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	s64 stat_time = ntv2_chn->dpc_status.stat_time;
+	s64 time_us;
+
+	if (!stream->queue_run || (stream->video.stat_frame_count == 0))
+		return;
+
+	time_us = stat_time - stream->video.last_display_time;
+	if (time_us > NTV2_CHANNEL_STATISTIC_INTERVAL)
+	{
+		NTV2_MSG_CHANNEL_STATISTICS("%s: video frames %4d  drops %4d  time %6d (us)   total frames %lld  drops %lld\n",
+									ntv2_chn->name,
+									(u32)(stream->video.stat_frame_count),
+									(u32)(stream->video.stat_drop_count),
+									(u32)(time_us / stream->video.stat_frame_count),
+									stream->video.total_frame_count,
+									stream->video.total_drop_count);
+
+		stream->video.stat_frame_count = 0;
+		stream->video.stat_drop_count = 0;
+		stream->video.last_display_time = stat_time;
+	}
+}
+
+static void ntv2_videoops_update_anc(struct ntv2_channel_stream *stream)
+{
+	struct ntv2_channel *ntv2_chn = stream->ntv2_chn;
+	struct ntv2_features *features = ntv2_chn->features;
+	struct ntv2_register *vid_reg = ntv2_chn->vid_reg;
+	struct ntv2_input_format *input_format = &stream->video.input_format;
+	const struct ntv2_videoops_anc_lines *lines;
+	u32 standard = stream->video.video_format.video_standard;
+	u32 frame_bytes;
+	bool sd;
+	u32 val;
+	u32 mask;
+	int index;
+
+	/* stop the extractor in use */
+	if (stream->video.anc_index >= 0) {
+		ntv2_reg_rmw(vid_reg, ntv2_kona_reg_anc_ext_control, stream->video.anc_index,
+					 NTV2_FLD_SET(ntv2_kona_fld_anc_ext_disable, 1),
+					 NTV2_FLD_MASK(ntv2_kona_fld_anc_ext_disable));
+		NTV2_MSG_CHANNEL_STATE("%s: anc extractor %d disable\n",
+							   ntv2_chn->name, stream->video.anc_index);
+		stream->video.anc_index = -1;
+	}
+
+	if (!stream->queue_enable)
+		return;
+
+	/* extract from a single link sdi input */
+	index = input_format->input_index;
+	if ((input_format->type != ntv2_input_type_sdi) ||
+		(input_format->num_inputs != 1) ||
+		(index < 0) ||
+		(index >= features->num_anc_extractors))
+		return;
+
+	if (standard >= ARRAY_SIZE(ntv2_videoops_anc_table))
+		return;
+	lines = &ntv2_videoops_anc_table[standard];
+	if (lines->total_lines == 0)
+		return;
+
+	/* the video must leave room for both fields */
+	frame_bytes = ntv2_features_ntv2_frame_size(&stream->video.video_format,
+												&stream->video.pixel_format);
+	if ((frame_bytes + 2 * NTV2_ANC_FIELD_SIZE) > stream->video.frame_size) {
+		NTV2_MSG_CHANNEL_STATE("%s: anc extractor no room in frame\n", ntv2_chn->name);
+		return;
+	}
+
+	/* program the vanc line ranges */
+	val = NTV2_FLD_SET(ntv2_kona_fld_anc_ext_field1_cutoff_line, lines->field1_cutoff);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_anc_ext_field2_cutoff_line, lines->field2_cutoff);
+	ntv2_reg_write(vid_reg, ntv2_kona_reg_anc_ext_field_cutoff_line, index, val);
+
+	val = NTV2_FLD_SET(ntv2_kona_fld_anc_ext_field1_start_line, lines->field1_start);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_anc_ext_field2_start_line, lines->field2_start);
+	ntv2_reg_write(vid_reg, ntv2_kona_reg_anc_ext_field_vbl_start_line, index, val);
+
+	val = NTV2_FLD_SET(ntv2_kona_fld_anc_ext_total_frame_lines, lines->total_lines);
+	ntv2_reg_write(vid_reg, ntv2_kona_reg_anc_ext_total_frame_lines, index, val);
+
+	/* extract vanc only, hanc carries the audio */
+	sd = (standard == ntv2_kona_video_standard_525i) ||
+		(standard == ntv2_kona_video_standard_625i);
+	val = NTV2_FLD_SET(ntv2_kona_fld_anc_ext_vanc_y_enable, 1);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_anc_ext_vanc_c_enable, sd? 0 : 1);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_anc_ext_progressive, (lines->field2_start == 0)? 1 : 0);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_anc_ext_sd_mux_enable, sd? 1 : 0);
+	val |= NTV2_FLD_SET(ntv2_kona_fld_anc_ext_disable, 0);
+	mask = NTV2_FLD_MASK(ntv2_kona_fld_anc_ext_hanc_y_enable);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_anc_ext_hanc_c_enable);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_anc_ext_vanc_y_enable);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_anc_ext_vanc_c_enable);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_anc_ext_progressive);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_anc_ext_sd_mux_enable);
+	mask |= NTV2_FLD_MASK(ntv2_kona_fld_anc_ext_disable);
+
+	stream->video.anc_index = index;
+	if (stream->video.frame_next != NULL)
+		ntv2_videoops_anc_frame(stream, stream->video.frame_next);
+	ntv2_reg_rmw(vid_reg, ntv2_kona_reg_anc_ext_control, index, val, mask);
+
+	NTV2_MSG_CHANNEL_STATE("%s: anc extractor %d enable\n", ntv2_chn->name, index);
+}
+
+static void ntv2_videoops_anc_frame(struct ntv2_channel_stream *stream,
+									struct ntv2_stream_data *data)
+{
+	struct ntv2_register *vid_reg = stream->ntv2_chn->vid_reg;
+	int index = stream->video.anc_index;
+
+	if (index < 0)
+		return;
+
+	/* extract into the frame the frame store fills next */
+	ntv2_reg_write(vid_reg, ntv2_kona_reg_anc_ext_field1_start_address, index,
+				   data->video.anc_address[0]);
+	ntv2_reg_write(vid_reg, ntv2_kona_reg_anc_ext_field1_end_address, index,
+				   data->video.anc_address[0] + NTV2_ANC_FIELD_SIZE - 1);
+	ntv2_reg_write(vid_reg, ntv2_kona_reg_anc_ext_field2_start_address, index,
+				   data->video.anc_address[1]);
+	ntv2_reg_write(vid_reg, ntv2_kona_reg_anc_ext_field2_end_address, index,
+				   data->video.anc_address[1] + NTV2_ANC_FIELD_SIZE - 1);
+}
+
+static void ntv2_videoops_anc_status(struct ntv2_channel_stream *stream,
+									 struct ntv2_stream_data *data)
+{
+	struct ntv2_register *vid_reg = stream->ntv2_chn->vid_reg;
+	int index = stream->video.anc_index;
+	u32 val;
+
+	data->video.anc_size[0] = 0;
+	data->video.anc_size[1] = 0;
+	if (index < 0)
+		return;
+
+	/* bytes written by the extractor for each field */
+	val = ntv2_reg_read(vid_reg, ntv2_kona_reg_anc_ext_field1_status, index);
+	data->video.anc_size[0] = min_t(u32, NTV2_FLD_GET(ntv2_kona_fld_anc_ext_bytes_in, val),
+									NTV2_ANC_FIELD_SIZE);
+	val = ntv2_reg_read(vid_reg, ntv2_kona_reg_anc_ext_field2_status, index);
+	data->video.anc_size[1] = min_t(u32, NTV2_FLD_GET(ntv2_kona_fld_anc_ext_bytes_in, val),
+									NTV2_ANC_FIELD_SIZE);
+}
@@ -26,11 +26,17 @@ struct ntv2_channel_stream;
 
 int ntv2_videoops_setup_capture(struct ntv2_channel_stream *stream);
 int ntv2_videoops_release_capture(struct ntv2_channel_stream *stream);
+int ntv2_videoops_reconfigure_capture(struct ntv2_channel_stream *stream);
+int ntv2_videoops_setup_playback(struct ntv2_channel_stream *stream);
+int ntv2_videoops_release_playback(struct ntv2_channel_stream *stream);
 int ntv2_videoops_update_mode(struct ntv2_channel_stream *stream);
+int ntv2_videoops_update_mode_playback(struct ntv2_channel_stream *stream);
 int ntv2_videoops_update_format(struct ntv2_channel_stream *stream);
 int ntv2_videoops_update_timing(struct ntv2_channel_stream *stream);
 int ntv2_videoops_update_route(struct ntv2_channel_stream *stream);
+int ntv2_videoops_update_route_playback(struct ntv2_channel_stream *stream);
 int ntv2_videoops_update_frame(struct ntv2_channel_stream *stream);
 int ntv2_videoops_interrupt_capture(struct ntv2_channel_stream *stream);
+int ntv2_videoops_interrupt_playback(struct ntv2_channel_stream *stream);
 
 #endif
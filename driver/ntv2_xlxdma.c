@@ -53,7 +53,8 @@ struct ntv2_xlxdma *ntv2_xlxdma_open(struct ntv2_object *ntv2_obj,
 	if (ntv2_obj == NULL) 
 		return NULL;
 
-	ntv2_xlx = kzalloc(sizeof(struct ntv2_xlxdma), GFP_KERNEL);
+	ntv2_xlx = kzalloc_node(sizeof(struct ntv2_xlxdma), GFP_KERNEL,
+							ntv2_obj->ntv2_dev->numa_node);
 	if (ntv2_xlx == NULL) {
 		NTV2_MSG_ERROR("%s: ntv2_xlxdma instance memory allocation failed\n", ntv2_obj->name);
 		return NULL;
@@ -308,6 +309,26 @@ int ntv2_xlxdma_disable(struct ntv2_xlxdma *ntv2_xlx)
 	return 0;
 }
 
+static void ntv2_xlxdma_queue_task(struct ntv2_xlxdma *ntv2_xlx,
+								   struct ntv2_xlxdma_task *task)
+{
+	struct ntv2_xlxdma_task *next;
+
+	/* priority tasks go ahead of waiting normal tasks but never
+	   ahead of the list head which the engine task may own */
+	if (task->priority && !list_empty(&ntv2_xlx->dmatask_ready_list)) {
+		next = list_first_entry(&ntv2_xlx->dmatask_ready_list, struct ntv2_xlxdma_task, list);
+		list_for_each_entry_continue(next, &ntv2_xlx->dmatask_ready_list, list) {
+			if (!next->priority && !next->dma_start) {
+				list_add_tail(&task->list, &next->list);
+				return;
+			}
+		}
+	}
+
+	list_add_tail(&task->list, &ntv2_xlx->dmatask_ready_list);
+}
+
 int ntv2_xlxdma_transfer(struct ntv2_xlxdma *ntv2_xlx,
 						 struct ntv2_transfer *ntv2_trn)
 {
@@ -335,8 +356,12 @@ int ntv2_xlxdma_transfer(struct ntv2_xlxdma *ntv2_xlx,
 		task->card_address[1] = ntv2_trn->card_address[1];
 		task->card_size[0] = ntv2_trn->card_size[0];
 		task->card_size[1] = ntv2_trn->card_size[1];
+		task->card_pitch = ntv2_trn->card_pitch;
+		task->card_segment = ntv2_trn->card_segment;
+		task->system_pitch = ntv2_trn->system_pitch;
 		task->callback_func = ntv2_trn->callback_func;
 		task->callback_data = ntv2_trn->callback_data;
+		task->priority = ntv2_trn->priority;
 		task->dma_start = false;
 		task->dma_done = false;
 		task->dma_result = 0;
@@ -344,7 +369,7 @@ int ntv2_xlxdma_transfer(struct ntv2_xlxdma *ntv2_xlx,
 		task_index = task->index;
 	
 		list_del_init(&task->list);
-		list_add_tail(&task->list, &ntv2_xlx->dmatask_ready_list);
+		ntv2_xlxdma_queue_task(ntv2_xlx, task);
 	}
 	spin_unlock_irqrestore(&ntv2_xlx->state_lock, flags);
 
@@ -455,6 +480,9 @@ static int ntv2_xlxdma_dodma(struct ntv2_xlxdma_task *ntv2_task)
 	u32		total_size;
 	u32		data_size;
 	u32		byte_count;
+	u32		count;
+	u32		segment_size;
+	u32		system_skip;
 	u32		value;
 	int		result;
 	int		index;
@@ -562,6 +590,8 @@ static int ntv2_xlxdma_dodma(struct ntv2_xlxdma_task *ntv2_task)
 	desc_next = ntv2_xlx->dma_descriptor + sizeof(struct ntv2_xlxdma_descriptor);
 	desc_count = 0;
 	data_size = 0;
+	segment_size = 0;
+	system_skip = 0;
 	total_size = ntv2_task->card_size[0] + ntv2_task->card_size[1];
 	ntv2_xlx->descriptor_count = 0;
 	ntv2_xlx->descriptor_bytes = 0;
@@ -572,49 +602,27 @@ static int ntv2_xlxdma_dodma(struct ntv2_xlxdma_task *ntv2_task)
 		system_address = sg_dma_address(sgentry);
 		byte_count = sg_dma_len(sgentry);
 
-		/* limit transfer to total size */
-		if ((data_size + byte_count) > total_size)
-			byte_count = total_size - data_size;
-
-		/* handle split transfer */
-		if ((ntv2_task->card_size[1] != 0) &&
-			(data_size < ntv2_task->card_size[0]) &&
-			((data_size + byte_count) >= ntv2_task->card_size[0])) {
-			/* xlx can fetch up to 16 descriptors at once if they do not span pages */
-			contig = (PAGE_SIZE - (((u32)desc_next) & 0xfff)) / sizeof(struct ntv2_xlxdma_descriptor);
-			if (contig > 0)
-				contig--;
-			if (contig > NTV2_XLXDMA_MAX_ADJACENT_COUNT)
-				contig = NTV2_XLXDMA_MAX_ADJACENT_COUNT;
-			/* write descriptor for first fragment */
-			desc->control = control;
-			desc->control |= NTV2_FLD_SET(ntv2_xlxdma_fld_desc_control_count, contig);
-			desc->byte_count = ntv2_task->card_size[0] - data_size;
-			if (ntv2_xlx->mode == ntv2_transfer_mode_s2c) {
-				desc->src_address = system_address;
-				desc->dst_address = card_address;
-			} else {
-				desc->src_address = card_address;
-				desc->dst_address = system_address;
+		while ((byte_count != 0) && (data_size < total_size)) {
+			/* step over the system line padding */
+			if (system_skip != 0) {
+				count = (byte_count < system_skip)? byte_count : system_skip;
+				system_address += count;
+				byte_count -= count;
+				system_skip -= count;
+				continue;
 			}
-			desc->nxt_address = desc_next;
-			/* setup for next fragment */
-			system_address += desc->byte_count;
-			card_address = ntv2_task->card_address[1];
-			byte_count -= desc->byte_count;
-			data_size += desc->byte_count;
-			/* setup for next descriptor */
-			desc_last = desc;
-			desc++;
-			desc_next += sizeof(struct ntv2_xlxdma_descriptor);
-			if (desc_count > NTV2_XLXDMA_MAX_ADJACENT_COUNT)
-				desc_opt++;
-			desc_count++;
-			if (desc_count >= ntv2_xlx->max_descriptors)
-				break;
-		}
-
-		if (byte_count != 0) {
+			/* limit the descriptor to the total size and the card line segment */
+			count = byte_count;
+			if (count > (total_size - data_size))
+				count = total_size - data_size;
+			if ((ntv2_task->card_segment != 0) &&
+				(count > (ntv2_task->card_segment - segment_size)))
+				count = ntv2_task->card_segment - segment_size;
+			/* and to the end of the first card region of a split transfer */
+			if ((ntv2_task->card_size[1] != 0) &&
+				(data_size < ntv2_task->card_size[0]) &&
+				(count > (ntv2_task->card_size[0] - data_size)))
+				count = ntv2_task->card_size[0] - data_size;
 			/* xlx can fetch up to 16 descriptors at once if they do not span pages */
 			contig = (PAGE_SIZE - (((u32)desc_next) & 0xfff)) / sizeof(struct ntv2_xlxdma_descriptor);
 			if (contig > 0)
@@ -624,7 +632,7 @@ static int ntv2_xlxdma_dodma(struct ntv2_xlxdma_task *ntv2_task)
 			/* write the descriptor */
 			desc->control = control;
 			desc->control |= NTV2_FLD_SET(ntv2_xlxdma_fld_desc_control_count, contig);
-			desc->byte_count = byte_count;
+			desc->byte_count = count;
 			if (ntv2_xlx->mode == ntv2_transfer_mode_s2c) {
 				desc->src_address = system_address;
 				desc->dst_address = card_address;
@@ -647,8 +655,26 @@ static int ntv2_xlxdma_dodma(struct ntv2_xlxdma_task *ntv2_task)
 										NTV2_U64_LOW(desc->nxt_address));
 			}
 			/* update card address and size */
-			card_address += byte_count;
-			data_size += byte_count;
+			system_address += count;
+			byte_count -= count;
+			card_address += count;
+			data_size += count;
+			/* skip to the next card and system line */
+			if (ntv2_task->card_segment != 0) {
+				segment_size += count;
+				if (segment_size >= ntv2_task->card_segment) {
+					card_address += ntv2_task->card_pitch - ntv2_task->card_segment;
+					if (ntv2_task->system_pitch > ntv2_task->card_segment)
+						system_skip = ntv2_task->system_pitch - ntv2_task->card_segment;
+					segment_size = 0;
+				}
+			}
+			/* start the second card region on a new line */
+			if ((ntv2_task->card_size[1] != 0) &&
+				(data_size == ntv2_task->card_size[0])) {
+				card_address = ntv2_task->card_address[1];
+				segment_size = 0;
+			}
 			/* setup for next descriptor */
 			desc_last = desc;
 			desc++;
@@ -660,6 +686,9 @@ static int ntv2_xlxdma_dodma(struct ntv2_xlxdma_task *ntv2_task)
 				break;
 		}
 
+		if (desc_count >= ntv2_xlx->max_descriptors)
+			break;
+
 		sgentry = sg_next(sgentry);
 	}
 
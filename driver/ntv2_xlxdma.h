@@ -55,9 +55,13 @@ struct ntv2_xlxdma_task {
 	u32						sg_offset;
 	u32						card_address[2];
 	u32						card_size[2];
+	u32						card_pitch;
+	u32						card_segment;
+	u32						system_pitch;
 
 	ntv2_transfer_callback	callback_func;
 	unsigned long			callback_data;
+	bool					priority;
 
 	bool	dma_start;
 	bool	dma_done;